@@ -0,0 +1,714 @@
+/*
+ * File: arena_tree.hpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#ifndef ARENA_TREE_HPP_
+#define ARENA_TREE_HPP_
+
+#include "iterator_traits.hpp"
+#include "reverse_iterator.hpp"
+#include "function.hpp"
+#include "pair.hpp"
+#include "algorithm.hpp"
+#include "type_traits.hpp"
+#include "tree.hpp"
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace ft {
+
+typedef unsigned int _rb_arena_index;
+
+/**
+ * @brief arena slot constants
+ *
+ * slot 0 은 null 로 쓰기 위해 비워두고 slot 1 이 header 이다 (parent = root, left = leftmost, right = rightmost).
+ * 링크가 포인터가 아니라 slot 번호이므로 arena 전체를 memcpy 해도 트리가 그대로 유지된다.
+ */
+static const _rb_arena_index _s_arena_nil = 0;
+static const _rb_arena_index _s_arena_header = 1;
+static const _rb_arena_index _s_arena_first_slot = 2;
+static const _rb_arena_index _s_arena_index_mask = 0x7fffffffu;
+
+/**
+ * @brief links of an arena node, color lives in the high bit of the parent index
+ */
+struct _rb_arena_link {
+  _rb_arena_index _m_parent_color;
+  _rb_arena_index _m_left;
+  _rb_arena_index _m_right;
+
+  _rb_arena_index _m_get_parent() const { return _m_parent_color & _s_arena_index_mask; }
+  void _m_set_parent(_rb_arena_index p) { _m_parent_color = (_m_parent_color & ~_s_arena_index_mask) | p; }
+  bool _m_get_color() const { return (_m_parent_color >> 31) != 0; }
+  void _m_set_color(bool c) {
+    _m_parent_color = (_m_parent_color & _s_arena_index_mask) | (static_cast<_rb_arena_index>(c) << 31);
+  }
+};
+
+template<class Val>
+struct _rb_arena_node : public _rb_arena_link {
+  Val _m_value_field;
+};
+
+/**
+ * @brief view of the slot array used by the non-template routines in tree.cpp
+ */
+struct _rb_arena {
+  char *_m_base;
+  size_t _m_stride;
+
+  _rb_arena() : _m_base(0), _m_stride(0) {}
+
+  _rb_arena_link &_m_link(_rb_arena_index i) const {
+    return *reinterpret_cast<_rb_arena_link *>(_m_base + i * _m_stride);
+  }
+};
+
+_rb_arena_index _rb_arena_increment(const _rb_arena &a, _rb_arena_index x) throw();
+_rb_arena_index _rb_arena_decrement(const _rb_arena &a, _rb_arena_index x) throw();
+void _rb_arena_rebalance(const _rb_arena &a, _rb_arena_index x) throw();
+_rb_arena_index _rb_arena_rebalance_for_erase(const _rb_arena &a, _rb_arena_index z) throw();
+
+template<typename T>
+struct _rb_arena_iterator {
+  typedef _rb_arena_iterator<T> iterator;
+  typedef ptrdiff_t difference_type;
+  typedef T &reference;
+  typedef T *pointer;
+  typedef T value_type;
+  typedef std::bidirectional_iterator_tag iterator_category;
+
+  typedef _rb_arena_iterator<T> _self;
+
+  const _rb_arena *_m_arena;
+  _rb_arena_index _m_node;
+
+  _rb_arena_iterator() : _m_arena(), _m_node() {}
+  _rb_arena_iterator(const _rb_arena *arena, _rb_arena_index x) : _m_arena(arena), _m_node(x) {}
+  _rb_arena_iterator(const _self &src) : _m_arena(src._m_arena), _m_node(src._m_node) {}
+
+  iterator _m_const_cast() const { return *this; }
+
+  _self &operator=(const _self &src) {
+    _m_arena = src._m_arena;
+    _m_node = src._m_node;
+    return *this;
+  }
+
+  pointer operator->() const { return &**this; } // node->var
+  reference operator*() const {
+    return static_cast<_rb_arena_node<T> &>(_m_arena->_m_link(_m_node))._m_value_field;
+  } // *node
+  _self &operator++() {
+    _m_node = _rb_arena_increment(*_m_arena, _m_node);
+    return *this;
+  } // ++node
+  _self operator++(int) {
+    _self _tmp = *this;
+    _m_node = _rb_arena_increment(*_m_arena, _m_node);
+    return _tmp;
+  } // node++
+  _self &operator--() {
+    _m_node = _rb_arena_decrement(*_m_arena, _m_node);
+    return *this;
+  } // --node
+  _self operator--(int) {
+    _self _tmp = *this;
+    _m_node = _rb_arena_decrement(*_m_arena, _m_node);
+    return _tmp;
+  } // node--
+
+  friend bool operator==(const _self &x, const _self &y) { return x._m_node == y._m_node; }
+  friend bool operator!=(const _self &x, const _self &y) { return x._m_node != y._m_node; }
+};
+
+template<typename T>
+struct _rb_arena_const_iterator {
+  typedef _rb_arena_iterator<T> iterator;
+  typedef ptrdiff_t difference_type;
+  typedef const T &reference;
+  typedef const T *pointer;
+  typedef T value_type;
+  typedef std::bidirectional_iterator_tag iterator_category;
+
+  typedef _rb_arena_const_iterator<T> _self;
+
+  const _rb_arena *_m_arena;
+  _rb_arena_index _m_node;
+
+  _rb_arena_const_iterator() : _m_arena(), _m_node() {}
+  _rb_arena_const_iterator(const _rb_arena *arena, _rb_arena_index x) : _m_arena(arena), _m_node(x) {}
+  _rb_arena_const_iterator(const iterator &it) : _m_arena(it._m_arena), _m_node(it._m_node) {}
+  _rb_arena_const_iterator(const _self &src) : _m_arena(src._m_arena), _m_node(src._m_node) {}
+
+  // const iterator to non-const iterator
+  iterator _m_const_cast() const { return iterator(_m_arena, _m_node); }
+
+  _self &operator=(const _self &src) {
+    _m_arena = src._m_arena;
+    _m_node = src._m_node;
+    return *this;
+  }
+
+  pointer operator->() const { return &**this; } // node->var
+  reference operator*() const {
+    return static_cast<const _rb_arena_node<T> &>(_m_arena->_m_link(_m_node))._m_value_field;
+  } // *node
+  _self &operator++() {
+    _m_node = _rb_arena_increment(*_m_arena, _m_node);
+    return *this;
+  } // ++node
+  _self operator++(int) {
+    _self _tmp = *this;
+    _m_node = _rb_arena_increment(*_m_arena, _m_node);
+    return _tmp;
+  } // node++
+  _self &operator--() {
+    _m_node = _rb_arena_decrement(*_m_arena, _m_node);
+    return *this;
+  } // --node
+  _self operator--(int) {
+    _self _tmp = *this;
+    _m_node = _rb_arena_decrement(*_m_arena, _m_node);
+    return _tmp;
+  } // node--
+
+  friend bool operator==(const _self &x, const _self &y) { return x._m_node == y._m_node; }
+  friend bool operator!=(const _self &x, const _self &y) { return x._m_node != y._m_node; }
+};
+
+/**
+ * @brief red-black tree whose nodes live in one growable array and link to each other with 32 bit slot numbers
+ * @tparam Key key
+ * @tparam Val pair<key, value>
+ * @tparam KeyOfValue template class that select key of value (functor)
+ * @tparam Compare key_compare type (functor class)
+ * @tparam Alloc allocator type
+ *
+ * 링크 3개가 12 byte 라서 ft::map<int, int> 의 노드는 40 byte 에서 20 byte 가 된다.
+ * arena 가 커질 때 값들이 새 배열로 옮겨지므로 insert 는 참조 / 포인터를 무효화한다.
+ * iterator 는 slot 번호를 들고 있어서 insert 이후에도 유효하지만 swap 이후에는 무효화된다.
+ * 값이 trivially copyable 이면 복사는 arena 전체를 memcpy 한 번으로 끝난다.
+ */
+template<class Key, class Val, class KeyOfValue = ft::Select1st<Val>,
+    class Compare = ft::less<Key>, class Alloc = std::allocator<Val> >
+class _rb_arena_tree {
+ protected:
+  typedef _rb_arena_node<Val> _node;
+  typedef typename Alloc::template rebind<_node>::other _node_allocator;
+  typedef integral_constant<bool, is_trivially_relocatable<Val>::value> _trivial_value;
+
+  enum { _s_min_capacity = 16 };
+
+ public:
+  // member types
+  typedef Key key_type;
+  typedef Val value_type;
+  typedef value_type *pointer;
+  typedef const value_type *const_pointer;
+  typedef value_type &reference;
+  typedef const value_type &const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef Alloc allocator_type;
+
+  typedef _rb_arena_iterator<value_type> iterator;
+  typedef _rb_arena_const_iterator<value_type> const_iterator;
+  typedef ft::reverse_iterator<iterator> reverse_iterator;
+  typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+ protected:
+  // member variables
+  _node_allocator _m_alloc;
+  Compare _m_key_compare;
+  _rb_arena _m_arena;
+  size_type _m_capacity;   // number of slots of the array
+  size_type _m_used;       // slots ever handed out (high water mark)
+  _rb_arena_index _m_free; // free slot list, linked through _m_left
+  size_type _m_node_count; // keeps track of size of tree
+
+  /* ****************************************************** */
+  /*                       Memory                           */
+  /* ****************************************************** */
+
+  _node *_m_nodes() const { return reinterpret_cast<_node *>(_m_arena._m_base); }
+  _rb_arena_link &_m_link(_rb_arena_index x) const { return _m_nodes()[x]; }
+  value_type &_m_value(_rb_arena_index x) const { return _m_nodes()[x]._m_value_field; }
+  const key_type &_m_key(_rb_arena_index x) const { return KeyOfValue()(_m_value(x)); }
+
+  _rb_arena_index _m_root() const { return _m_capacity ? _m_link(_s_arena_header)._m_get_parent() : 0; }
+  _rb_arena_index _m_leftmost() const { return _m_capacity ? _m_link(_s_arena_header)._m_left : 0; }
+  _rb_arena_index _m_rightmost() const { return _m_capacity ? _m_link(_s_arena_header)._m_right : 0; }
+
+  void _m_reset_header() {
+    _rb_arena_link &_h = _m_link(_s_arena_header);
+    _h._m_parent_color = 0; // red, no root
+    _h._m_left = _s_arena_header;
+    _h._m_right = _s_arena_header;
+    _rb_arena_link &_nil = _m_link(_s_arena_nil);
+    _nil._m_parent_color = 0;
+    _nil._m_left = 0;
+    _nil._m_right = 0;
+    _m_used = _s_arena_first_slot;
+    _m_free = 0;
+  }
+
+  /**
+   * @brief move every live value (and all links) into a new array of n slots
+   *
+   * 실패하면 새 배열만 정리하고 기존 arena 는 그대로 둔다.
+   */
+  void _m_reallocate(size_type n) {
+    _node *_new = _m_alloc.allocate(n);
+    _node *_old = _m_nodes();
+    if (_old == 0) {
+      _m_arena._m_base = reinterpret_cast<char *>(_new);
+      _m_arena._m_stride = sizeof(_node);
+      _m_capacity = n;
+      _m_reset_header();
+      return;
+    }
+    try {
+      _m_transfer(_new, _old, true, _trivial_value());
+    } catch (...) {
+      _m_alloc.deallocate(_new, n);
+      throw;
+    }
+    _m_alloc.deallocate(_old, _m_capacity);
+    _m_arena._m_base = reinterpret_cast<char *>(_new);
+    _m_capacity = n;
+  }
+
+  // copy the first _m_used slots of src into dst, destroying the values of src if move
+  void _m_transfer(_node *dst, const _node *src, bool, true_type) const {
+    std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), _m_used * sizeof(_node));
+  }
+
+  void _m_transfer(_node *dst, const _node *src, bool move, false_type) const {
+    for (size_type i = 0; i < _m_used; ++i)
+      static_cast<_rb_arena_link &>(dst[i]) = src[i];
+    _rb_arena_index _x = _m_leftmost();
+    try {
+      for (; _x != _s_arena_header; _x = _rb_arena_increment(_m_arena, _x))
+        ::new(static_cast<void *>(&dst[_x]._m_value_field)) value_type(src[_x]._m_value_field);
+    } catch (...) {
+      for (_rb_arena_index _y = _m_leftmost(); _y != _x; _y = _rb_arena_increment(_m_arena, _y))
+        dst[_y]._m_value_field.~value_type();
+      throw;
+    }
+    if (move)
+      for (_x = _m_leftmost(); _x != _s_arena_header; _x = _rb_arena_increment(_m_arena, _x))
+        _m_value(_x).~value_type();
+  }
+
+  _rb_arena_index _m_get_slot() {
+    if (_m_free != 0) {
+      _rb_arena_index _x = _m_free;
+      _m_free = _m_link(_x)._m_left;
+      return _x;
+    }
+    if (_m_used == _m_capacity) {
+      if (_m_capacity > _s_arena_index_mask / 2)
+        throw std::length_error("ft::_rb_arena_tree : more than 2^31 nodes");
+      _m_reallocate(_m_capacity ? _m_capacity * 2 : size_type(_s_min_capacity));
+    }
+    return static_cast<_rb_arena_index>(_m_used++);
+  }
+
+  void _m_put_slot(_rb_arena_index x) {
+    _m_link(x)._m_left = _m_free;
+    _m_free = x;
+  }
+
+  void _m_deallocate_arena() {
+    if (_m_capacity)
+      _m_alloc.deallocate(_m_nodes(), _m_capacity);
+    _m_arena._m_base = 0;
+    _m_capacity = 0;
+    _m_used = 0;
+    _m_free = 0;
+  }
+
+  void _m_destroy_values() {
+    for (_rb_arena_index _x = _m_leftmost(); _x != _s_arena_header; _x = _rb_arena_increment(_m_arena, _x))
+      _m_value(_x).~value_type();
+  }
+
+  void _m_copy_from(const _rb_arena_tree &x) {
+    if (x._m_node_count == 0)
+      return;
+    _node *_new = _m_alloc.allocate(x._m_capacity);
+    try {
+      x._m_transfer(_new, x._m_nodes(), false, _trivial_value());
+    } catch (...) {
+      _m_alloc.deallocate(_new, x._m_capacity);
+      throw;
+    }
+    _m_arena._m_base = reinterpret_cast<char *>(_new);
+    _m_arena._m_stride = sizeof(_node);
+    _m_capacity = x._m_capacity;
+    _m_used = x._m_used;
+    _m_free = x._m_free;
+    _m_node_count = x._m_node_count;
+  }
+
+  /**
+   * @brief link a new node holding val under parent y (left if insert_left)
+   */
+  iterator _m_insert(_rb_arena_index y, bool insert_left, const value_type &val) {
+    _rb_arena_index _z = _m_get_slot();
+    try {
+      ::new(static_cast<void *>(&_m_value(_z))) value_type(val);
+    } catch (...) {
+      _m_put_slot(_z);
+      throw;
+    }
+    _rb_arena_link &_zl = _m_link(_z);
+    _rb_arena_link &_h = _m_link(_s_arena_header);
+    _zl._m_parent_color = y;
+    _zl._m_left = 0;
+    _zl._m_right = 0;
+    if (y == _s_arena_header) {
+      _h._m_set_parent(_z);
+      _h._m_left = _z;
+      _h._m_right = _z;
+    } else if (insert_left) {
+      _m_link(y)._m_left = _z;
+      if (y == _h._m_left)
+        _h._m_left = _z;
+    } else {
+      _m_link(y)._m_right = _z;
+      if (y == _h._m_right)
+        _h._m_right = _z;
+    }
+    _rb_arena_rebalance(_m_arena, _z);
+    ++_m_node_count;
+    return iterator(&_m_arena, _z);
+  }
+
+  _rb_arena_index _m_lower_bound(const key_type &k) const {
+    _rb_arena_index _y = _s_arena_header;
+    _rb_arena_index _x = _m_root();
+    while (_x != 0) {
+      if (!_m_key_compare(_m_key(_x), k)) {
+        _y = _x;
+        _x = _m_link(_x)._m_left;
+      } else {
+        _x = _m_link(_x)._m_right;
+      }
+    }
+    return _y;
+  }
+
+  _rb_arena_index _m_upper_bound(const key_type &k) const {
+    _rb_arena_index _y = _s_arena_header;
+    _rb_arena_index _x = _m_root();
+    while (_x != 0) {
+      if (_m_key_compare(k, _m_key(_x))) {
+        _y = _x;
+        _x = _m_link(_x)._m_left;
+      } else {
+        _x = _m_link(_x)._m_right;
+      }
+    }
+    return _y;
+  }
+
+ public:
+  _rb_arena_tree() : _m_alloc(), _m_key_compare(), _m_arena(), _m_capacity(0), _m_used(0), _m_free(0),
+                     _m_node_count(0) {}
+
+  _rb_arena_tree(const Compare &comp, const allocator_type &alloc = allocator_type())
+      : _m_alloc(alloc), _m_key_compare(comp), _m_arena(), _m_capacity(0), _m_used(0), _m_free(0),
+        _m_node_count(0) {}
+
+  _rb_arena_tree(const _rb_arena_tree &x)
+      : _m_alloc(x._m_alloc), _m_key_compare(x._m_key_compare), _m_arena(), _m_capacity(0), _m_used(0),
+        _m_free(0), _m_node_count(0) {
+    _m_copy_from(x);
+  }
+
+  ~_rb_arena_tree() {
+    clear();
+    _m_deallocate_arena();
+  }
+
+  _rb_arena_tree &operator=(const _rb_arena_tree &x) {
+    if (this != &x) {
+      clear();
+      _m_deallocate_arena();
+      _m_key_compare = x._m_key_compare;
+      _m_copy_from(x);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return allocator_type(_m_alloc); }
+
+  Compare key_comp() const { return _m_key_compare; }
+
+  iterator begin() { return iterator(&_m_arena, _m_capacity ? _m_leftmost() : _s_arena_header); }
+  const_iterator begin() const { return const_iterator(&_m_arena, _m_capacity ? _m_leftmost() : _s_arena_header); }
+
+  iterator end() { return iterator(&_m_arena, _s_arena_header); }
+  const_iterator end() const { return const_iterator(&_m_arena, _s_arena_header); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  size_type size() const { return _m_node_count; }
+
+  size_type max_size() const { return _s_arena_index_mask - _s_arena_first_slot; }
+
+  bool empty() const { return _m_node_count == 0; }
+
+  /**
+   * @brief make room for n elements so that no insertion reallocates the arena until size() > n
+   */
+  void reserve(size_type n) {
+    if (n > max_size())
+      throw std::length_error("ft::_rb_arena_tree::reserve");
+    if (n + _s_arena_first_slot > _m_capacity)
+      _m_reallocate(n + _s_arena_first_slot);
+  }
+
+  /**
+   * @brief number of slots allocated for nodes (including the two reserved ones)
+   */
+  size_type capacity() const { return _m_capacity; }
+
+  void swap(_rb_arena_tree &t) {
+    ft::swap(_m_arena._m_base, t._m_arena._m_base);
+    ft::swap(_m_arena._m_stride, t._m_arena._m_stride);
+    ft::swap(_m_capacity, t._m_capacity);
+    ft::swap(_m_used, t._m_used);
+    ft::swap(_m_free, t._m_free);
+    ft::swap(_m_node_count, t._m_node_count);
+    ft::swap(_m_key_compare, t._m_key_compare);
+    ft::swap(_m_alloc, t._m_alloc);
+  }
+
+  iterator find(const key_type &k) {
+    _rb_arena_index _j = _m_lower_bound(k);
+    return (_j == _s_arena_header || _m_key_compare(k, _m_key(_j))) ? end() : iterator(&_m_arena, _j);
+  }
+
+  const_iterator find(const key_type &k) const {
+    _rb_arena_index _j = _m_lower_bound(k);
+    return (_j == _s_arena_header || _m_key_compare(k, _m_key(_j))) ? end() : const_iterator(&_m_arena, _j);
+  }
+
+  size_type count(const key_type &k) const { return find(k) == end() ? 0 : 1; }
+
+  iterator lower_bound(const key_type &k) { return iterator(&_m_arena, _m_lower_bound(k)); }
+  const_iterator lower_bound(const key_type &k) const { return const_iterator(&_m_arena, _m_lower_bound(k)); }
+
+  iterator upper_bound(const key_type &k) { return iterator(&_m_arena, _m_upper_bound(k)); }
+  const_iterator upper_bound(const key_type &k) const { return const_iterator(&_m_arena, _m_upper_bound(k)); }
+
+  pair<iterator, iterator> equal_range(const key_type &k) {
+    return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+  }
+
+  pair<const_iterator, const_iterator> equal_range(const key_type &k) const {
+    return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+  }
+
+  template<class ForwardIterator, class OutputIterator>
+  OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+    for (; first != last; ++first, ++out)
+      *out = find(*first);
+    return out;
+  }
+
+  template<class ForwardIterator, class OutputIterator>
+  OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+    for (; first != last; ++first, ++out)
+      *out = find(*first);
+    return out;
+  }
+
+  /**
+   * @brief for map.insert(const value_type)
+   * @return if the key unique, return <iterator: new element, true> else return <iterator: same key element, false>
+   */
+  pair<iterator, bool> insert_unique(const value_type &val) {
+    if (_m_capacity == 0)
+      _m_reallocate(_s_min_capacity);
+    const key_type &_k = KeyOfValue()(val);
+    _rb_arena_index _y = _s_arena_header;
+    _rb_arena_index _x = _m_root();
+    bool _comp = true;
+    while (_x != 0) {
+      _y = _x;
+      _comp = _m_key_compare(_k, _m_key(_x));
+      _x = _comp ? _m_link(_x)._m_left : _m_link(_x)._m_right;
+    }
+    _rb_arena_index _j = _y;
+    if (_comp) {
+      if (_j == _m_leftmost())
+        return ft::make_pair(_m_insert(_y, true, val), true);
+      _j = _rb_arena_decrement(_m_arena, _j);
+    }
+    if (_m_key_compare(_m_key(_j), _k))
+      return ft::make_pair(_m_insert(_y, _comp, val), true);
+    return ft::make_pair(iterator(&_m_arena, _j), false);
+  }
+
+  /**
+   * @brief hint for the position where element can be inserted (only end() is used)
+   */
+  iterator insert_unique(const_iterator position, const value_type &val) {
+    if (position._m_node == _s_arena_header && _m_node_count != 0
+        && _m_key_compare(_m_key(_m_rightmost()), KeyOfValue()(val)))
+      return _m_insert(_m_rightmost(), false, val);
+    return insert_unique(val).first;
+  }
+
+  /**
+   * @brief insert value_type(k, obj) if k is not there yet, nothing is constructed when it is
+   *
+   * 값을 만들기 전에 먼저 찾고, 없을 때만 찾은 위치를 hint 로 insert 한다.
+   */
+  template<class Mapped>
+  pair<iterator, bool> try_emplace_unique(const key_type &k, const Mapped &obj) {
+    iterator _j = lower_bound(k);
+    if (_j != end() && !_m_key_compare(k, KeyOfValue()(*_j)))
+      return ft::make_pair(_j, false);
+    return ft::make_pair(insert_unique(_j, value_type(k, obj)), true);
+  }
+
+  pair<iterator, bool> try_emplace_unique(const key_type &k) {
+    iterator _j = lower_bound(k);
+    if (_j != end() && !_m_key_compare(k, KeyOfValue()(*_j)))
+      return ft::make_pair(_j, false);
+    return ft::make_pair(insert_unique(_j, value_type(k, typename value_type::second_type())), true);
+  }
+
+  template<class InputIterator>
+  void insert_unique(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      insert_unique(end(), *first);
+  }
+
+  template<class InputIterator>
+  void insert_sorted_unique(InputIterator first, InputIterator last) {
+    insert_unique(first, last);
+  }
+
+  void erase(iterator position) {
+    _rb_arena_index _y = _rb_arena_rebalance_for_erase(_m_arena, position._m_node);
+    _m_value(_y).~value_type();
+    _m_put_slot(_y);
+    --_m_node_count;
+  }
+
+  /**
+   * @brief remove key of the element from map
+   * @return number of element erased
+   */
+  size_type erase(const key_type &k) {
+    iterator _it = find(k);
+    if (_it == end())
+      return 0;
+    erase(_it);
+    return 1;
+  }
+
+  void erase(iterator first, iterator last) {
+    if (first == begin() && last == end()) {
+      clear();
+    } else {
+      while (first != last)
+        erase(first++);
+    }
+  }
+
+  /**
+   * @brief destroy every element, the arena keeps its capacity
+   */
+  void clear() {
+    if (_m_capacity == 0)
+      return;
+    if (!_trivial_value::value)
+      _m_destroy_values();
+    _m_reset_header();
+    _m_node_count = 0;
+  }
+
+  /**
+   * @brief check rb properties, links, order, leftmost / rightmost, count and free list (for tests, O(n))
+   */
+  bool _m_verify() const {
+    if (_m_node_count == 0)
+      return _m_root() == 0 && begin() == end();
+    _rb_arena_index _root = _m_root();
+    if (_m_link(_root)._m_get_color() != _s_black || _m_link(_root)._m_get_parent() != _s_arena_header)
+      return false;
+    size_type _n = 0;
+    size_type _black = 0;
+    for (_rb_arena_index _x = _m_leftmost(); _x != _s_arena_header; _x = _rb_arena_increment(_m_arena, _x)) {
+      const _rb_arena_link &_l = _m_link(_x);
+      if (_l._m_get_color() == _s_red
+          && ((_l._m_left && _m_link(_l._m_left)._m_get_color() == _s_red)
+              || (_l._m_right && _m_link(_l._m_right)._m_get_color() == _s_red)))
+        return false;
+      if ((_l._m_left && (_m_link(_l._m_left)._m_get_parent() != _x || _m_key_compare(_m_key(_x), _m_key(_l._m_left))))
+          || (_l._m_right
+              && (_m_link(_l._m_right)._m_get_parent() != _x || _m_key_compare(_m_key(_l._m_right), _m_key(_x)))))
+        return false;
+      if (_l._m_left == 0 || _l._m_right == 0) {  // every null link ends a path
+        size_type _b = 0;
+        for (_rb_arena_index _y = _x; _y != _s_arena_header; _y = _m_link(_y)._m_get_parent())
+          _b += _m_link(_y)._m_get_color() == _s_black;
+        if (_black == 0)
+          _black = _b;
+        else if (_b != _black)
+          return false;
+      }
+      ++_n;
+    }
+    size_type _free = 0;
+    for (_rb_arena_index _x = _m_free; _x != 0; _x = _m_link(_x)._m_left)
+      ++_free;
+    _rb_arena_index _min = _root;
+    while (_m_link(_min)._m_left) _min = _m_link(_min)._m_left;
+    _rb_arena_index _max = _root;
+    while (_m_link(_max)._m_right) _max = _m_link(_max)._m_right;
+    return _n == _m_node_count && _min == _m_leftmost() && _max == _m_rightmost()
+        && _n + _free + _s_arena_first_slot == _m_used;
+  }
+
+  friend bool operator==(const _rb_arena_tree &lhs, const _rb_arena_tree &rhs) {
+    return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+
+  friend bool operator<(const _rb_arena_tree &lhs, const _rb_arena_tree &rhs) {
+    return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+};
+
+/**
+ * @brief Tag that selects the arena engine (ft::map<K, T, C, A, ft::rb_tree_arena_tag>)
+ *
+ * insert invalidates references, swap invalidates iterators.
+ */
+struct rb_tree_arena_tag {};
+
+template<class Key, class Val, class KeyOfValue, class Compare, class Alloc>
+struct _tree_rep<rb_tree_arena_tag, Key, Val, KeyOfValue, Compare, Alloc> {
+  typedef _rb_arena_tree<Key, Val, KeyOfValue, Compare, Alloc> type;
+};
+
+} // namespace ft
+
+#endif //ARENA_TREE_HPP_
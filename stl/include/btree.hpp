@@ -0,0 +1,1092 @@
+/*
+ * File: btree.hpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#ifndef BTREE_HPP_
+#define BTREE_HPP_
+
+#include "iterator_traits.hpp"
+#include "reverse_iterator.hpp"
+#include "function.hpp"
+#include "pair.hpp"
+#include "algorithm.hpp"
+#include "type_traits.hpp"
+#include "tree.hpp"
+#include <cstring>
+#include <memory>
+
+namespace ft {
+
+/**
+ * @brief size of one b-tree node, a few cache lines so that a lookup touches only a handful of them
+ */
+enum { _s_btree_node_bytes = 256 };
+
+/**
+ * @brief base class of b+tree node
+ *
+ * 부모 노드와 부모의 children 배열 안에서의 위치를 가지고 있어서 형제 노드를 바로 찾을 수 있다.
+ */
+struct _btree_node_base {
+  _btree_node_base *_m_parent;
+  unsigned short _m_count;    // number of values (leaf) or keys (internal)
+  unsigned short _m_position; // index in _m_parent->_m_children
+  bool _m_leaf;
+};
+
+/**
+ * @brief how a node holds a T : in place when T moves with memcpy, otherwise behind a pointer to its own block
+ *
+ * 노드 안의 값과 키는 insert / erase 때 자리를 옮긴다. 복사가 예외를 던질 수 있는 타입을 하나씩 복사해서 옮기다
+ * 실패하면 노드가 반쯤 옮겨진 채로 남으므로, 그런 타입은 따로 할당하고 노드에는 포인터만 둔다.
+ * 그래서 slot 은 언제나 memmove 로 옮길 수 있고, 복사는 트리를 바꾸기 전에 새 값과 새 separator 를 만들 때만 일어난다.
+ */
+template<class T, bool InPlace = is_trivially_relocatable<T>::value>
+struct _btree_slot {
+  typedef T type;
+  static T &_s_get(type &s) { return s; }
+  static const T &_s_get(const type &s) { return s; }
+};
+
+template<class T>
+struct _btree_slot<T, false> {
+  typedef T *type;
+  static T &_s_get(const type &s) { return *s; }
+};
+
+/**
+ * @brief uninitialized room for one T
+ */
+template<class T>
+struct _btree_raw {
+  char _m_bytes[sizeof(T)] __attribute__((aligned(__alignof__(T))));
+
+  T *_m_get() { return reinterpret_cast<T *>(_m_bytes); }
+};
+
+/**
+ * @brief leaf node, every value of the tree lives in a leaf and leaves are linked in order
+ * @tparam Val value type
+ */
+template<class Val>
+struct _btree_leaf : public _btree_node_base {
+  typedef _btree_slot<Val> _slot_traits;
+  typedef typename _slot_traits::type _slot;
+
+  enum {
+    _s_fit = (_s_btree_node_bytes - sizeof(_btree_node_base) - 2 * sizeof(void *)) / sizeof(_slot),
+    _s_slots = _s_fit > 4 ? _s_fit - 1 : 3,
+    _s_min = _s_slots / 2
+  };
+
+  _btree_leaf *_m_prev;
+  _btree_leaf *_m_next;
+  // one spare slot : a full node takes the new value first and is split afterwards
+  char _m_storage[sizeof(_slot) * (_s_slots + 1)] __attribute__((aligned(__alignof__(_slot))));
+
+  _slot *_m_slots() { return reinterpret_cast<_slot *>(_m_storage); }
+  const _slot *_m_slots() const { return reinterpret_cast<const _slot *>(_m_storage); }
+
+  Val &_m_value(size_t i) { return _slot_traits::_s_get(_m_slots()[i]); }
+  const Val &_m_value(size_t i) const { return _slot_traits::_s_get(_m_slots()[i]); }
+};
+
+/**
+ * @brief internal node, _m_count separator keys and _m_count + 1 children
+ * @tparam Key key type
+ *
+ * _m_key(i) 는 _m_children[i] 의 모든 키보다 크고 _m_children[i + 1] 의 모든 키보다 작거나 같다.
+ */
+template<class Key>
+struct _btree_internal : public _btree_node_base {
+  typedef _btree_slot<Key> _slot_traits;
+  typedef typename _slot_traits::type _slot;
+
+  enum {
+    _s_fit = (_s_btree_node_bytes - sizeof(_btree_node_base) - 2 * sizeof(void *)) / (sizeof(_slot) + sizeof(void *)),
+    _s_slots = _s_fit > 4 ? _s_fit - 1 : 3,
+    _s_min = _s_slots / 2
+  };
+
+  _btree_node_base *_m_children[_s_slots + 2];
+  char _m_storage[sizeof(_slot) * (_s_slots + 1)] __attribute__((aligned(__alignof__(_slot))));
+
+  _slot *_m_slots() { return reinterpret_cast<_slot *>(_m_storage); }
+  const _slot *_m_slots() const { return reinterpret_cast<const _slot *>(_m_storage); }
+
+  Key &_m_key(size_t i) { return _slot_traits::_s_get(_m_slots()[i]); }
+  const Key &_m_key(size_t i) const { return _slot_traits::_s_get(_m_slots()[i]); }
+};
+
+/**
+ * @brief move n slots from src to dst (ranges may overlap), src is left unconstructed
+ *
+ * slot 은 memcpy 로 옮길 수 있는 값이나 포인터이므로 (_btree_slot) 옮기는 중에 예외가 나지 않는다.
+ */
+template<class T>
+void _btree_relocate(T *dst, const T *src, size_t n) {
+  if (n != 0)
+    std::memmove(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(T));
+}
+
+template<typename T>
+struct _btree_iterator {
+  typedef _btree_iterator<T> iterator;
+  typedef ptrdiff_t difference_type;
+  typedef T &reference;
+  typedef T *pointer;
+  typedef T value_type;
+  typedef std::bidirectional_iterator_tag iterator_category;
+
+  typedef _btree_iterator<T> _self;
+  typedef _btree_leaf<T> *_leaf_ptr;
+
+  _leaf_ptr _m_leaf;
+  size_t _m_pos;
+
+  _btree_iterator() : _m_leaf(), _m_pos() {}
+  _btree_iterator(_leaf_ptr leaf, size_t pos) : _m_leaf(leaf), _m_pos(pos) {}
+  _btree_iterator(const _self &src) : _m_leaf(src._m_leaf), _m_pos(src._m_pos) {}
+
+  iterator _m_const_cast() const { return *this; }
+
+  _self &operator=(const _self &src) {
+    _m_leaf = src._m_leaf;
+    _m_pos = src._m_pos;
+    return *this;
+  }
+
+  pointer operator->() const { return &_m_leaf->_m_value(_m_pos); } // node->var
+  reference operator*() const { return _m_leaf->_m_value(_m_pos); } // *node
+  _self &operator++() {
+    if (++_m_pos == _m_leaf->_m_count && _m_leaf->_m_next != 0) {
+      _m_leaf = _m_leaf->_m_next;
+      _m_pos = 0;
+    }
+    return *this;
+  } // ++node
+  _self operator++(int) {
+    _self _tmp = *this;
+    ++*this;
+    return _tmp;
+  } // node++
+  _self &operator--() {
+    if (_m_pos == 0) {
+      _m_leaf = _m_leaf->_m_prev;
+      _m_pos = _m_leaf->_m_count;
+    }
+    --_m_pos;
+    return *this;
+  } // --node
+  _self operator--(int) {
+    _self _tmp = *this;
+    --*this;
+    return _tmp;
+  } // node--
+
+  friend bool operator==(const _self &x, const _self &y) {
+    return x._m_leaf == y._m_leaf && x._m_pos == y._m_pos;
+  }
+  friend bool operator!=(const _self &x, const _self &y) {
+    return !(x == y);
+  }
+};
+
+template<typename T>
+struct _btree_const_iterator {
+  typedef _btree_iterator<T> iterator;
+  typedef ptrdiff_t difference_type;
+  typedef const T &reference;
+  typedef const T *pointer;
+  typedef T value_type;
+  typedef std::bidirectional_iterator_tag iterator_category;
+
+  typedef _btree_const_iterator<T> _self;
+  typedef const _btree_leaf<T> *_leaf_ptr;
+
+  _leaf_ptr _m_leaf;
+  size_t _m_pos;
+
+  _btree_const_iterator() : _m_leaf(), _m_pos() {}
+  _btree_const_iterator(_leaf_ptr leaf, size_t pos) : _m_leaf(leaf), _m_pos(pos) {}
+  _btree_const_iterator(const iterator &it) : _m_leaf(it._m_leaf), _m_pos(it._m_pos) {}
+  _btree_const_iterator(const _self &src) : _m_leaf(src._m_leaf), _m_pos(src._m_pos) {}
+
+  // const iterator to non-const iterator
+  iterator _m_const_cast() const {
+    return iterator(const_cast<typename iterator::_leaf_ptr>(_m_leaf), _m_pos);
+  }
+
+  _self &operator=(const _self &src) {
+    _m_leaf = src._m_leaf;
+    _m_pos = src._m_pos;
+    return *this;
+  }
+
+  pointer operator->() const { return &_m_leaf->_m_value(_m_pos); } // node->var
+  reference operator*() const { return _m_leaf->_m_value(_m_pos); } // *node
+  _self &operator++() {
+    if (++_m_pos == _m_leaf->_m_count && _m_leaf->_m_next != 0) {
+      _m_leaf = _m_leaf->_m_next;
+      _m_pos = 0;
+    }
+    return *this;
+  } // ++node
+  _self operator++(int) {
+    _self _tmp = *this;
+    ++*this;
+    return _tmp;
+  } // node++
+  _self &operator--() {
+    if (_m_pos == 0) {
+      _m_leaf = _m_leaf->_m_prev;
+      _m_pos = _m_leaf->_m_count;
+    }
+    --_m_pos;
+    return *this;
+  } // --node
+  _self operator--(int) {
+    _self _tmp = *this;
+    --*this;
+    return _tmp;
+  } // node--
+
+  friend bool operator==(const _self &x, const _self &y) {
+    return x._m_leaf == y._m_leaf && x._m_pos == y._m_pos;
+  }
+  friend bool operator!=(const _self &x, const _self &y) {
+    return !(x == y);
+  }
+};
+
+/**
+ * @brief B+tree with the interface _rb_tree gives to ft::map (unique keys)
+ * @tparam Key key
+ * @tparam Val pair<key, value>
+ * @tparam KeyOfValue template class that select key of value (functor)
+ * @tparam Compare key_compare type (functor class)
+ * @tparam Alloc allocator type
+ *
+ * 노드 하나가 _s_btree_node_bytes 크기라서 탐색할 때 노드마다 한 두개의 cache line 만 읽는다.
+ * 값은 leaf 에만 있고 leaf 끼리 연결되어 있어서 순회는 배열을 읽는 것과 같다.
+ * 값들이 노드 안에서 이동하므로 rb_tree 와 달리 insert / erase 는 모든 iterator, 참조를 무효화한다.
+ * 트리를 바꾸는 동안에는 slot 만 옮기므로 insert 는 실패하면 트리를 그대로 두고, erase 는 예외를 던지지 않는다.
+ */
+template<class Key, class Val, class KeyOfValue = ft::Select1st<Val>,
+    class Compare = ft::less<Key>, class Alloc = std::allocator<Val> >
+class _btree {
+ protected:
+  typedef _btree_node_base *_base_ptr;
+  typedef _btree_leaf<Val> _leaf;
+  typedef _btree_internal<Key> _internal;
+  typedef typename Alloc::template rebind<_leaf>::other _leaf_allocator;
+  typedef typename Alloc::template rebind<_internal>::other _internal_allocator;
+  typedef typename Alloc::template rebind<Val>::other _value_allocator;
+  typedef typename Alloc::template rebind<Key>::other _key_allocator;
+  typedef typename _leaf::_slot _value_slot;
+  typedef typename _internal::_slot _key_slot;
+  typedef integral_constant<bool, is_trivially_relocatable<Val>::value> _values_in_place;
+  typedef integral_constant<bool, is_trivially_relocatable<Key>::value> _keys_in_place;
+
+  enum {
+    _s_leaf_slots = _leaf::_s_slots,
+    _s_internal_slots = _internal::_s_slots,
+    _s_max_height = 64
+  };
+
+ public:
+  // member types
+  typedef Key key_type;
+  typedef Val value_type;
+  typedef value_type *pointer;
+  typedef const value_type *const_pointer;
+  typedef value_type &reference;
+  typedef const value_type &const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef Alloc allocator_type;
+
+  typedef _btree_iterator<value_type> iterator;
+  typedef _btree_const_iterator<value_type> const_iterator;
+  typedef ft::reverse_iterator<iterator> reverse_iterator;
+  typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+ protected:
+  // member variables
+  _leaf_allocator _m_leaf_alloc;
+  _internal_allocator _m_internal_alloc;
+  _value_allocator _m_value_alloc;  // values and keys that do not live in place (_btree_slot)
+  _key_allocator _m_key_alloc;
+  Compare _m_key_compare;
+  _base_ptr _m_root;
+  _leaf *_m_first;
+  _leaf *_m_last;
+  size_type _m_node_count; // keeps track of size of tree
+
+  /* ****************************************************** */
+  /*                       Memory                           */
+  /* ****************************************************** */
+
+  _leaf *_m_create_leaf() {
+    _leaf *_x = _m_leaf_alloc.allocate(1);
+    _x->_m_parent = 0;
+    _x->_m_count = 0;
+    _x->_m_position = 0;
+    _x->_m_leaf = true;
+    _x->_m_prev = 0;
+    _x->_m_next = 0;
+    return _x;
+  }
+
+  _internal *_m_create_internal() {
+    _internal *_x = _m_internal_alloc.allocate(1);
+    _x->_m_parent = 0;
+    _x->_m_count = 0;
+    _x->_m_position = 0;
+    _x->_m_leaf = false;
+    return _x;
+  }
+
+  void _m_drop_leaf(_leaf *x) { _m_leaf_alloc.deallocate(x, 1); }
+  void _m_drop_internal(_internal *x) { _m_internal_alloc.deallocate(x, 1); }
+
+  // fill slot with a copy of x : the only steps of an insert that can throw
+  template<class T, class A>
+  static void _s_make_slot(A &, T *slot, const T &x, true_type) { ::new(static_cast<void *>(slot)) T(x); }
+
+  template<class T, class A>
+  static void _s_make_slot(A &alloc, T **slot, const T &x, false_type) {
+    T *_p = alloc.allocate(1);
+    try {
+      alloc.construct(_p, x);
+    } catch (...) {
+      alloc.deallocate(_p, 1);
+      throw;
+    }
+    *slot = _p;
+  }
+
+  template<class T, class A>
+  static void _s_drop_slot(A &, T *slot, true_type) { slot->~T(); }
+
+  template<class T, class A>
+  static void _s_drop_slot(A &alloc, T **slot, false_type) {
+    alloc.destroy(*slot);
+    alloc.deallocate(*slot, 1);
+  }
+
+  void _m_make_value(_value_slot *slot, const value_type &x) { _s_make_slot(_m_value_alloc, slot, x, _values_in_place()); }
+  void _m_drop_value(_value_slot *slot) { _s_drop_slot(_m_value_alloc, slot, _values_in_place()); }
+  void _m_make_key(_key_slot *slot, const key_type &k) { _s_make_slot(_m_key_alloc, slot, k, _keys_in_place()); }
+  void _m_drop_key(_key_slot *slot) { _s_drop_slot(_m_key_alloc, slot, _keys_in_place()); }
+
+  // destroy the whole subtree without rebalancing
+  void _m_erase(_base_ptr x) {
+    if (x->_m_leaf) {
+      _leaf *_l = static_cast<_leaf *>(x);
+      for (size_type i = 0; i < _l->_m_count; ++i)
+        _m_drop_value(_l->_m_slots() + i);
+      _m_drop_leaf(_l);
+    } else {
+      _internal *_n = static_cast<_internal *>(x);
+      for (size_type i = 0; i <= _n->_m_count; ++i)
+        _m_erase(_n->_m_children[i]);
+      for (size_type i = 0; i < _n->_m_count; ++i)
+        _m_drop_key(_n->_m_slots() + i);
+      _m_drop_internal(_n);
+    }
+  }
+
+  /**
+   * @brief nodes reserved before an insertion so that splitting can not fail half way
+   */
+  struct _split_nodes {
+    _leaf *_m_leaf;
+    _internal *_m_internals[_s_max_height];
+    size_type _m_count;
+
+    _split_nodes() : _m_leaf(0), _m_count(0) {}
+    _internal *_m_pop() { return _m_internals[--_m_count]; }
+  };
+
+  void _m_reserve(_leaf *x, _split_nodes &nodes) {
+    if (x->_m_count < _s_leaf_slots)
+      return;
+    try {
+      nodes._m_leaf = _m_create_leaf();
+      _base_ptr _p = x->_m_parent;
+      while (_p != 0 && _p->_m_count == _s_internal_slots) {
+        nodes._m_internals[nodes._m_count++] = _m_create_internal();
+        _p = _p->_m_parent;
+      }
+      // a new root only when the split runs off the top (every node on the path is full, or x is the root)
+      if (_p == 0)
+        nodes._m_internals[nodes._m_count++] = _m_create_internal();
+    } catch (...) {
+      _m_release(nodes);
+      throw;
+    }
+  }
+
+  // give back the reserved nodes the insertion did not use
+  void _m_release(_split_nodes &nodes) {
+    if (nodes._m_leaf)
+      _m_drop_leaf(nodes._m_leaf);
+    nodes._m_leaf = 0;
+    while (nodes._m_count)
+      _m_drop_internal(nodes._m_pop());
+  }
+
+  /* ****************************************************** */
+  /*                       Search                           */
+  /* ****************************************************** */
+
+  static const key_type &_s_key(const value_type &v) { return KeyOfValue()(v); }
+
+  // first value position of leaf x whose key is not less than k
+  size_type _m_leaf_lower(const _leaf *x, const key_type &k) const {
+    size_type _lo = 0;
+    size_type _hi = x->_m_count;
+    while (_lo < _hi) {
+      size_type _mid = (_lo + _hi) / 2;
+      if (_m_key_compare(_s_key(x->_m_value(_mid)), k))
+        _lo = _mid + 1;
+      else
+        _hi = _mid;
+    }
+    return _lo;
+  }
+
+  // first value position of leaf x whose key is greater than k
+  size_type _m_leaf_upper(const _leaf *x, const key_type &k) const {
+    size_type _lo = 0;
+    size_type _hi = x->_m_count;
+    while (_lo < _hi) {
+      size_type _mid = (_lo + _hi) / 2;
+      if (_m_key_compare(k, _s_key(x->_m_value(_mid))))
+        _hi = _mid;
+      else
+        _lo = _mid + 1;
+    }
+    return _lo;
+  }
+
+  // child index of internal node x that may contain k
+  size_type _m_child_index(const _internal *x, const key_type &k) const {
+    size_type _lo = 0;
+    size_type _hi = x->_m_count;
+    while (_lo < _hi) {
+      size_type _mid = (_lo + _hi) / 2;
+      if (_m_key_compare(k, x->_m_key(_mid)))
+        _hi = _mid;
+      else
+        _lo = _mid + 1;
+    }
+    return _lo;
+  }
+
+  // the only leaf that can hold k (tree must not be empty)
+  _leaf *_m_find_leaf(const key_type &k) const {
+    _base_ptr _x = _m_root;
+    while (!_x->_m_leaf) {
+      const _internal *_n = static_cast<const _internal *>(_x);
+      _x = _n->_m_children[_m_child_index(_n, k)];
+    }
+    return static_cast<_leaf *>(_x);
+  }
+
+  // position past the last value of a leaf is the first value of the next leaf
+  static iterator _s_make_iterator(_leaf *x, size_type pos) {
+    if (pos == x->_m_count && x->_m_next != 0)
+      return iterator(x->_m_next, 0);
+    return iterator(x, pos);
+  }
+
+  /* ****************************************************** */
+  /*                 Insert (split on overflow)             */
+  /* ****************************************************** */
+
+  static void _s_adopt(_internal *p, size_type from, size_type to) {
+    for (size_type i = from; i <= to; ++i) {
+      p->_m_children[i]->_m_parent = p;
+      p->_m_children[i]->_m_position = static_cast<unsigned short>(i);
+    }
+  }
+
+  /**
+   * @brief insert val at position pos of leaf x, split nodes up to the root if needed
+   * @return iterator to the new value
+   */
+  iterator _m_insert_leaf(_leaf *x, size_type pos, const value_type &val) {
+    _split_nodes _nodes;
+    _m_reserve(x, _nodes);
+
+    // 정렬된 입력이 맨 끝에 붙는 경우에는 반으로 나누지 않고 새 leaf 에 하나만 옮겨서 leaf 를 꽉 채운다
+    size_type _m = (x == _m_last && pos == _s_leaf_slots) ? _s_leaf_slots : (_s_leaf_slots + 1) / 2;
+    // a split pushes up the key of the first value of the new right leaf : copy it before anything moves
+    _btree_raw<_key_slot> _separator;
+    if (_nodes._m_leaf) {
+      try {
+        _m_make_key(_separator._m_get(), _s_key(_m == pos ? val : x->_m_value(_m < pos ? _m : _m - 1)));
+      } catch (...) {
+        _m_release(_nodes);
+        throw;
+      }
+    }
+
+    _value_slot *_v = x->_m_slots();
+    _btree_relocate(_v + pos + 1, _v + pos, x->_m_count - pos);
+    try {
+      _m_make_value(_v + pos, val);
+    } catch (...) {
+      _btree_relocate(_v + pos, _v + pos + 1, x->_m_count - pos);
+      if (_nodes._m_leaf)
+        _m_drop_key(_separator._m_get());
+      _m_release(_nodes);
+      throw;
+    }
+    ++x->_m_count;
+    ++_m_node_count;
+    if (x->_m_count <= _s_leaf_slots)
+      return iterator(x, pos);
+
+    // nothing below copies an element, so nothing below can fail
+    _leaf *_r = _nodes._m_leaf;
+    _nodes._m_leaf = 0;
+    _btree_relocate(_r->_m_slots(), _v + _m, x->_m_count - _m);
+    _r->_m_count = static_cast<unsigned short>(x->_m_count - _m);
+    x->_m_count = static_cast<unsigned short>(_m);
+
+    _r->_m_prev = x;
+    _r->_m_next = x->_m_next;
+    if (x->_m_next)
+      x->_m_next->_m_prev = _r;
+    else
+      _m_last = _r;
+    x->_m_next = _r;
+
+    iterator _it = pos < _m ? iterator(x, pos) : iterator(_r, pos - _m);
+    _m_insert_parent(x, *_separator._m_get(), _r, _nodes);
+    _m_release(_nodes);
+    return _it;
+  }
+
+  /**
+   * @brief link right next to left under left's parent, moving the separator slot k into the parent
+   */
+  void _m_insert_parent(_base_ptr left, const _key_slot &k, _base_ptr right, _split_nodes &nodes) {
+    _internal *_p = static_cast<_internal *>(left->_m_parent);
+    if (_p == 0) {
+      _p = nodes._m_pop();
+      _btree_relocate(_p->_m_slots(), &k, 1);
+      _p->_m_count = 1;
+      _p->_m_children[0] = left;
+      _p->_m_children[1] = right;
+      _s_adopt(_p, 0, 1);
+      _m_root = _p;
+      return;
+    }
+    size_type _i = left->_m_position;
+    _key_slot *_keys = _p->_m_slots();
+    _btree_relocate(_keys + _i + 1, _keys + _i, _p->_m_count - _i);
+    _btree_relocate(_keys + _i, &k, 1);
+    std::memmove(_p->_m_children + _i + 2, _p->_m_children + _i + 1,
+                 (_p->_m_count - _i) * sizeof(_base_ptr));
+    _p->_m_children[_i + 1] = right;
+    ++_p->_m_count;
+    _s_adopt(_p, _i + 1, _p->_m_count);
+    if (_p->_m_count <= _s_internal_slots)
+      return;
+
+    // keys [0, m) stay, key m goes up, keys (m, count) move to the new right node
+    size_type _m = _i == _s_internal_slots ? _s_internal_slots - 1 : _s_internal_slots / 2;
+    _internal *_r = nodes._m_pop();
+    _r->_m_count = static_cast<unsigned short>(_p->_m_count - _m - 1);
+    _btree_relocate(_r->_m_slots(), _keys + _m + 1, _r->_m_count);
+    std::memcpy(_r->_m_children, _p->_m_children + _m + 1, (_r->_m_count + 1) * sizeof(_base_ptr));
+    _s_adopt(_r, 0, _r->_m_count);
+    _p->_m_count = static_cast<unsigned short>(_m);
+    // key m moves up as it is, its slot in _p is past the new count
+    _m_insert_parent(_p, _keys[_m], _r, nodes);
+  }
+
+  /* ****************************************************** */
+  /*                 Erase (merge on underflow)             */
+  /* ****************************************************** */
+
+  // remove key j (already destroyed or moved away) and child j + 1 of p
+  void _m_remove_separator(_internal *p, size_type j) {
+    _key_slot *_keys = p->_m_slots();
+    _btree_relocate(_keys + j, _keys + j + 1, p->_m_count - j - 1);
+    std::memmove(p->_m_children + j + 1, p->_m_children + j + 2, (p->_m_count - j - 1) * sizeof(_base_ptr));
+    --p->_m_count;
+    _s_adopt(p, j + 1, p->_m_count);
+    _m_fix_internal(p);
+  }
+
+  void _m_fix_internal(_internal *x) {
+    if (x == _m_root) {
+      if (x->_m_count == 0) {
+        _m_root = x->_m_children[0];
+        _m_root->_m_parent = 0;
+        _m_root->_m_position = 0;
+        _m_drop_internal(x);
+      }
+      return;
+    }
+    if (x->_m_count >= _internal::_s_min)
+      return;
+
+    _internal *_p = static_cast<_internal *>(x->_m_parent);
+    size_type _i = x->_m_position;
+    _internal *_l = _i > 0 ? static_cast<_internal *>(_p->_m_children[_i - 1]) : 0;
+    _internal *_r = _i < _p->_m_count ? static_cast<_internal *>(_p->_m_children[_i + 1]) : 0;
+    _key_slot *_keys = x->_m_slots();
+
+    if (_l && _l->_m_count > _internal::_s_min) {
+      // rotate right : last child of l moves to the front of x, the keys move through the parent
+      _btree_relocate(_keys + 1, _keys, x->_m_count);
+      _btree_relocate(_keys, _p->_m_slots() + _i - 1, 1);
+      std::memmove(x->_m_children + 1, x->_m_children, (x->_m_count + 1) * sizeof(_base_ptr));
+      x->_m_children[0] = _l->_m_children[_l->_m_count];
+      ++x->_m_count;
+      _s_adopt(x, 0, x->_m_count);
+      _btree_relocate(_p->_m_slots() + _i - 1, _l->_m_slots() + _l->_m_count - 1, 1);
+      --_l->_m_count;
+    } else if (_r && _r->_m_count > _internal::_s_min) {
+      // rotate left : first child of r moves to the end of x
+      _btree_relocate(_keys + x->_m_count, _p->_m_slots() + _i, 1);
+      x->_m_children[x->_m_count + 1] = _r->_m_children[0];
+      ++x->_m_count;
+      _s_adopt(x, x->_m_count, x->_m_count);
+      _btree_relocate(_p->_m_slots() + _i, _r->_m_slots(), 1);
+      _btree_relocate(_r->_m_slots(), _r->_m_slots() + 1, _r->_m_count - 1);
+      std::memmove(_r->_m_children, _r->_m_children + 1, _r->_m_count * sizeof(_base_ptr));
+      --_r->_m_count;
+      _s_adopt(_r, 0, _r->_m_count);
+    } else if (_l) {
+      _m_merge_internal(_l, x, _i - 1);
+    } else {
+      _m_merge_internal(x, _r, _i);
+    }
+  }
+
+  // move separator j of the parent and every key / child of r to the end of l, then drop r
+  void _m_merge_internal(_internal *l, _internal *r, size_type j) {
+    _internal *_p = static_cast<_internal *>(l->_m_parent);
+    _key_slot *_keys = l->_m_slots();
+    _btree_relocate(_keys + l->_m_count, _p->_m_slots() + j, 1);
+    _btree_relocate(_keys + l->_m_count + 1, r->_m_slots(), r->_m_count);
+    std::memcpy(l->_m_children + l->_m_count + 1, r->_m_children, (r->_m_count + 1) * sizeof(_base_ptr));
+    size_type _from = l->_m_count + 1;
+    l->_m_count = static_cast<unsigned short>(l->_m_count + 1 + r->_m_count);
+    _s_adopt(l, _from, l->_m_count);
+    _m_drop_internal(r);
+    _m_remove_separator(_p, j);
+  }
+
+  void _m_fix_leaf(_leaf *x) {
+    if (x == _m_root) {
+      if (x->_m_count == 0) {
+        _m_drop_leaf(x);
+        _m_root = 0;
+        _m_first = 0;
+        _m_last = 0;
+      }
+      return;
+    }
+    if (x->_m_count >= _leaf::_s_min)
+      return;
+
+    _internal *_p = static_cast<_internal *>(x->_m_parent);
+    size_type _i = x->_m_position;
+    _leaf *_l = _i > 0 ? static_cast<_leaf *>(_p->_m_children[_i - 1]) : 0;
+    _leaf *_r = _i < _p->_m_count ? static_cast<_leaf *>(_p->_m_children[_i + 1]) : 0;
+    _value_slot *_v = x->_m_slots();
+    // borrowing a value rewrites the separator with a copy of a key, which only keys held in place do without throwing
+    bool _borrow = _keys_in_place::value;
+
+    if (_borrow && _l && _l->_m_count > _leaf::_s_min) {
+      _btree_relocate(_v + 1, _v, x->_m_count);
+      _btree_relocate(_v, _l->_m_slots() + _l->_m_count - 1, 1);
+      --_l->_m_count;
+      ++x->_m_count;
+      _p->_m_key(_i - 1) = _s_key(x->_m_value(0));
+    } else if (_borrow && _r && _r->_m_count > _leaf::_s_min) {
+      _btree_relocate(_v + x->_m_count, _r->_m_slots(), 1);
+      _btree_relocate(_r->_m_slots(), _r->_m_slots() + 1, _r->_m_count - 1);
+      --_r->_m_count;
+      ++x->_m_count;
+      _p->_m_key(_i) = _s_key(_r->_m_value(0));
+    } else if (_l && _l->_m_count + x->_m_count <= _s_leaf_slots) {
+      _m_merge_leaf(_l, x, _i - 1);
+    } else if (_r && x->_m_count + _r->_m_count <= _s_leaf_slots) {
+      _m_merge_leaf(x, _r, _i);
+    }
+    // else x stays under-filled (keys not held in place only) : its old separators still bound it correctly
+  }
+
+  void _m_merge_leaf(_leaf *l, _leaf *r, size_type j) {
+    _btree_relocate(l->_m_slots() + l->_m_count, r->_m_slots(), r->_m_count);
+    l->_m_count = static_cast<unsigned short>(l->_m_count + r->_m_count);
+    l->_m_next = r->_m_next;
+    if (r->_m_next)
+      r->_m_next->_m_prev = l;
+    else
+      _m_last = l;
+    _m_drop_leaf(r);
+    _internal *_p = static_cast<_internal *>(l->_m_parent);
+    _m_drop_key(_p->_m_slots() + j);
+    _m_remove_separator(_p, j);
+  }
+
+  void _m_copy_from(const _btree &x) {
+    for (const_iterator _it = x.begin(); _it != x.end(); ++_it)
+      insert_unique(end(), *_it);
+  }
+
+ public:
+  _btree() : _m_leaf_alloc(), _m_internal_alloc(), _m_value_alloc(), _m_key_alloc(), _m_key_compare(), _m_root(0), _m_first(0), _m_last(0),
+             _m_node_count(0) {}
+
+  _btree(const Compare &comp, const allocator_type &alloc = allocator_type())
+      : _m_leaf_alloc(alloc), _m_internal_alloc(alloc), _m_value_alloc(alloc), _m_key_alloc(alloc),
+        _m_key_compare(comp), _m_root(0), _m_first(0), _m_last(0),
+        _m_node_count(0) {}
+
+  _btree(const _btree &x)
+      : _m_leaf_alloc(x._m_leaf_alloc), _m_internal_alloc(x._m_internal_alloc), _m_value_alloc(x._m_value_alloc),
+        _m_key_alloc(x._m_key_alloc), _m_key_compare(x._m_key_compare),
+        _m_root(0), _m_first(0), _m_last(0), _m_node_count(0) {
+    try {
+      _m_copy_from(x);
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  ~_btree() { clear(); }
+
+  _btree &operator=(const _btree &x) {
+    if (this != &x) {
+      clear();
+      _m_key_compare = x._m_key_compare;
+      _m_copy_from(x);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return allocator_type(_m_leaf_alloc); }
+
+  Compare key_comp() const { return _m_key_compare; }
+
+  iterator begin() { return iterator(_m_first, 0); }
+  const_iterator begin() const { return const_iterator(_m_first, 0); }
+
+  iterator end() { return _m_last ? iterator(_m_last, _m_last->_m_count) : iterator(); }
+  const_iterator end() const { return _m_last ? const_iterator(_m_last, _m_last->_m_count) : const_iterator(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  size_type size() const { return _m_node_count; }
+
+  size_type max_size() const { return _m_leaf_alloc.max_size() * _s_leaf_slots; }
+
+  bool empty() const { return _m_node_count == 0; }
+
+  void swap(_btree &t) {
+    ft::swap(_m_root, t._m_root);
+    ft::swap(_m_first, t._m_first);
+    ft::swap(_m_last, t._m_last);
+    ft::swap(_m_node_count, t._m_node_count);
+    ft::swap(_m_key_compare, t._m_key_compare);
+    ft::swap(_m_leaf_alloc, t._m_leaf_alloc);
+    ft::swap(_m_internal_alloc, t._m_internal_alloc);
+    ft::swap(_m_value_alloc, t._m_value_alloc);
+    ft::swap(_m_key_alloc, t._m_key_alloc);
+  }
+
+  iterator find(const key_type &k) {
+    iterator _j = lower_bound(k);
+    return (_j == end() || _m_key_compare(k, _s_key(*_j))) ? end() : _j;
+  }
+
+  const_iterator find(const key_type &k) const {
+    const_iterator _j = lower_bound(k);
+    return (_j == end() || _m_key_compare(k, _s_key(*_j))) ? end() : _j;
+  }
+
+  size_type count(const key_type &k) const { return find(k) == end() ? 0 : 1; }
+
+  iterator lower_bound(const key_type &k) {
+    if (_m_root == 0)
+      return end();
+    _leaf *_x = _m_find_leaf(k);
+    return _s_make_iterator(_x, _m_leaf_lower(_x, k));
+  }
+
+  const_iterator lower_bound(const key_type &k) const {
+    return const_cast<_btree *>(this)->lower_bound(k);
+  }
+
+  iterator upper_bound(const key_type &k) {
+    if (_m_root == 0)
+      return end();
+    _leaf *_x = _m_find_leaf(k);
+    return _s_make_iterator(_x, _m_leaf_upper(_x, k));
+  }
+
+  const_iterator upper_bound(const key_type &k) const {
+    return const_cast<_btree *>(this)->upper_bound(k);
+  }
+
+  pair<iterator, iterator> equal_range(const key_type &k) {
+    return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+  }
+
+  pair<const_iterator, const_iterator> equal_range(const key_type &k) const {
+    return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+  }
+
+  template<class ForwardIterator, class OutputIterator>
+  OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+    for (; first != last; ++first, ++out)
+      *out = find(*first);
+    return out;
+  }
+
+  template<class ForwardIterator, class OutputIterator>
+  OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+    for (; first != last; ++first, ++out)
+      *out = find(*first);
+    return out;
+  }
+
+  /**
+   * @brief for map.insert(const value_type)
+   * @return if the key unique, return <iterator: new element, true> else return <iterator: same key element, false>
+   */
+  pair<iterator, bool> insert_unique(const value_type &val) {
+    if (_m_root == 0) {
+      _leaf *_x = _m_create_leaf();
+      try {
+        _m_make_value(_x->_m_slots(), val);
+      } catch (...) {
+        _m_drop_leaf(_x);
+        throw;
+      }
+      _x->_m_count = 1;
+      _m_root = _x;
+      _m_first = _x;
+      _m_last = _x;
+      _m_node_count = 1;
+      return ft::make_pair(begin(), true);
+    }
+    const key_type &_k = _s_key(val);
+    _leaf *_x = _m_find_leaf(_k);
+    size_type _pos = _m_leaf_lower(_x, _k);
+    if (_pos < _x->_m_count && !_m_key_compare(_k, _s_key(_x->_m_value(_pos))))
+      return ft::make_pair(iterator(_x, _pos), false);
+    return ft::make_pair(_m_insert_leaf(_x, _pos, val), true);
+  }
+
+  /**
+   * @brief hint for the position where element can be inserted
+   *
+   * hint 바로 앞 값이 같은 leaf 에 있을 때 (또는 end() 에 붙일 때) 만 탐색 없이 넣는다.
+   */
+  iterator insert_unique(const_iterator position, const value_type &val) {
+    if (_m_root == 0)
+      return insert_unique(val).first;
+    iterator _pos = position._m_const_cast();
+    const key_type &_k = _s_key(val);
+    if (_pos == end()) {
+      if (_m_key_compare(_s_key(_m_last->_m_value(_m_last->_m_count - 1)), _k))
+        return _m_insert_leaf(_m_last, _m_last->_m_count, val);
+    } else if (_pos._m_pos > 0) {
+      const _leaf *_l = _pos._m_leaf;
+      if (_m_key_compare(_s_key(_l->_m_value(_pos._m_pos - 1)), _k) && _m_key_compare(_k, _s_key(_l->_m_value(_pos._m_pos))))
+        return _m_insert_leaf(_pos._m_leaf, _pos._m_pos, val);
+    }
+    return insert_unique(val).first;
+  }
+
+  /**
+   * @brief insert value_type(k, obj) if k is not there yet, nothing is constructed when it is
+   *
+   * 값을 만들기 전에 먼저 찾고, 없을 때만 찾은 위치를 hint 로 insert 한다.
+   */
+  template<class Mapped>
+  pair<iterator, bool> try_emplace_unique(const key_type &k, const Mapped &obj) {
+    iterator _j = lower_bound(k);
+    if (_j != end() && !_m_key_compare(k, _s_key(*_j)))
+      return ft::make_pair(_j, false);
+    return ft::make_pair(insert_unique(_j, value_type(k, obj)), true);
+  }
+
+  pair<iterator, bool> try_emplace_unique(const key_type &k) {
+    iterator _j = lower_bound(k);
+    if (_j != end() && !_m_key_compare(k, _s_key(*_j)))
+      return ft::make_pair(_j, false);
+    return ft::make_pair(insert_unique(_j, value_type(k, typename value_type::second_type())), true);
+  }
+
+  template<class InputIterator>
+  void insert_unique(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      insert_unique(end(), *first);
+  }
+
+  /**
+   * @brief sorted input is appended at end(), which packs the leaves full
+   */
+  template<class InputIterator>
+  void insert_sorted_unique(InputIterator first, InputIterator last) {
+    insert_unique(first, last);
+  }
+
+  void erase(iterator position) {
+    _leaf *_x = position._m_leaf;
+    _value_slot *_v = _x->_m_slots();
+    _m_drop_value(_v + position._m_pos);
+    _btree_relocate(_v + position._m_pos, _v + position._m_pos + 1, _x->_m_count - position._m_pos - 1);
+    --_x->_m_count;
+    --_m_node_count;
+    _m_fix_leaf(_x);
+  }
+
+  /**
+   * @brief remove key of the element from map
+   * @return number of element erased
+   */
+  size_type erase(const key_type &k) {
+    iterator _it = find(k);
+    if (_it == end())
+      return 0;
+    erase(_it);
+    return 1;
+  }
+
+  // erase 가 iterator 를 무효화하므로 지운 키의 lower_bound 로 다음 위치를 다시 찾는다
+  void erase(iterator first, iterator last) {
+    if (first == begin() && last == end()) {
+      clear();
+      return;
+    }
+    _m_erase_range(first, std::distance(first, last), _values_in_place());
+  }
+
+ protected:
+  // values held in place : the key copy is a plain copy and can not throw
+  void _m_erase_range(iterator first, size_type n, true_type) {
+    for (; n > 0; --n) {
+      key_type _k = _s_key(*first);
+      erase(first);
+      first = lower_bound(_k);
+    }
+  }
+
+  // values behind a pointer do not move : find the next one again by its key, without copying it
+  void _m_erase_range(iterator first, size_type n, false_type) {
+    for (; n > 0; --n) {
+      iterator _next = first;
+      const key_type *_k = ++_next == end() ? 0 : &_s_key(*_next);
+      erase(first);
+      first = _k ? lower_bound(*_k) : end();
+    }
+  }
+
+ public:
+
+  void clear() {
+    if (_m_root != 0) {
+      _m_erase(_m_root);
+      _m_root = 0;
+      _m_first = 0;
+      _m_last = 0;
+      _m_node_count = 0;
+    }
+  }
+
+  /**
+   * @brief check order, separators, parent links, leaf chain and count (for tests, O(n))
+   */
+  bool _m_verify() const {
+    if (_m_root == 0)
+      return _m_node_count == 0 && _m_first == 0 && _m_last == 0;
+    size_type _n = 0;
+    const _leaf *_prev = 0;
+    if (!_m_verify(_m_root, 0, 0, _n, _prev) || _prev != _m_last || _m_root->_m_parent != 0)
+      return false;
+    return _n == _m_node_count;
+  }
+
+ protected:
+  bool _m_verify(const _btree_node_base *x, const key_type *lo, const key_type *hi, size_type &n,
+                 const _leaf *&prev) const {
+    if (x->_m_leaf) {
+      const _leaf *_l = static_cast<const _leaf *>(x);
+      if (_l->_m_count == 0 || _l->_m_count > _s_leaf_slots || _l->_m_prev != prev)
+        return false;
+      if (prev ? prev->_m_next != _l : _m_first != _l)
+        return false;
+      for (size_type i = 0; i < _l->_m_count; ++i) {
+        const key_type &_k = _s_key(_l->_m_value(i));
+        if ((lo && _m_key_compare(_k, *lo)) || (hi && !_m_key_compare(_k, *hi)))
+          return false;
+        if (i > 0 && !_m_key_compare(_s_key(_l->_m_value(i - 1)), _k))
+          return false;
+      }
+      n += _l->_m_count;
+      prev = _l;
+      return true;
+    }
+    const _internal *_x = static_cast<const _internal *>(x);
+    if (_x->_m_count == 0 || _x->_m_count > _s_internal_slots)
+      return false;
+    for (size_type i = 0; i <= _x->_m_count; ++i) {
+      const _btree_node_base *_c = _x->_m_children[i];
+      if (_c->_m_parent != _x || _c->_m_position != i)
+        return false;
+      if (i > 0 && i < _x->_m_count && !_m_key_compare(_x->_m_key(i - 1), _x->_m_key(i)))
+        return false;
+      if (!_m_verify(_c, i == 0 ? lo : &_x->_m_key(i - 1), i == _x->_m_count ? hi : &_x->_m_key(i), n, prev))
+        return false;
+    }
+    return true;
+  }
+
+ public:
+  friend bool operator==(const _btree &lhs, const _btree &rhs) {
+    return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+
+  friend bool operator<(const _btree &lhs, const _btree &rhs) {
+    return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+};
+
+/**
+ * @brief Tag that selects the B+tree engine (ft::map<K, T, C, A, ft::btree_tag>)
+ *
+ * insert / erase invalidate every iterator and reference of the map.
+ */
+struct btree_tag {};
+
+template<class Key, class Val, class KeyOfValue, class Compare, class Alloc>
+struct _tree_rep<btree_tag, Key, Val, KeyOfValue, Compare, Alloc> {
+  typedef _btree<Key, Val, KeyOfValue, Compare, Alloc> type;
+};
+
+} // namespace ft
+
+#endif //BTREE_HPP_
@@ -0,0 +1,250 @@
+/*
+ * File: concurrent_map.hpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#ifndef CONCURRENT_MAP_HPP_
+#define CONCURRENT_MAP_HPP_
+
+#include <pthread.h>
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include "pair.hpp"
+#include "function.hpp"
+#include "map.hpp"
+
+namespace ft {
+
+/**
+ * @brief map shared by several threads : the keys are hashed onto shards, each an ft::map behind its own rwlock
+ *
+ * 같은 shard 의 find 들은 read lock 만 잡으므로 서로 막지 않고, 다른 shard 의 쓰기와도 부딪히지 않는다.
+ * shard 가 하나면 (concurrent_map(1)) map 전체를 rwlock 하나로 감싼 것과 같다.
+ *
+ * lock 밖으로 원소를 가리키는 iterator / reference 를 내보낼 수 없으므로 find 는 값을 복사해 주고,
+ * visit / update 는 lock 을 잡은 채 functor 를 부른다 (functor 안에서 같은 map 을 쓰면 deadlock).
+ * Hash 는 Compare 가 같다고 보는 key 들에 같은 값을 주어야 한다.
+ * size / for_each / clear 는 shard 를 하나씩 잠그므로 다른 thread 가 쓰는 동안에는 한 순간의 모습이 아니다.
+ */
+template<class Key, class T, class Compare = std::less<Key>, class Hash = ft::hash<Key>,
+    class Alloc = std::allocator<ft::pair<const Key, T> > >
+class concurrent_map {
+ public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef pair<const Key, T> value_type;
+  typedef Compare key_compare;
+  typedef Hash hasher;
+  typedef Alloc allocator_type;
+  typedef ft::map<Key, T, Compare, Alloc> map_type;
+  typedef typename map_type::size_type size_type;
+
+  enum { default_shards = 64 };
+
+ private:
+  // shards sit next to each other : the padding keeps one shard's lock word off its neighbours' cache lines
+  struct _shard {
+    pthread_rwlock_t _m_lock;
+    map_type _m_map;
+    char _m_pad[64];
+
+    _shard(const Compare &comp, const Alloc &alloc) : _m_map(comp, alloc) {
+      if (pthread_rwlock_init(&_m_lock, 0) != 0)
+        throw std::bad_alloc();
+    }
+    ~_shard() { pthread_rwlock_destroy(&_m_lock); }
+  };
+
+  class _read_guard {
+    pthread_rwlock_t *_m_lock;
+    _read_guard(const _read_guard &);
+    _read_guard &operator=(const _read_guard &);
+   public:
+    explicit _read_guard(_shard &s) : _m_lock(&s._m_lock) { pthread_rwlock_rdlock(_m_lock); }
+    ~_read_guard() { pthread_rwlock_unlock(_m_lock); }
+  };
+
+  class _write_guard {
+    pthread_rwlock_t *_m_lock;
+    _write_guard(const _write_guard &);
+    _write_guard &operator=(const _write_guard &);
+   public:
+    explicit _write_guard(_shard &s) : _m_lock(&s._m_lock) { pthread_rwlock_wrlock(_m_lock); }
+    ~_write_guard() { pthread_rwlock_unlock(_m_lock); }
+  };
+
+  _shard *_m_shards;
+  size_type _m_count;
+  unsigned _m_shift;  // shard of a key is the top bits of its mixed hash
+  hasher _m_hash;
+  key_compare _m_comp;
+
+  // not copyable : a copy would have to lock every shard of the source
+  concurrent_map(const concurrent_map &);
+  concurrent_map &operator=(const concurrent_map &);
+
+  /**
+   * @brief shard of k : Fibonacci hashing, so that identity hashes of sequential keys still spread
+   */
+  _shard &_m_shard_of(const key_type &k) const {
+    if (_m_shift == sizeof(size_t) * CHAR_BIT)
+      return _m_shards[0];
+    size_t _h = _m_hash(k) * static_cast<size_t>(11400714819323198485ULL);
+    return _m_shards[_h >> _m_shift];
+  }
+
+ public:
+  /**
+   * @brief shards is rounded up to a power of two, 1 gives a single reader-writer locked map
+   */
+  explicit concurrent_map(size_type shards = default_shards, const Compare &comp = Compare(),
+                          const Hash &hash = Hash(), const Alloc &alloc = Alloc())
+      : _m_shards(0), _m_count(1), _m_shift(sizeof(size_t) * CHAR_BIT), _m_hash(hash), _m_comp(comp) {
+    while (_m_count < shards) {
+      _m_count *= 2;
+      --_m_shift;
+    }
+    _m_shards = static_cast<_shard *>(::operator new(_m_count * sizeof(_shard)));
+    size_type _built = 0;
+    try {
+      for (; _built < _m_count; ++_built)
+        new(_m_shards + _built) _shard(comp, alloc);
+    } catch (...) {
+      while (_built != 0)
+        _m_shards[--_built].~_shard();
+      ::operator delete(_m_shards);
+      throw;
+    }
+  }
+
+  ~concurrent_map() {
+    for (size_type i = _m_count; i != 0; --i)
+      _m_shards[i - 1].~_shard();
+    ::operator delete(_m_shards);
+  }
+
+  size_type shard_count() const { return _m_count; }
+  key_compare key_comp() const { return _m_comp; }
+  hasher hash_function() const { return _m_hash; }
+
+  size_type size() const {
+    size_type _n = 0;
+    for (size_type i = 0; i < _m_count; ++i) {
+      _read_guard _lock(_m_shards[i]);
+      _n += _m_shards[i]._m_map.size();
+    }
+    return _n;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /* ****************************************************** */
+  /*                      Lookup                            */
+  /* ****************************************************** */
+
+  /**
+   * @brief copies the value of k into out, returns false (out untouched) if there is none
+   */
+  bool find(const key_type &k, mapped_type &out) const {
+    _shard &_s = _m_shard_of(k);
+    _read_guard _lock(_s);
+    typename map_type::const_iterator _it = _s._m_map.find(k);
+    if (_it == _s._m_map.end())
+      return false;
+    out = _it->second;
+    return true;
+  }
+
+  size_type count(const key_type &k) const {
+    _shard &_s = _m_shard_of(k);
+    _read_guard _lock(_s);
+    return _s._m_map.count(k);
+  }
+
+  /**
+   * @brief calls f(const value_type &) under the read lock of k's shard, returns false if k is not there
+   */
+  template<class Function>
+  bool visit(const key_type &k, Function f) const {
+    _shard &_s = _m_shard_of(k);
+    _read_guard _lock(_s);
+    typename map_type::const_iterator _it = _s._m_map.find(k);
+    if (_it == _s._m_map.end())
+      return false;
+    f(*_it);
+    return true;
+  }
+
+  /**
+   * @brief calls f(const value_type &) on every element, one shard at a time (sorted within a shard only)
+   */
+  template<class Function>
+  Function for_each(Function f) const {
+    for (size_type i = 0; i < _m_count; ++i) {
+      _read_guard _lock(_m_shards[i]);
+      for (typename map_type::const_iterator it = _m_shards[i]._m_map.begin(); it != _m_shards[i]._m_map.end(); ++it)
+        f(*it);
+    }
+    return f;
+  }
+
+  /* ****************************************************** */
+  /*                      Modifiers                         */
+  /* ****************************************************** */
+
+  /**
+   * @brief inserts val unless its key is there, returns whether it was inserted
+   */
+  bool insert(const value_type &val) {
+    _shard &_s = _m_shard_of(val.first);
+    _write_guard _lock(_s);
+    return _s._m_map.insert(val).second;
+  }
+
+  /**
+   * @brief sets the value of k to obj, returns true if k was inserted
+   */
+  bool insert_or_assign(const key_type &k, const mapped_type &obj) {
+    _shard &_s = _m_shard_of(k);
+    _write_guard _lock(_s);
+    return _s._m_map.insert_or_assign(k, obj).second;
+  }
+
+  /**
+   * @brief calls f(mapped_type &) under the write lock of k's shard, returns false if k is not there
+   *
+   * read-modify-write (counter 증가 등) 을 다른 thread 와 섞이지 않게 한다.
+   */
+  template<class Function>
+  bool update(const key_type &k, Function f) {
+    _shard &_s = _m_shard_of(k);
+    _write_guard _lock(_s);
+    typename map_type::iterator _it = _s._m_map.find(k);
+    if (_it == _s._m_map.end())
+      return false;
+    f(_it->second);
+    return true;
+  }
+
+  size_type erase(const key_type &k) {
+    _shard &_s = _m_shard_of(k);
+    _write_guard _lock(_s);
+    return _s._m_map.erase(k);
+  }
+
+  void clear() {
+    for (size_type i = 0; i < _m_count; ++i) {
+      _write_guard _lock(_m_shards[i]);
+      _m_shards[i]._m_map.clear();
+    }
+  }
+};
+}
+
+#endif //CONCURRENT_MAP_HPP_
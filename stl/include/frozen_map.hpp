@@ -0,0 +1,557 @@
+/*
+ * File: frozen_map.hpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#ifndef FROZEN_MAP_HPP_
+#define FROZEN_MAP_HPP_
+
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include "pair.hpp"
+#include "algorithm.hpp"
+#include "function.hpp"
+#include "type_traits.hpp"
+#include "tree.hpp"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ft {
+
+/* ****************************************************** */
+/*                 Eytzinger layout                       */
+/* ****************************************************** */
+
+/**
+ * @brief keys in Eytzinger (BFS) order : 1-based, root at [1], children of k at [2k] and [2k + 1]
+ *
+ * 0 은 end 를 뜻한다. 탐색 루프에는 분기가 없고 (비교 결과를 인덱스에 더한다) 몇 level 아래의 key 들을 미리 prefetch 한다.
+ */
+template<class Key, class Compare>
+struct _frozen_eytzinger_layout {
+  // number of keys in a cache line : children of k that many levels down are contiguous
+  enum { _s_prefetch_block = sizeof(Key) >= 64 ? 1 : 64 / sizeof(Key) };
+
+  static size_t _s_slots(size_t n) { return n + 1; }
+  static size_t _s_end(size_t) { return 0; }
+
+  static size_t _s_first(size_t n) {
+    if (n == 0)
+      return 0;
+    size_t _k = 1;
+    while (2 * _k <= n)
+      _k *= 2;
+    return _k;
+  }
+
+  static size_t _s_last(size_t n) {
+    if (n == 0)
+      return 0;
+    size_t _k = 1;
+    while (2 * _k + 1 <= n)
+      _k = 2 * _k + 1;
+    return _k;
+  }
+
+  static size_t _s_next(size_t k, size_t n) {
+    if (2 * k + 1 <= n) {
+      k = 2 * k + 1;
+      while (2 * k <= n)
+        k *= 2;
+      return k;
+    }
+    // right child 인 동안 올라간 뒤 한 번 더 올라가면 다음 원소 (root 를 넘어가면 0)
+    while (k & 1)
+      k >>= 1;
+    return k >> 1;
+  }
+
+  static size_t _s_prev(size_t k, size_t n) {
+    if (k == 0)
+      return _s_last(n);
+    if (2 * k <= n) {
+      k = 2 * k;
+      while (2 * k + 1 <= n)
+        k = 2 * k + 1;
+      return k;
+    }
+    while (k != 0 && !(k & 1))
+      k >>= 1;
+    return k >> 1;
+  }
+
+  // index reached after descending past the leaves : strip the trailing "went right" steps and one "went left"
+  static size_t _s_resolve(size_t k) {
+    return k >> (__builtin_ctzl(~k) + 1);
+  }
+
+  // nothing besides the keys themselves
+  template<class KeyAlloc>
+  void _m_build(KeyAlloc &, Key *, size_t) {}
+  template<class KeyAlloc>
+  void _m_clear(KeyAlloc &) {}
+
+  size_t _m_lower_bound(const Key *keys, size_t n, const Key &k, const Compare &comp) const {
+    size_t _i = 1;
+    while (_i <= n) {
+      FT_PREFETCH(keys + _i * _s_prefetch_block);
+      _i = 2 * _i + comp(keys[_i], k);
+    }
+    return _s_resolve(_i);
+  }
+
+  size_t _m_upper_bound(const Key *keys, size_t n, const Key &k, const Compare &comp) const {
+    size_t _i = 1;
+    while (_i <= n) {
+      FT_PREFETCH(keys + _i * _s_prefetch_block);
+      _i = 2 * _i + !comp(k, keys[_i]);
+    }
+    return _s_resolve(_i);
+  }
+};
+
+/* ****************************************************** */
+/*                 Block layout (integer keys)            */
+/* ****************************************************** */
+
+/**
+ * @brief Returns the number of keys of block[0, B) that are less than x
+ *
+ * 기본은 scalar 로 세고, SSE2/AVX2 가 켜져 있으면 int 와 64 bit 정수는 한 block (cache line) 을 한 번에 비교한다.
+ * block 은 정렬되어 있으므로 비교 mask 는 아래쪽부터 연속된 1 이다. 그래서 popcount 대신 ~mask 의 ctz 로 센다.
+ */
+template<class Key, size_t B>
+struct _block_rank {
+  static size_t _s_rank(const Key *block, Key x) {
+    size_t _r = 0;
+    for (size_t _i = 0; _i < B; _i++)
+      _r += block[_i] < x;
+    return _r;
+  }
+};
+
+#if defined(__AVX2__)
+template<>
+struct _block_rank<int, 16> {
+  static size_t _s_rank(const int *block, int x) {
+    __m256i _x = _mm256_set1_epi32(x);
+    __m256i _lo = _mm256_cmpgt_epi32(_x, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block)));
+    __m256i _hi = _mm256_cmpgt_epi32(_x, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 8)));
+    unsigned int _mask = _mm256_movemask_ps(_mm256_castsi256_ps(_lo))
+        | (_mm256_movemask_ps(_mm256_castsi256_ps(_hi)) << 8);
+    return __builtin_ctz(~_mask);
+  }
+};
+
+template<class Int64>
+struct _block_rank_int64 {
+  static size_t _s_rank(const Int64 *block, Int64 x) {
+    __m256i _x = _mm256_set1_epi64x(x);
+    __m256i _lo = _mm256_cmpgt_epi64(_x, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block)));
+    __m256i _hi = _mm256_cmpgt_epi64(_x, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 4)));
+    unsigned int _mask = _mm256_movemask_pd(_mm256_castsi256_pd(_lo))
+        | (_mm256_movemask_pd(_mm256_castsi256_pd(_hi)) << 4);
+    return __builtin_ctz(~_mask);
+  }
+};
+
+template<>
+struct _block_rank<long, 8> : public _block_rank_int64<long> {};
+template<>
+struct _block_rank<long long, 8> : public _block_rank_int64<long long> {};
+#elif defined(__SSE2__)
+template<>
+struct _block_rank<int, 16> {
+  static size_t _s_rank(const int *block, int x) {
+    __m128i _x = _mm_set1_epi32(x);
+    unsigned int _mask = 0;
+    for (int _i = 0; _i < 4; _i++) {
+      __m128i _lt = _mm_cmpgt_epi32(_x, _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 4 * _i)));
+      _mask |= _mm_movemask_ps(_mm_castsi128_ps(_lt)) << (4 * _i);
+    }
+    return __builtin_ctz(~_mask);
+  }
+};
+#endif
+
+/**
+ * @brief keys sorted in blocks of one cache line, with layers of block maxima on top (static B+-tree)
+ *
+ * layer l + 1 의 j 번째 key 는 layer l 의 j 번째 block 의 마지막 (가장 큰) key 다.
+ * 한 level 마다 block 하나를 _block_rank 로 세어서 내려가므로 비교 분기가 없고 level 수도 log_B(n) 이다.
+ * 빈 자리는 numeric_limits<Key>::max() 로 채운다. 정수 key 와 less 비교에서만 쓴다.
+ */
+template<class Key, class Compare>
+struct _frozen_block_layout {
+  enum { _s_block = sizeof(Key) >= 64 ? 1 : 64 / sizeof(Key), _s_max_height = 24 };
+
+  Key *_m_index;                 // every layer above the keys, bottom layer first
+  size_t _m_index_size;
+  const Key *_m_layer[_s_max_height];
+  size_t _m_height;
+
+  _frozen_block_layout() : _m_index(0), _m_index_size(0), _m_height(0) {}
+
+  static size_t _s_round(size_t n) { return (n + _s_block - 1) / _s_block * _s_block; }
+
+  // at least one pad, so that the last entry of every layer is max() and no search walks past the last block
+  static size_t _s_slots(size_t n) { return _s_round(n + 1); }
+  static size_t _s_end(size_t n) { return n; }
+  static size_t _s_first(size_t) { return 0; }
+  static size_t _s_next(size_t k, size_t) { return k + 1; }
+  static size_t _s_prev(size_t k, size_t) { return k - 1; }
+
+  // pad the last block of keys and build the layers of maxima (integers : plain assignment is construction)
+  template<class KeyAlloc>
+  void _m_build(KeyAlloc &alloc, Key *keys, size_t n) {
+    const Key _pad = std::numeric_limits<Key>::max();
+    size_t _size = _s_slots(n);
+    for (size_t _i = n; _i < _size; _i++)
+      keys[_i] = _pad;
+
+    size_t _sizes[_s_max_height];
+    size_t _total = 0;
+    _m_height = 0;
+    for (size_t _s = _size; _s > _s_block; _s = _sizes[_m_height++]) {
+      _sizes[_m_height] = _s_round(_s / _s_block);
+      _total += _sizes[_m_height];
+    }
+    if (_total == 0)
+      return;
+    _m_index = alloc.allocate(_total);
+    _m_index_size = _total;
+
+    Key *_p = _m_index;
+    const Key *_below = keys;
+    for (size_t _l = 0; _l < _m_height; _l++) {
+      size_t _count = _size / _s_block;
+      for (size_t _j = 0; _j < _count; _j++)
+        _p[_j] = _below[_j * _s_block + _s_block - 1];
+      for (size_t _j = _count; _j < _sizes[_l]; _j++)
+        _p[_j] = _pad;
+      _m_layer[_l] = _p;
+      _below = _p;
+      _size = _sizes[_l];
+      _p += _size;
+    }
+  }
+
+  template<class KeyAlloc>
+  void _m_clear(KeyAlloc &alloc) {
+    if (_m_index)
+      alloc.deallocate(_m_index, _m_index_size);
+    _m_index = 0;
+    _m_index_size = 0;
+    _m_height = 0;
+  }
+
+  size_t _m_lower_bound(const Key *keys, size_t n, const Key &k, const Compare &) const {
+    if (n == 0)
+      return 0;
+    size_t _b = 0;
+    for (size_t _l = _m_height; _l > 0; --_l) {
+      _b = _b * _s_block + _block_rank<Key, _s_block>::_s_rank(_m_layer[_l - 1] + _b * _s_block, k);
+    }
+    size_t _i = _b * _s_block + _block_rank<Key, _s_block>::_s_rank(keys + _b * _s_block, k);
+    return _i < n ? _i : n;
+  }
+
+  size_t _m_upper_bound(const Key *keys, size_t n, const Key &k, const Compare &comp) const {
+    if (k == std::numeric_limits<Key>::max())
+      return n;
+    return _m_lower_bound(keys, n, static_cast<Key>(k + 1), comp);
+  }
+};
+
+/**
+ * @brief picks the layout of frozen_map : the block layout for integer keys ordered by less, Eytzinger otherwise
+ */
+template<class Key, class Compare, bool = is_integral<Key>::value>
+struct _frozen_layout {
+  typedef _frozen_eytzinger_layout<Key, Compare> type;
+};
+
+template<class Key>
+struct _frozen_layout<Key, ft::less<Key>, true> {
+  typedef _frozen_block_layout<Key, ft::less<Key> > type;
+};
+
+template<class Key>
+struct _frozen_layout<Key, std::less<Key>, true> {
+  typedef _frozen_block_layout<Key, std::less<Key> > type;
+};
+
+// what a frozen_map iterator points at : keys and values live in separate arrays, so there is no pair to refer to
+template<class Key, class T>
+struct _frozen_map_reference {
+  const Key &first;
+  const T &second;
+
+  _frozen_map_reference(const Key &k, const T &v) : first(k), second(v) {}
+};
+
+template<class Key, class T, class Layout>
+struct _frozen_map_iterator {
+  typedef ptrdiff_t difference_type;
+  typedef _frozen_map_reference<Key, T> value_type;
+  typedef value_type reference;
+  typedef std::bidirectional_iterator_tag iterator_category;
+
+  // operator-> has to return something that owns the pair of references
+  struct pointer {
+    value_type _m_pair;
+    explicit pointer(const value_type &p) : _m_pair(p) {}
+    const value_type *operator->() const { return &_m_pair; }
+  };
+
+  typedef _frozen_map_iterator<Key, T, Layout> _self;
+
+  const Key *_m_keys;
+  const T *_m_values;
+  size_t _m_size;
+  size_t _m_index;
+
+  _frozen_map_iterator() : _m_keys(), _m_values(), _m_size(), _m_index() {}
+  _frozen_map_iterator(const Key *keys, const T *values, size_t n, size_t k)
+      : _m_keys(keys), _m_values(values), _m_size(n), _m_index(k) {}
+
+  const Key &key() const { return _m_keys[_m_index]; }
+  const T &value() const { return _m_values[_m_index]; }
+
+  reference operator*() const { return value_type(key(), value()); }
+  pointer operator->() const { return pointer(**this); }
+
+  _self &operator++() {
+    _m_index = Layout::_s_next(_m_index, _m_size);
+    return *this;
+  }
+  _self operator++(int) {
+    _self _tmp = *this;
+    ++*this;
+    return _tmp;
+  }
+  _self &operator--() {
+    _m_index = Layout::_s_prev(_m_index, _m_size);
+    return *this;
+  }
+  _self operator--(int) {
+    _self _tmp = *this;
+    --*this;
+    return _tmp;
+  }
+
+  friend bool operator==(const _self &x, const _self &y) { return x._m_index == y._m_index; }
+  friend bool operator!=(const _self &x, const _self &y) { return x._m_index != y._m_index; }
+};
+
+/**
+ * @brief read-only sorted map stored as two parallel arrays (keys, values) laid out for searching
+ * @tparam Key key type
+ * @tparam T mapped type
+ * @tparam Compare key compare
+ * @tparam Alloc allocator (rebound to Key and T)
+ *
+ * 정수 key 를 less 로 비교하면 block layout (SIMD 로 block 단위 비교), 그 외에는 Eytzinger layout 을 쓴다.
+ * 어느 쪽이든 탐색은 포인터 없이 인덱스 계산만 한다.
+ * 원소를 바꿀 수 없으므로 iterator 는 (key, value) 참조 묶음 (first, second) 을 돌려준다.
+ * (참조 묶음을 값으로 돌려주는 iterator 라서 reverse_iterator 는 없다. end() 에서 -- 로 거꾸로 돈다.)
+ * ex) ft::frozen_map<int, int> f = m.freeze();
+ */
+template<class Key, class T, class Compare = std::less<Key>,
+    class Alloc = std::allocator<ft::pair<const Key, T> > >
+class frozen_map {
+ public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef Compare key_compare;
+  typedef Alloc allocator_type;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef typename _frozen_layout<Key, Compare>::type _layout;
+  typedef _frozen_map_iterator<Key, T, _layout> iterator;
+  typedef iterator const_iterator;
+  typedef typename iterator::value_type value_type;
+
+ private:
+  typedef typename Alloc::template rebind<Key>::other _key_allocator;
+  typedef typename Alloc::template rebind<T>::other _value_allocator;
+
+  _key_allocator _m_key_alloc;
+  _value_allocator _m_value_alloc;
+  Compare _m_key_compare;
+  _layout _m_layout;
+  Key *_m_keys;   // _layout::_s_slots(n) slots, only the ones visited from _s_first to _s_end hold elements
+  T *_m_values;
+  size_type _m_size;
+
+  // fill the arrays in order from a sorted range of pairs
+  template<class InputIterator>
+  void _m_build(InputIterator first, size_type n) {
+    if (n == 0)
+      return;
+    const size_type _slots = _layout::_s_slots(n);
+    _m_keys = _m_key_alloc.allocate(_slots);
+    try {
+      _m_values = _m_value_alloc.allocate(_slots);
+    } catch (...) {
+      _m_key_alloc.deallocate(_m_keys, _slots);
+      _m_keys = 0;
+      throw;
+    }
+    size_type _k = _layout::_s_first(n);
+    try {
+      for (; _k != _layout::_s_end(n); _k = _layout::_s_next(_k, n), ++first) {
+        _m_key_alloc.construct(_m_keys + _k, first->first);
+        try {
+          _m_value_alloc.construct(_m_values + _k, first->second);
+        } catch (...) {
+          _m_key_alloc.destroy(_m_keys + _k);
+          throw;
+        }
+      }
+      _m_layout._m_build(_m_key_alloc, _m_keys, n);
+    } catch (...) {
+      // every slot before _k is complete, _k itself holds nothing
+      _m_destroy(_k, n);
+      _m_key_alloc.deallocate(_m_keys, _slots);
+      _m_value_alloc.deallocate(_m_values, _slots);
+      _m_keys = 0;
+      _m_values = 0;
+      throw;
+    }
+    _m_size = n;
+  }
+
+  // destroy the elements placed before index stop (in order)
+  void _m_destroy(size_type stop, size_type n) {
+    for (size_type _k = _layout::_s_first(n); _k != stop; _k = _layout::_s_next(_k, n)) {
+      _m_key_alloc.destroy(_m_keys + _k);
+      _m_value_alloc.destroy(_m_values + _k);
+    }
+  }
+
+  iterator _m_make_iterator(size_type k) const { return iterator(_m_keys, _m_values, _m_size, k); }
+
+ public:
+  explicit frozen_map(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type())
+      : _m_key_alloc(alloc), _m_value_alloc(alloc), _m_key_compare(comp), _m_layout(), _m_keys(0), _m_values(0), _m_size(0) {}
+
+  /**
+   * @brief Build from a range of pairs sorted by comp without duplicated keys (not checked)
+   * @tparam ForwardIterator iterator of ft::map or of a sorted container of ft::pair
+   */
+  template<class ForwardIterator>
+  frozen_map(ForwardIterator first, ForwardIterator last,
+             const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type())
+      : _m_key_alloc(alloc), _m_value_alloc(alloc), _m_key_compare(comp), _m_layout(), _m_keys(0), _m_values(0), _m_size(0) {
+    _m_build(first, std::distance(first, last));
+  }
+
+  frozen_map(const frozen_map &x)
+      : _m_key_alloc(x._m_key_alloc), _m_value_alloc(x._m_value_alloc), _m_key_compare(x._m_key_compare),
+        _m_layout(), _m_keys(0), _m_values(0), _m_size(0) {
+    _m_build(x.begin(), x.size());
+  }
+
+  ~frozen_map() { clear(); }
+
+  frozen_map &operator=(const frozen_map &x) {
+    if (this != &x) {
+      frozen_map _tmp(x);
+      swap(_tmp);
+    }
+    return *this;
+  }
+
+  void swap(frozen_map &x) {
+    ft::swap(_m_key_alloc, x._m_key_alloc);
+    ft::swap(_m_value_alloc, x._m_value_alloc);
+    ft::swap(_m_key_compare, x._m_key_compare);
+    ft::swap(_m_layout, x._m_layout);
+    ft::swap(_m_keys, x._m_keys);
+    ft::swap(_m_values, x._m_values);
+    ft::swap(_m_size, x._m_size);
+  }
+
+  void clear() {
+    if (_m_keys == 0)
+      return;
+    _m_destroy(_layout::_s_end(_m_size), _m_size);
+    _m_layout._m_clear(_m_key_alloc);
+    _m_key_alloc.deallocate(_m_keys, _layout::_s_slots(_m_size));
+    _m_value_alloc.deallocate(_m_values, _layout::_s_slots(_m_size));
+    _m_keys = 0;
+    _m_values = 0;
+    _m_size = 0;
+  }
+
+  iterator begin() const { return _m_make_iterator(_layout::_s_first(_m_size)); }
+  iterator end() const { return _m_make_iterator(_layout::_s_end(_m_size)); }
+
+  size_type size() const { return _m_size; }
+  bool empty() const { return _m_size == 0; }
+
+  key_compare key_comp() const { return _m_key_compare; }
+
+  iterator lower_bound(const key_type &k) const {
+    return _m_make_iterator(_m_layout._m_lower_bound(_m_keys, _m_size, k, _m_key_compare));
+  }
+  iterator upper_bound(const key_type &k) const {
+    return _m_make_iterator(_m_layout._m_upper_bound(_m_keys, _m_size, k, _m_key_compare));
+  }
+
+  iterator find(const key_type &k) const {
+    const size_type _end = _layout::_s_end(_m_size);
+    size_type _i = _m_layout._m_lower_bound(_m_keys, _m_size, k, _m_key_compare);
+    return _m_make_iterator((_i == _end || _m_key_compare(k, _m_keys[_i])) ? _end : _i);
+  }
+
+  size_type count(const key_type &k) const { return find(k) == end() ? 0 : 1; }
+
+  pair<iterator, iterator> equal_range(const key_type &k) const {
+    return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+  }
+
+  /**
+   * @brief Returns the value mapped to k
+   * @exception std::out_of_range if k is not in the map
+   */
+  const mapped_type &at(const key_type &k) const {
+    iterator _it = find(k);
+    if (_it == end())
+      throw std::out_of_range("ft::frozen_map::at");
+    return _it.value();
+  }
+};
+
+template<class Key, class T, class Compare, class Alloc>
+bool operator==(const frozen_map<Key, T, Compare, Alloc> &lhs, const frozen_map<Key, T, Compare, Alloc> &rhs) {
+  if (lhs.size() != rhs.size())
+    return false;
+  for (typename frozen_map<Key, T, Compare, Alloc>::iterator i = lhs.begin(), j = rhs.begin(); i != lhs.end(); ++i, ++j)
+    if (!(i.key() == j.key()) || !(i.value() == j.value()))
+      return false;
+  return true;
+}
+
+template<class Key, class T, class Compare, class Alloc>
+bool operator!=(const frozen_map<Key, T, Compare, Alloc> &lhs, const frozen_map<Key, T, Compare, Alloc> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<class Key, class T, class Compare, class Alloc>
+void swap(frozen_map<Key, T, Compare, Alloc> &x, frozen_map<Key, T, Compare, Alloc> &y) {
+  x.swap(y);
+}
+
+} // namespace ft
+
+#endif //FROZEN_MAP_HPP_
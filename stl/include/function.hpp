@@ -9,6 +9,9 @@
 #ifndef FUNCTION_HPP_
 #define FUNCTION_HPP_
 
+#include <cstddef>
+#include <string>
+
 namespace ft {
 
 template<typename Arg, typename Result>
@@ -24,11 +27,33 @@ struct binary_function {
   typedef Result result_type;
 };
 
-template<class T>
+template<class T = void>
 struct less : binary_function<T, T, bool> {
   bool operator()(const T &x, const T &y) const { return x < y; }
 };
 
+/**
+ * @brief less<> compares any two types with operator<
+ *
+ * is_transparent 가 있으므로 map<std::string, T, ft::less<> >::find("key") 처럼 key_type 을 만들지 않고 찾을 수 있다.
+ */
+template<>
+struct less<void> {
+  typedef void is_transparent;
+
+  template<class T, class U>
+  bool operator()(const T &x, const U &y) const { return x < y; }
+};
+
+/**
+ * @brief key extractor of set / multiset : the value is the key
+ */
+template<class T>
+struct Identity : public unary_function<T, T> {
+  T &operator()(T &x) const { return x; }
+  const T &operator()(const T &x) const { return x; }
+};
+
 template<class Pair>
 struct Select1st : public unary_function<Pair, typename Pair::first_type> {
   typename Pair::first_type &operator()(Pair &x) const {
@@ -48,6 +73,64 @@ struct Select2nd : public unary_function<Pair, typename Pair::second_type> {
     return x.second;
   }
 };
+
+/**
+ * @brief conflict policies of map::merge / assign_union : true keeps the element of the first map
+ *
+ * 같은 key 가 양쪽에 있을 때 (first, second) 로 불린다. 직접 만든 functor 도 같은 형태면 쓸 수 있다.
+ */
+struct keep_first {
+  template<class T>
+  bool operator()(const T &, const T &) const { return true; }
+};
+
+struct keep_second {
+  template<class T>
+  bool operator()(const T &, const T &) const { return false; }
+};
+
+/**
+ * @brief hash functor of concurrent_map (c++98 has no std::hash)
+ *
+ * 정수와 포인터는 값 그대로, std::string 은 FNV-1a. 값을 섞는 것은 쓰는 쪽 (concurrent_map 의 shard 선택) 이 한다.
+ * 다른 key 는 같은 형태의 functor 를 직접 넘긴다.
+ */
+template<class T>
+struct hash;
+
+#define FT_INTEGRAL_HASH(T) \
+  template<> \
+  struct hash<T> : unary_function<T, size_t> { \
+    size_t operator()(T x) const { return static_cast<size_t>(x); } \
+  };
+
+FT_INTEGRAL_HASH(bool)
+FT_INTEGRAL_HASH(char)
+FT_INTEGRAL_HASH(signed char)
+FT_INTEGRAL_HASH(unsigned char)
+FT_INTEGRAL_HASH(wchar_t)
+FT_INTEGRAL_HASH(short)
+FT_INTEGRAL_HASH(unsigned short)
+FT_INTEGRAL_HASH(int)
+FT_INTEGRAL_HASH(unsigned int)
+FT_INTEGRAL_HASH(long)
+FT_INTEGRAL_HASH(unsigned long)
+#undef FT_INTEGRAL_HASH
+
+template<class T>
+struct hash<T *> : unary_function<T *, size_t> {
+  size_t operator()(T *p) const { return reinterpret_cast<size_t>(p); }
+};
+
+template<>
+struct hash<std::string> : unary_function<std::string, size_t> {
+  size_t operator()(const std::string &s) const {
+    size_t _h = static_cast<size_t>(2166136261u);
+    for (std::string::size_type i = 0; i < s.size(); ++i)
+      _h = (_h ^ static_cast<unsigned char>(s[i])) * static_cast<size_t>(16777619u);
+    return _h;
+  }
+};
 }
 
 #endif //FUNCTION_HPP_
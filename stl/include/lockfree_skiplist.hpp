@@ -0,0 +1,571 @@
+/*
+ * File: lockfree_skiplist.hpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#ifndef LOCKFREE_SKIPLIST_HPP_
+#define LOCKFREE_SKIPLIST_HPP_
+
+#if __cplusplus < 201103L
+#error "lockfree_skiplist.hpp needs C++11 atomics (configure with -DFT_LOCKFREE=ON)"
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+#include "pair.hpp"
+#include "function.hpp"
+
+namespace ft {
+
+/* ****************************************************** */
+/*              Epoch based reclamation                   */
+/* ****************************************************** */
+
+struct _epoch_retired {
+  void *_m_ptr;
+  void (*_m_destroy)(void *);
+  unsigned long _m_epoch;  // global epoch read after the node became unreachable
+};
+
+/**
+ * @brief one per thread (reused after the thread exits) : what the thread announced, and what it retired
+ *
+ * _m_announce 는 pin 되어 있는 동안 (epoch << 1) | 1, 아니면 0.
+ * _m_nest 와 _m_retired 는 주인 thread 만 쓴다.
+ */
+struct _epoch_record {
+  std::atomic<unsigned long> _m_announce;
+  std::atomic<bool> _m_in_use;
+  _epoch_record *_m_next;
+  unsigned _m_id;
+  unsigned _m_nest;
+  std::vector<_epoch_retired> _m_retired;
+};
+
+/**
+ * @brief epoch based reclamation shared by every lock-free container
+ *
+ * 노드는 모든 link 에서 떨어진 뒤 retire 되고, 그 때의 global epoch 가 2 늘어난 뒤에 free 된다.
+ * global epoch 는 pin 된 모든 thread 가 현재 epoch 를 announce 했을 때만 늘어나므로,
+ * 그 사이에 모든 reader 는 노드에 닿을 수 없게 된 뒤에 pin 한 것이다.
+ * pin 된 채 멈춘 thread 는 reclamation 을 (그 thread 가 풀 때까지) 막는다.
+ */
+class _epoch_domain {
+  std::atomic<unsigned long> _m_epoch;
+  std::atomic<_epoch_record *> _m_records;
+  std::atomic<unsigned> _m_next_id;
+
+  _epoch_domain() : _m_epoch(0), _m_records(nullptr), _m_next_id(0) {}
+  _epoch_domain(const _epoch_domain &);
+  _epoch_domain &operator=(const _epoch_domain &);
+
+  // at exit no thread is left to read what is still waiting
+  ~_epoch_domain() {
+    _epoch_record *_r = _m_records.load();
+    while (_r != nullptr) {
+      for (size_t i = 0; i < _r->_m_retired.size(); ++i)
+        _r->_m_retired[i]._m_destroy(_r->_m_retired[i]._m_ptr);
+      _epoch_record *_next = _r->_m_next;
+      delete _r;
+      _r = _next;
+    }
+  }
+
+  bool _m_try_advance() {
+    unsigned long _e = _m_epoch.load();
+    for (_epoch_record *r = _m_records.load(std::memory_order_acquire); r != nullptr; r = r->_m_next) {
+      unsigned long _a = r->_m_announce.load();
+      if ((_a & 1) && (_a >> 1) != _e)
+        return false;
+    }
+    return _m_epoch.compare_exchange_strong(_e, _e + 1);
+  }
+
+ public:
+  enum { _s_collect_every = 64 };
+
+  static _epoch_domain &_s_instance() {
+    static _epoch_domain _domain;
+    return _domain;
+  }
+
+  _epoch_record *_m_acquire() {
+    for (_epoch_record *r = _m_records.load(std::memory_order_acquire); r != nullptr; r = r->_m_next) {
+      bool _free = false;
+      if (!r->_m_in_use.load(std::memory_order_relaxed)
+          && r->_m_in_use.compare_exchange_strong(_free, true, std::memory_order_acquire))
+        return r;
+    }
+    _epoch_record *_r = new _epoch_record;
+    _r->_m_announce.store(0, std::memory_order_relaxed);
+    _r->_m_in_use.store(true, std::memory_order_relaxed);
+    _r->_m_id = _m_next_id.fetch_add(1, std::memory_order_relaxed);
+    _r->_m_nest = 0;
+    _r->_m_next = _m_records.load(std::memory_order_relaxed);
+    while (!_m_records.compare_exchange_weak(_r->_m_next, _r, std::memory_order_release, std::memory_order_relaxed)) {}
+    return _r;
+  }
+
+  // what is still retired stays with the record for the next thread that takes it
+  void _m_release(_epoch_record *r) {
+    _m_collect(r);
+    r->_m_in_use.store(false, std::memory_order_release);
+  }
+
+  void _m_pin(_epoch_record *r) {
+    if (r->_m_nest++ == 0)
+      r->_m_announce.store((_m_epoch.load() << 1) | 1);
+  }
+
+  void _m_unpin(_epoch_record *r) {
+    if (--r->_m_nest == 0)
+      r->_m_announce.store(0, std::memory_order_release);
+  }
+
+  void _m_retire(_epoch_record *r, void *p, void (*destroy)(void *)) {
+    _epoch_retired _item = {p, destroy, _m_epoch.load()};
+    r->_m_retired.push_back(_item);
+    if (r->_m_retired.size() % _s_collect_every == 0)
+      _m_collect(r);
+  }
+
+  // frees what every thread has stopped seeing (retired in epoch order, so a prefix)
+  void _m_collect(_epoch_record *r) {
+    _m_try_advance();
+    unsigned long _e = _m_epoch.load();
+    size_t _n = 0;
+    while (_n < r->_m_retired.size() && r->_m_retired[_n]._m_epoch + 2 <= _e) {
+      r->_m_retired[_n]._m_destroy(r->_m_retired[_n]._m_ptr);
+      ++_n;
+    }
+    r->_m_retired.erase(r->_m_retired.begin(), r->_m_retired.begin() + _n);
+  }
+};
+
+// record of the calling thread, given back when the thread exits
+struct _epoch_thread {
+  _epoch_record *_m_record;
+
+  _epoch_thread() : _m_record(_epoch_domain::_s_instance()._m_acquire()) {}
+  ~_epoch_thread() { _epoch_domain::_s_instance()._m_release(_m_record); }
+
+  static _epoch_record *_s_record() {
+    static thread_local _epoch_thread _self;
+    return _self._m_record;
+  }
+};
+
+/**
+ * @brief keeps every node the calling thread can reach alive until it goes out of scope
+ */
+class _epoch_guard {
+  _epoch_record *_m_record;
+  _epoch_guard(const _epoch_guard &);
+  _epoch_guard &operator=(const _epoch_guard &);
+
+ public:
+  _epoch_guard() : _m_record(_epoch_thread::_s_record()) { _epoch_domain::_s_instance()._m_pin(_m_record); }
+  ~_epoch_guard() { _epoch_domain::_s_instance()._m_unpin(_m_record); }
+
+  _epoch_record *_m_get() const { return _m_record; }
+};
+
+/* ****************************************************** */
+/*                     Skip list                          */
+/* ****************************************************** */
+
+/**
+ * @brief tower of a skip list : _m_next has _m_height links, the low bit of a link marks this node deleted at that level
+ *
+ * 표시된 link 는 다시 바뀌지 않는다. head 는 _m_value_field 를 만들지 않는다.
+ */
+template<class Val>
+struct _skiplist_node {
+  Val _m_value_field;
+  std::atomic<int> _m_owners;  // inserter still linking + deleter still unlinking
+  unsigned _m_height;
+  std::atomic<uintptr_t> _m_next[1];
+
+  static _skiplist_node *_s_ptr(uintptr_t w) { return reinterpret_cast<_skiplist_node *>(w & ~uintptr_t(1)); }
+  static bool _s_marked(uintptr_t w) { return (w & 1) != 0; }
+  static uintptr_t _s_word(_skiplist_node *x) { return reinterpret_cast<uintptr_t>(x); }
+
+  static size_t _s_bytes(unsigned height) {
+    return sizeof(_skiplist_node) + (height - 1) * sizeof(std::atomic<uintptr_t>);
+  }
+
+  // first node after x at the bottom level that is not deleted, 0 for the end
+  static _skiplist_node *_s_next_live(_skiplist_node *x) {
+    _skiplist_node *_y = _s_ptr(x->_m_next[0].load(std::memory_order_acquire));
+    while (_y != nullptr) {
+      uintptr_t _w = _y->_m_next[0].load(std::memory_order_acquire);
+      if (!_s_marked(_w))
+        break;
+      _y = _s_ptr(_w);
+    }
+    return _y;
+  }
+};
+
+/**
+ * @brief forward iterator of lockfree_skiplist, pins the epoch of its thread while it points to an element
+ *
+ * 원소를 가리키는 동안 그 노드는 지워져도 free 되지 않는다. 만든 thread 에서만 쓸 수 있고,
+ * 오래 들고 있으면 모든 lock-free container 의 reclamation 이 그만큼 늦어진다.
+ */
+template<class Val>
+class _skiplist_iterator {
+  typedef _skiplist_node<Val> _node;
+
+  _node *_m_node;
+  _epoch_record *_m_record;
+
+  void _m_pin() {
+    if (_m_node != nullptr)
+      _epoch_domain::_s_instance()._m_pin(_m_record = _epoch_thread::_s_record());
+  }
+
+  void _m_unpin() {
+    if (_m_node != nullptr)
+      _epoch_domain::_s_instance()._m_unpin(_m_record);
+  }
+
+ public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef Val value_type;
+  typedef ptrdiff_t difference_type;
+  typedef const Val *pointer;
+  typedef const Val &reference;
+
+  _skiplist_iterator() : _m_node(nullptr), _m_record(nullptr) {}
+  explicit _skiplist_iterator(_node *x) : _m_node(x), _m_record(nullptr) { _m_pin(); }
+  _skiplist_iterator(const _skiplist_iterator &x) : _m_node(x._m_node), _m_record(nullptr) { _m_pin(); }
+  ~_skiplist_iterator() { _m_unpin(); }
+
+  _skiplist_iterator &operator=(const _skiplist_iterator &x) {
+    _skiplist_iterator _tmp(x);
+    std::swap(_m_node, _tmp._m_node);
+    std::swap(_m_record, _tmp._m_record);
+    return *this;
+  }
+
+  reference operator*() const { return _m_node->_m_value_field; }
+  pointer operator->() const { return &_m_node->_m_value_field; }
+
+  _skiplist_iterator &operator++() {
+    _node *_next = _node::_s_next_live(_m_node);
+    if (_next == nullptr)
+      _m_unpin();
+    _m_node = _next;
+    return *this;
+  }
+
+  _skiplist_iterator operator++(int) {
+    _skiplist_iterator _tmp(*this);
+    ++*this;
+    return _tmp;
+  }
+
+  bool operator==(const _skiplist_iterator &x) const { return _m_node == x._m_node; }
+  bool operator!=(const _skiplist_iterator &x) const { return _m_node != x._m_node; }
+};
+
+/**
+ * @brief ordered map for many threads : lock-free skip list (Harris marked links, Herlihy-Shavit towers)
+ *
+ * find / lower_bound / upper_bound / insert / erase 는 lock 없이 CAS 로만 동작하고, 읽는 쪽도 지워진 노드를 떼어내며 돕는다.
+ * 지워진 노드는 epoch based reclamation 으로, 그 노드를 볼 수 있던 thread 가 모두 지나간 뒤에 free 된다.
+ *
+ * 원소는 한 번 넣으면 바꿀 수 없다 (값을 바꾸려면 erase 후 insert). iterator 는 다른 thread 의 변경과 섞여
+ * 한 순간의 모습이 아닌 (weakly consistent) 순서대로의 원소들을 보여준다. size 는 대략의 값이다.
+ */
+template<class Key, class T, class Compare = std::less<Key> >
+class lockfree_skiplist {
+ public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef pair<const Key, T> value_type;
+  typedef Compare key_compare;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef const value_type &reference;
+  typedef const value_type &const_reference;
+  typedef _skiplist_iterator<value_type> iterator;
+  typedef iterator const_iterator;
+
+ private:
+  typedef _skiplist_node<value_type> _node;
+
+  // a tower grows one level with probability 1/4 : 16 levels are plenty for 2^32 elements
+  enum { _s_max_height = 16, _s_count_stripes = 16 };
+
+  // size is counted on several cache lines, one shared counter would serialize the writers
+  struct _count_stripe {
+    std::atomic<ptrdiff_t> _m_count;
+    char _m_pad[64 - sizeof(std::atomic<ptrdiff_t>)];
+  };
+
+  _node *_m_head;
+  key_compare _m_comp;
+  _count_stripe _m_counts[_s_count_stripes];
+
+  lockfree_skiplist(const lockfree_skiplist &);
+  lockfree_skiplist &operator=(const lockfree_skiplist &);
+
+  static const Key &_s_key(const _node *x) { return x->_m_value_field.first; }
+
+  static unsigned _s_random_height() {
+    static thread_local uint32_t _x = 2463534242u ^ static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&_x) >> 4);
+    _x ^= _x << 13;
+    _x ^= _x >> 17;
+    _x ^= _x << 5;
+    return __builtin_ctz(_x | (1u << (2 * _s_max_height - 2))) / 2 + 1;
+  }
+
+  static _node *_s_create(const value_type &val, unsigned height) {
+    _node *_x = static_cast<_node *>(::operator new(_node::_s_bytes(height)));
+    try {
+      new(&_x->_m_value_field) value_type(val);
+    } catch (...) {
+      ::operator delete(_x);
+      throw;
+    }
+    new(&_x->_m_owners) std::atomic<int>(2);
+    _x->_m_height = height;
+    for (unsigned i = 0; i < height; ++i)
+      new(&_x->_m_next[i]) std::atomic<uintptr_t>(0);
+    return _x;
+  }
+
+  static void _s_destroy(void *p) {
+    static_cast<_node *>(p)->_m_value_field.~value_type();
+    ::operator delete(p);
+  }
+
+  // whichever of the inserter and the deleter finishes last hands the node to the epoch domain
+  static void _s_drop_owner(_node *x, _epoch_record *r) {
+    if (x->_m_owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      _epoch_domain::_s_instance()._m_retire(r, x, _s_destroy);
+  }
+
+  void _m_add_count(const _epoch_guard &g, ptrdiff_t n) {
+    _m_counts[g._m_get()->_m_id % _s_count_stripes]._m_count.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  bool _m_before(const _node *x, const Key &k, bool upper) const {
+    return upper ? !_m_comp(k, _s_key(x)) : _m_comp(_s_key(x), k);
+  }
+
+  /**
+   * @brief first live node not before k at every level (k < node, or k <= node for lower bounds)
+   *
+   * 지나가는 길에 표시된 노드들을 떼어낸다. pred 가 그 level 에서 지워지는 중이면 head 부터 다시 찾는다.
+   * 반환값은 bottom level 의 succ. 호출하는 쪽이 pin 되어 있어야 한다.
+   */
+  _node *_m_search(const Key &k, bool upper, _node **preds, _node **succs) const {
+    for (;;) {
+      _node *_pred = _m_head;
+      _node *_curr = nullptr;
+      bool _retry = false;
+      for (int i = _s_max_height - 1; i >= 0 && !_retry; --i) {
+        uintptr_t _w = _pred->_m_next[i].load(std::memory_order_acquire);
+        if (_node::_s_marked(_w)) {
+          _retry = true;
+          break;
+        }
+        _curr = _node::_s_ptr(_w);
+        while (_curr != nullptr) {
+          uintptr_t _succ = _curr->_m_next[i].load(std::memory_order_acquire);
+          if (_node::_s_marked(_succ)) {
+            uintptr_t _expected = _node::_s_word(_curr);
+            if (!_pred->_m_next[i].compare_exchange_strong(_expected, _succ & ~uintptr_t(1),
+                                                           std::memory_order_acq_rel, std::memory_order_acquire)) {
+              _retry = true;
+              break;
+            }
+            _curr = _node::_s_ptr(_succ);
+            continue;
+          }
+          if (!_m_before(_curr, k, upper))
+            break;
+          _pred = _curr;
+          _curr = _node::_s_ptr(_succ);
+        }
+        if (preds != nullptr) {
+          preds[i] = _pred;
+          succs[i] = _curr;
+        }
+      }
+      if (!_retry)
+        return _curr;
+    }
+  }
+
+  // links x above the bottom level, stopping at the first level where it is already being deleted
+  void _m_link_tower(_node *x, _node **preds, _node **succs) {
+    for (unsigned i = 1; i < x->_m_height; ++i) {
+      for (;;) {
+        uintptr_t _w = x->_m_next[i].load(std::memory_order_acquire);
+        if (_node::_s_marked(_w))
+          return;
+        if (_w != _node::_s_word(succs[i])
+            && !x->_m_next[i].compare_exchange_strong(_w, _node::_s_word(succs[i]), std::memory_order_acq_rel))
+          return;
+        uintptr_t _expected = _node::_s_word(succs[i]);
+        if (preds[i]->_m_next[i].compare_exchange_strong(_expected, _node::_s_word(x), std::memory_order_acq_rel))
+          break;
+        _m_search(_s_key(x), false, preds, succs);
+      }
+    }
+  }
+
+ public:
+  explicit lockfree_skiplist(const Compare &comp = Compare()) : _m_comp(comp) {
+    _m_head = static_cast<_node *>(::operator new(_node::_s_bytes(_s_max_height)));
+    _m_head->_m_height = _s_max_height;
+    for (unsigned i = 0; i < _s_max_height; ++i)
+      new(&_m_head->_m_next[i]) std::atomic<uintptr_t>(0);
+    for (unsigned i = 0; i < _s_count_stripes; ++i)
+      _m_counts[i]._m_count.store(0, std::memory_order_relaxed);
+  }
+
+  // no other thread may use the list any more : what is still linked is freed right away
+  ~lockfree_skiplist() {
+    _node *_x = _node::_s_ptr(_m_head->_m_next[0].load(std::memory_order_acquire));
+    while (_x != nullptr) {
+      _node *_next = _node::_s_ptr(_x->_m_next[0].load(std::memory_order_relaxed));
+      _s_destroy(_x);
+      _x = _next;
+    }
+    ::operator delete(_m_head);
+  }
+
+  key_compare key_comp() const { return _m_comp; }
+
+  size_type size() const {
+    ptrdiff_t _n = 0;
+    for (unsigned i = 0; i < _s_count_stripes; ++i)
+      _n += _m_counts[i]._m_count.load(std::memory_order_relaxed);
+    return _n > 0 ? static_cast<size_type>(_n) : 0;
+  }
+
+  bool empty() const { return begin() == end(); }
+
+  /* ****************************************************** */
+  /*                      Iterators                         */
+  /* ****************************************************** */
+
+  iterator begin() const {
+    _epoch_guard _guard;
+    return iterator(_node::_s_next_live(_m_head));
+  }
+
+  iterator end() const { return iterator(); }
+
+  /* ****************************************************** */
+  /*                      Lookup                            */
+  /* ****************************************************** */
+
+  iterator lower_bound(const key_type &k) const {
+    _epoch_guard _guard;
+    return iterator(_m_search(k, false, nullptr, nullptr));
+  }
+
+  iterator upper_bound(const key_type &k) const {
+    _epoch_guard _guard;
+    return iterator(_m_search(k, true, nullptr, nullptr));
+  }
+
+  iterator find(const key_type &k) const {
+    _epoch_guard _guard;
+    _node *_x = _m_search(k, false, nullptr, nullptr);
+    return iterator(_x == nullptr || _m_comp(k, _s_key(_x)) ? nullptr : _x);
+  }
+
+  size_type count(const key_type &k) const { return find(k) != end(); }
+
+  /* ****************************************************** */
+  /*                      Modifiers                         */
+  /* ****************************************************** */
+
+  /**
+   * @brief bottom level CAS publishes the element, the tower above is linked afterwards
+   */
+  pair<iterator, bool> insert(const value_type &val) {
+    _epoch_guard _guard;
+    _node *_preds[_s_max_height];
+    _node *_succs[_s_max_height];
+    _node *_x = nullptr;
+    for (;;) {
+      _node *_found = _m_search(val.first, false, _preds, _succs);
+      if (_found != nullptr && !_m_comp(val.first, _s_key(_found))) {
+        if (_x != nullptr)
+          _s_destroy(_x);  // never published
+        return ft::make_pair(iterator(_found), false);
+      }
+      if (_x == nullptr)
+        _x = _s_create(val, _s_random_height());
+      for (unsigned i = 0; i < _x->_m_height; ++i)
+        _x->_m_next[i].store(_node::_s_word(_succs[i]), std::memory_order_relaxed);
+      uintptr_t _expected = _node::_s_word(_succs[0]);
+      if (_preds[0]->_m_next[0].compare_exchange_strong(_expected, _node::_s_word(_x), std::memory_order_acq_rel))
+        break;
+    }
+    _m_add_count(_guard, 1);
+    _m_link_tower(_x, _preds, _succs);
+    // erased while the tower was going up : the deleter may have searched before the last link
+    if (_node::_s_marked(_x->_m_next[0].load(std::memory_order_acquire)))
+      _m_search(_s_key(_x), false, nullptr, nullptr);
+    iterator _it(_x);
+    _s_drop_owner(_x, _guard._m_get());
+    return ft::make_pair(_it, true);
+  }
+
+  template<class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  /**
+   * @brief marks the tower top-down, the bottom mark decides who erased it, then unlinks it with a search
+   */
+  size_type erase(const key_type &k) {
+    _epoch_guard _guard;
+    _node *_x = _m_search(k, false, nullptr, nullptr);
+    if (_x == nullptr || _m_comp(k, _s_key(_x)))
+      return 0;
+    for (unsigned i = _x->_m_height - 1; i >= 1; --i) {
+      uintptr_t _w = _x->_m_next[i].load(std::memory_order_acquire);
+      while (!_node::_s_marked(_w) && !_x->_m_next[i].compare_exchange_weak(_w, _w | 1, std::memory_order_acq_rel)) {}
+    }
+    uintptr_t _w = _x->_m_next[0].load(std::memory_order_acquire);
+    for (;;) {
+      if (_node::_s_marked(_w))
+        return 0;  // another thread erased it first
+      if (_x->_m_next[0].compare_exchange_weak(_w, _w | 1, std::memory_order_acq_rel))
+        break;
+    }
+    _m_add_count(_guard, -1);
+    _m_search(k, false, nullptr, nullptr);
+    _s_drop_owner(_x, _guard._m_get());
+    return 1;
+  }
+
+  void clear() {
+    for (iterator it = begin(); it != end(); it = begin())
+      erase(it->first);
+  }
+};
+}
+
+#endif //LOCKFREE_SKIPLIST_HPP_
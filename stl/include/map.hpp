@@ -13,10 +13,20 @@
 #include "pair.hpp"
 #include "function.hpp"
 #include "tree.hpp"
+#include "btree.hpp"
+#include "arena_tree.hpp"
+#include "frozen_map.hpp"
 
 namespace ft {
 
-template<class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::pair<const Key, T> > >
+/**
+ * @brief sorted associative container of unique keys
+ * @tparam Tag tree engine : rb_tree_tag (default), rb_tree_order_statistic_tag (rank / select / count_range)
+ *             btree_tag (cache friendly B+tree, insert / erase invalidate iterators)
+ *             or rb_tree_arena_tag (nodes in one array linked by 32 bit indices)
+ */
+template<class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::pair<const Key, T> >,
+    class Tag = rb_tree_tag>
 class map {
  public:
   typedef Key key_type;
@@ -25,7 +35,7 @@ class map {
   typedef Compare key_compare;
 
   class value_compare : public std::binary_function<value_type, value_type, bool> {
-    friend class map<Key, T, Compare, Alloc>;
+    friend class map<Key, T, Compare, Alloc, Tag>;
    protected:
     Compare _comp;
     /**
@@ -45,7 +55,7 @@ class map {
   };
 
  private:
-  typedef _rb_tree<key_type, value_type, Select1st<value_type>, key_compare, Alloc> rep_type;
+  typedef typename _tree_rep<Tag, key_type, value_type, Select1st<value_type>, key_compare, Alloc>::type rep_type;
   rep_type _m_tree;
 
  public:
@@ -60,6 +70,12 @@ class map {
   typedef typename rep_type::const_pointer const_pointer;
   typedef typename rep_type::reverse_iterator reverse_iterator;
   typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
+  // not taken from rep_type : only the red-black tree engines have node handles
+  typedef _rb_tree_node_handle<key_type, value_type, Select1st<value_type>, Alloc> node_type;
+  typedef _node_insert_return<iterator, node_type> insert_return_type;
+  // finger search handles, see get_cursor()
+  typedef _rb_tree_cursor<rep_type, iterator> cursor;
+  typedef _rb_tree_cursor<rep_type, const_iterator> const_cursor;
 
   /**
    * @brief Default constructor creates no elements
@@ -85,6 +101,21 @@ class map {
     _m_tree.insert_unique(first, last);
   }
 
+  /**
+   * @brief Range constructor for a range already sorted by comp without duplicated keys
+   *
+   * Links the nodes directly into a balanced tree in linear time, the order is not checked.
+   * ex) ft::map<int, int> m(ft::sorted_unique, v.begin(), v.end());
+   */
+  template<class InputIterator>
+  map(sorted_unique_t,
+      InputIterator first,
+      InputIterator last,
+      const key_compare &comp = key_compare(),
+      const allocator_type &alloc = allocator_type()) : _m_tree(comp, alloc) {
+    _m_tree.insert_sorted_unique(first, last);
+  }
+
   /**
    * @brief Map Copy constructor
    * @param x map
@@ -93,6 +124,14 @@ class map {
    */
   map(const map &x) : _m_tree(x._m_tree) {}
 
+  /**
+   * @brief Copy constructor that clones the tree on several threads
+   *
+   * ex) ft::map<int, int> snapshot(m, ft::parallel_copy()); // 모든 cpu 사용
+   * 결과는 copy constructor 와 같다. red-black tree engine 에서만 쓸 수 있다.
+   */
+  map(const map &x, parallel_copy_t p) : _m_tree(x._m_tree, p) {}
+
   /**
    * @brief Destroys the container object
    *
@@ -187,11 +226,7 @@ class map {
    * 있다면 값 return
    */
   mapped_type &operator[](const key_type &k) {
-    iterator _i = lower_bound(k);
-    if (_i == end() || key_comp()(k, (*_i).first)) {
-      _i = insert(_i, value_type(k, mapped_type()));
-    }
-    return (*_i).second;
+    return (*try_emplace(k).first).second;
   }
 
   /* ****************************************************** */
@@ -213,6 +248,57 @@ class map {
   void insert(InputIterator first, InputIterator last) {
     _m_tree.insert_unique(first, last);
   }
+  // sorted range (order is not checked)
+  template<class InputIterator>
+  void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+    _m_tree.insert_sorted_unique(first, last);
+  }
+  // node taken out by extract(), nh is empty afterwards unless the key was already there
+  insert_return_type insert(const node_type &nh) {
+    return _m_tree.insert_unique(nh);
+  }
+
+  /**
+   * @brief Inserts (k, obj) only if k is not in the map, obj is not copied when it is
+   * @return same as insert(val)
+   *
+   * ex) m.try_emplace(id, buffer); // 이미 있는 id 면 buffer 를 복사하지도, value_type 을 만들지도 않는다
+   * 인자가 없으면 mapped_type() 은 노드를 새로 만들 때만 생성된다.
+   */
+  pair<iterator, bool> try_emplace(const key_type &k) { return _m_tree.try_emplace_unique(k); }
+
+  template<class M>
+  pair<iterator, bool> try_emplace(const key_type &k, const M &obj) { return _m_tree.try_emplace_unique(k, obj); }
+
+  /**
+   * @brief Assigns obj to the element with key k if there is one (in place), inserts (k, obj) otherwise
+   * @return (element, true if it was inserted)
+   */
+  template<class M>
+  pair<iterator, bool> insert_or_assign(const key_type &k, const M &obj) {
+    pair<iterator, bool> _ret = _m_tree.try_emplace_unique(k, obj);
+    if (!_ret.second)
+      (*_ret.first).second = obj;
+    return _ret;
+  }
+
+  /**
+   * @brief Unlinks an element and returns it in a node handle, no memory is freed
+   *
+   * ex) cold.insert(hot.extract(it)); // 노드를 다시 할당하거나 pair 를 복사하지 않는다
+   * red-black tree engine 에서만 쓸 수 있다.
+   */
+  node_type extract(const_iterator position) { return _m_tree.extract(position); }
+  node_type extract(const key_type &k) { return _m_tree.extract(k); }
+
+  /**
+   * @brief Moves elements of other whose key is not in this map, by relinking their nodes
+   *
+   * ex) cold.splice(hot, it); // it 하나만 옮긴다, 옮겼으면 true
+   * 이미 있는 key 의 원소는 other 에 그대로 남는다.
+   */
+  void splice(map &other) { _m_tree.splice(other._m_tree); }
+  bool splice(map &other, iterator position) { return _m_tree.splice(other._m_tree, position); }
 
   // erase
   void erase(iterator position) {
@@ -231,6 +317,16 @@ class map {
   // clear
   void clear() { _m_tree.clear(); }
 
+  /**
+   * @brief Lets clear() and the destructor free the nodes on a background thread
+   *
+   * ex) m.set_deferred_destruction(true); // 큰 map 을 지워도 호출한 thread 는 O(1)
+   * 기다리는 노드 수는 ft::set_deferred_destruction_limit 로 제한되고, ft::flush_deferred_destruction 로 기다릴 수 있다.
+   * red-black tree engine 에서만 쓸 수 있다.
+   */
+  void set_deferred_destruction(bool on) { _m_tree.set_deferred_destruction(on); }
+  bool deferred_destruction() const { return _m_tree.deferred_destruction(); }
+
   /* ****************************************************** */
   /*                      Observers                         */
   /* ****************************************************** */
@@ -298,54 +394,212 @@ class map {
   pair<const_iterator, const_iterator> equal_range(const key_type &k) const { return _m_tree.equal_range(k); }
   pair<iterator, iterator> equal_range(const key_type &k) { return _m_tree.equal_range(k); }
 
-  template<class Key1, class T1, class Compare1, class Alloc1>
-  friend bool operator==(const map<Key1, T1, Compare1, Alloc1> &lhs,
-                         const map<Key1, T1, Compare1, Alloc1> &rhs);
+  /**
+   * @brief find / count / lower_bound / upper_bound / equal_range with a key of another type (heterogeneous lookup)
+   *
+   * key_compare 에 is_transparent 가 있을 때만 쓸 수 있다. ex) map<std::string, int, ft::less<> >::find("key")
+   * 는 std::string 을 만들지 않는다. red-black tree engine (rb_tree_tag, rb_tree_order_statistic_tag) 만 지원한다.
+   */
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type find(const K &k) { return _m_tree.find(k); }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, const_iterator>::type find(const K &k) const {
+    return _m_tree.find(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, size_type>::type count(const K &k) const {
+    return _m_tree.count(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type lower_bound(const K &k) {
+    return _m_tree.lower_bound(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, const_iterator>::type lower_bound(const K &k) const {
+    return _m_tree.lower_bound(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type upper_bound(const K &k) {
+    return _m_tree.upper_bound(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, const_iterator>::type upper_bound(const K &k) const {
+    return _m_tree.upper_bound(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, pair<iterator, iterator> >::type equal_range(const K &k) {
+    return _m_tree.equal_range(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, pair<const_iterator, const_iterator> >::type
+  equal_range(const K &k) const {
+    return _m_tree.equal_range(k);
+  }
+
+  /**
+   * @brief Searches every key of [first, last) and writes find(key) for each of them to out
+   * @return out past the last result
+   *
+   * ex) m.find_many(keys.begin(), keys.end(), results.begin());
+   * 여러 탐색을 동시에 진행해서 memory latency 를 겹치게 하므로 find 를 반복하는 것보다 빠르다.
+   */
+  template<class ForwardIterator, class OutputIterator>
+  OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+    return _m_tree.find_many(first, last, out);
+  }
+  template<class ForwardIterator, class OutputIterator>
+  OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+    return _m_tree.find_many(first, last, out);
+  }
+
+  /**
+   * @brief Returns a cursor whose find / lower_bound / upper_bound start from the element found last
+   *
+   * ex) map<long, int>::cursor c = m.get_cursor(); while (...) sum += c.find(t++)->second;
+   * 가까운 key 를 연달아 찾을 때 (timestamp, 순차 scan) root 부터 찾는 find 보다 빠르다.
+   * cursor 가 가리키는 원소를 erase 하면 cursor 도 무효가 된다. red-black tree engine 에서만 쓸 수 있다.
+   */
+  cursor get_cursor() { return cursor(_m_tree); }
+  const_cursor get_cursor() const { return const_cursor(_m_tree); }
+
+  /**
+   * @brief Moves every element whose key is not less than k into right (right is cleared first)
+   *
+   * ex) m.split(500, upper); // m : keys < 500, upper : keys >= 500
+   * 노드를 옮기기만 하므로 O(log n) 이다 (order statistic tree 가 아니면 원소 수를 세는 데 작은 쪽 크기만큼 더 든다).
+   * red-black tree engine 에서만 쓸 수 있다.
+   */
+  void split(const key_type &k, map &right) { _m_tree.split(k, right._m_tree); }
+
+  /**
+   * @brief Moves every element of right into this map, right keeps only the elements whose key is already here
+   *
+   * right 의 key 가 모두 이 map 의 key 보다 크면 O(log n) 이고 right 는 비게 된다.
+   * 아니면 splice(right) 처럼 원소를 하나씩 옮기고, 이 map 에 이미 있는 key 의 원소는 덮어쓰지 않고 right 에 남긴다.
+   */
+  void join(map &right) { _m_tree.join(right._m_tree); }
+
+  /**
+   * @brief Moves every element of src into this map, src becomes empty
+   * @param resolve for a key in both maps, resolve(mine, theirs) returns true to keep mine
+   *
+   * ex) m.merge(today, ft::keep_second()); // today 의 값이 이긴다
+   * 두 map 을 한 번 같이 훑고 트리를 다시 엮으므로 O(n + m) 이고, allocator 가 같으면 노드를 복사하지 않는다.
+   * red-black tree engine 에서만 쓸 수 있다.
+   */
+  void merge(map &src) { _m_tree.merge(src._m_tree, keep_first()); }
+  template<class Resolve>
+  void merge(map &src, Resolve resolve) { _m_tree.merge(src._m_tree, resolve); }
+
+  // Keeps only the elements whose key is also in other, O(n + m)
+  void intersect(const map &other) { _m_tree.intersect(other._m_tree); }
+  // Removes the elements whose key is in other, O(n + m)
+  void subtract(const map &other) { _m_tree.subtract(other._m_tree); }
+
+  /**
+   * @brief Replaces the content by a copy of a | b, a & b or a - b
+   *
+   * ex) diff.assign_difference(yesterday, today);
+   * 값은 a 의 것을 쓴다 (union 에서 resolve 가 false 를 돌려준 key 만 b 의 것). O(n + m).
+   */
+  void assign_union(const map &a, const map &b) { _m_tree.assign_union(a._m_tree, b._m_tree, keep_first()); }
+  template<class Resolve>
+  void assign_union(const map &a, const map &b, Resolve resolve) {
+    _m_tree.assign_union(a._m_tree, b._m_tree, resolve);
+  }
+  void assign_intersection(const map &a, const map &b) { _m_tree.assign_intersection(a._m_tree, b._m_tree); }
+  void assign_difference(const map &a, const map &b) { _m_tree.assign_difference(a._m_tree, b._m_tree); }
+
+  /**
+   * @brief Returns a read-only copy laid out for fast lookups (see frozen_map)
+   *
+   * ex) ft::frozen_map<int, int> f = m.freeze();
+   * 한 번 만들고 계속 읽기만 하는 map 이면 freeze 한 것을 쓰는 것이 좋다.
+   */
+  frozen_map<Key, T, Compare, Alloc> freeze() const {
+    return frozen_map<Key, T, Compare, Alloc>(begin(), end(), key_comp(), get_allocator());
+  }
+
+  /* ****************************************************** */
+  /*    Order statistic (rb_tree_order_statistic_tag only)  */
+  /* ****************************************************** */
+
+  /**
+   * @brief Returns the number of elements whose key goes before k in O(log n)
+   * @param k
+   * @return index of lower_bound(k)
+   */
+  size_type rank(const key_type &k) const { return _m_tree.rank(k); }
+
+  /**
+   * @brief Returns an iterator to the element at index n (0-based, in key order) in O(log n)
+   * @param n
+   * @return end() if n >= size()
+   */
+  iterator select(size_type n) { return _m_tree.select(n); }
+  const_iterator select(size_type n) const { return _m_tree.select(n); }
+
+  /**
+   * @brief Returns the number of elements whose key is in [lo, hi) in O(log n)
+   */
+  size_type count_range(const key_type &lo, const key_type &hi) const { return _m_tree.count_range(lo, hi); }
+
+  template<class Key1, class T1, class Compare1, class Alloc1, class Tag1>
+  friend bool operator==(const map<Key1, T1, Compare1, Alloc1, Tag1> &lhs,
+                         const map<Key1, T1, Compare1, Alloc1, Tag1> &rhs);
 
-  template<class Key1, class T1, class Compare1, class Alloc1>
-  friend bool operator<(const map<Key1, T1, Compare1, Alloc1> &lhs,
-                        const map<Key1, T1, Compare1, Alloc1> &rhs);
+  template<class Key1, class T1, class Compare1, class Alloc1, class Tag1>
+  friend bool operator<(const map<Key1, T1, Compare1, Alloc1, Tag1> &lhs,
+                        const map<Key1, T1, Compare1, Alloc1, Tag1> &rhs);
 };
 
-template<class Key, class T, class Compare, class Alloc>
-bool operator==(const map<Key, T, Compare, Alloc> &lhs,
-                const map<Key, T, Compare, Alloc> &rhs) {
+template<class Key, class T, class Compare, class Alloc, class Tag>
+bool operator==(const map<Key, T, Compare, Alloc, Tag> &lhs,
+                const map<Key, T, Compare, Alloc, Tag> &rhs) {
   return lhs._m_tree == rhs._m_tree;
 }
 
-template<class Key, class T, class Compare, class Alloc>
-bool operator!=(const map<Key, T, Compare, Alloc> &lhs,
-                const map<Key, T, Compare, Alloc> &rhs) {
+template<class Key, class T, class Compare, class Alloc, class Tag>
+bool operator!=(const map<Key, T, Compare, Alloc, Tag> &lhs,
+                const map<Key, T, Compare, Alloc, Tag> &rhs) {
   return !(lhs == rhs);
 }
 
-template<class Key, class T, class Compare, class Alloc>
-bool operator<(const map<Key, T, Compare, Alloc> &lhs,
-               const map<Key, T, Compare, Alloc> &rhs) {
+template<class Key, class T, class Compare, class Alloc, class Tag>
+bool operator<(const map<Key, T, Compare, Alloc, Tag> &lhs,
+               const map<Key, T, Compare, Alloc, Tag> &rhs) {
   return lhs._m_tree < rhs._m_tree;
 }
 
-template<class Key, class T, class Compare, class Alloc>
-bool operator<=(const map<Key, T, Compare, Alloc> &lhs,
-                const map<Key, T, Compare, Alloc> &rhs) {
+template<class Key, class T, class Compare, class Alloc, class Tag>
+bool operator<=(const map<Key, T, Compare, Alloc, Tag> &lhs,
+                const map<Key, T, Compare, Alloc, Tag> &rhs) {
   return !(rhs < lhs);
 }
 
-template<class Key, class T, class Compare, class Alloc>
-bool operator>(const map<Key, T, Compare, Alloc> &lhs,
-               const map<Key, T, Compare, Alloc> &rhs) {
+template<class Key, class T, class Compare, class Alloc, class Tag>
+bool operator>(const map<Key, T, Compare, Alloc, Tag> &lhs,
+               const map<Key, T, Compare, Alloc, Tag> &rhs) {
   return (rhs < lhs);
 }
 
-template<class Key, class T, class Compare, class Alloc>
-bool operator>=(const map<Key, T, Compare, Alloc> &lhs,
-                const map<Key, T, Compare, Alloc> &rhs) {
+template<class Key, class T, class Compare, class Alloc, class Tag>
+bool operator>=(const map<Key, T, Compare, Alloc, Tag> &lhs,
+                const map<Key, T, Compare, Alloc, Tag> &rhs) {
   return !(lhs < rhs);
 }
 
 // swap
-template<class Key, class T, class Compare, class Alloc>
-void swap(map<Key, T, Compare, Alloc> &x, map<Key, T, Compare, Alloc> &y) {
+template<class Key, class T, class Compare, class Alloc, class Tag>
+void swap(map<Key, T, Compare, Alloc, Tag> &x, map<Key, T, Compare, Alloc, Tag> &y) {
   x.swap(y);
 }
 
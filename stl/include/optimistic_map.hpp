@@ -0,0 +1,252 @@
+/*
+ * File: optimistic_map.hpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#ifndef OPTIMISTIC_MAP_HPP_
+#define OPTIMISTIC_MAP_HPP_
+
+#include <pthread.h>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include "pair.hpp"
+#include "function.hpp"
+#include "pool_allocator.hpp"
+#include "tree.hpp"
+
+namespace ft {
+
+/**
+ * @brief pool_allocator whose construct writes the element with relaxed atomic stores
+ *
+ * optimistic_map 의 reader 는 writer 가 다시 쓰고 있는 (재사용된) 노드의 원소를 읽을 수 있으므로
+ * 원소를 쓰는 쪽도 _rb_tree_atomic_copy 로 써야 race 가 정의된 동작이 된다. T 는 trivially copyable 이어야 한다.
+ */
+template<class T>
+class _optimistic_allocator : public pool_allocator<T> {
+ public:
+  template<class U>
+  struct rebind { typedef _optimistic_allocator<U> other; };
+
+  _optimistic_allocator() throw() {}
+  _optimistic_allocator(const _optimistic_allocator &x) : pool_allocator<T>(x) {}
+  template<class U>
+  _optimistic_allocator(const _optimistic_allocator<U> &x) throw(): pool_allocator<T>(x) {}
+
+  void construct(T *p, const T &val) { _rb_tree_atomic_copy(p, &val, sizeof(T)); }
+  template<class A, class B>
+  void construct(T *p, const A &a, const B &b) { construct(p, T(a, b)); }
+};
+
+template<class T>
+struct is_pool_allocator<_optimistic_allocator<T> > : public true_type {};
+
+template<class T>
+struct has_optimistic_readers<_optimistic_allocator<T> > : public true_type {};
+
+/**
+ * @brief red-black map whose readers take no lock : they read optimistically and validate against a version
+ *
+ * writer 는 mutex 를 잡고 version 을 홀수로 만든 뒤 트리를 바꾸고 다시 짝수로 만든다 (seqlock).
+ * reader 는 version 을 읽고, 트리를 내려가 원소를 복사한 뒤 version 이 그대로면 그 결과를 쓰고 아니면 다시 읽는다.
+ * reader 는 공유 메모리에 아무것도 쓰지 않으므로 core 수만큼 읽기가 늘어난다.
+ *
+ * writer 와 겹친 reader 는 바뀌는 중인 노드나 방금 지워진 노드를 읽을 수 있다. 그래서
+ *  - 노드는 pool_allocator 에서 받아 map 이 없어질 때까지 메모리를 돌려주지 않고,
+ *  - Key 와 T 는 아무렇게나 섞여 읽혀도 안전한 (trivially copyable) 타입만 받으며,
+ *  - 내려가는 길이는 트리 높이의 한계로 자른다 (_rb_tree::_m_optimistic_bound).
+ * reader 가 읽는 word (root, _m_left / _m_right, 원소, 크기) 는 양쪽 모두 relaxed atomic 으로 접근하므로
+ * 겹친 읽기는 data race 가 아니라 version 검증으로 버려지는 값일 뿐이다.
+ * 여러 번 실패하면 (writer 가 계속 쓰는 중) writer 의 mutex 를 잡고 읽는다.
+ */
+template<class Key, class T, class Compare = std::less<Key> >
+class optimistic_map {
+ public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef pair<const Key, T> value_type;
+  typedef Compare key_compare;
+  typedef size_t size_type;
+
+ private:
+  typedef _rb_tree<key_type, value_type, Select1st<value_type>, key_compare, _optimistic_allocator<value_type> > rep_type;
+  typedef typename rep_type::const_iterator _const_iterator;
+
+  // a torn copy of a key or a value must be harmless (no pointer it owns, nothing to destroy)
+  typedef char _s_requires_trivial_types[(__has_trivial_copy(Key) && __has_trivial_destructor(Key)
+      && __has_trivial_copy(T) && __has_trivial_destructor(T)) ? 1 : -1];
+
+  enum { _s_optimistic_attempts = 64 };
+  enum _bound { _s_find, _s_lower, _s_upper };
+
+  rep_type _m_tree;
+  mutable pthread_mutex_t _m_write_lock;
+  size_t _m_version;  // odd while a writer is changing the tree
+  size_t _m_size;     // _m_tree.size() as published by the last writer
+
+  optimistic_map(const optimistic_map &);
+  optimistic_map &operator=(const optimistic_map &);
+
+  /**
+   * @brief writers hold the mutex and keep the version odd for as long as they change the tree
+   */
+  class _write_section {
+    optimistic_map *_m_map;
+    _write_section(const _write_section &);
+    _write_section &operator=(const _write_section &);
+   public:
+    explicit _write_section(optimistic_map *m) : _m_map(m) {
+      pthread_mutex_lock(&_m_map->_m_write_lock);
+      __atomic_store_n(&_m_map->_m_version, _m_map->_m_version + 1, __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+    ~_write_section() {
+      __atomic_store_n(&_m_map->_m_size, _m_map->_m_tree.size(), __ATOMIC_RELAXED);
+      __atomic_store_n(&_m_map->_m_version, _m_map->_m_version + 1, __ATOMIC_RELEASE);
+      pthread_mutex_unlock(&_m_map->_m_write_lock);
+    }
+  };
+
+  static void _s_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+  }
+
+  // the copy taken since version v is valid if no writer started in between
+  bool _m_validate(size_t v) const {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&_m_version, __ATOMIC_RELAXED) == v;
+  }
+
+  // raw room for a copy of an element : value_type may have no default constructor
+  struct _storage {
+    char _m_bytes[sizeof(value_type)] __attribute__((aligned(__alignof__(value_type))));
+
+    value_type *_m_get() { return static_cast<value_type *>(static_cast<void *>(_m_bytes)); }
+  };
+
+  /**
+   * @brief copies the element bound (k) points to into out, false for end() or a miss of find
+   */
+  bool _m_read(const key_type &k, _bound bound, _storage &out) const {
+    for (unsigned i = 0; i < _s_optimistic_attempts; ++i) {
+      size_t _v = __atomic_load_n(&_m_version, __ATOMIC_ACQUIRE);
+      if (_v & 1) {
+        _s_relax();
+        continue;
+      }
+      _const_iterator _it;
+      if (!_m_tree._m_optimistic_bound(k, bound == _s_upper, _it))
+        continue;
+      // _it may be a node being changed or even freed (its block stays in the pool) : copy, then check
+      bool _found = _it != _m_tree.end();
+      if (_found)
+        _rb_tree_atomic_copy(out._m_bytes, &*_it, sizeof(value_type));
+      if (!_m_validate(_v))
+        continue;
+      return _found && !(bound == _s_find && _m_tree.key_comp()(k, out._m_get()->first));
+    }
+    // a writer kept the version moving : read under its lock
+    pthread_mutex_lock(&_m_write_lock);
+    _const_iterator _it = bound == _s_upper ? _m_tree.upper_bound(k) : _m_tree.lower_bound(k);
+    bool _found = _it != _m_tree.end() && !(bound == _s_find && _m_tree.key_comp()(k, _it->first));
+    if (_found)
+      new(out._m_bytes) value_type(*_it);
+    pthread_mutex_unlock(&_m_write_lock);
+    return _found;
+  }
+
+  bool _m_bound(const key_type &k, _bound bound, pair<key_type, mapped_type> &out) const {
+    _storage _val = _storage();
+    if (!_m_read(k, bound, _val))
+      return false;
+    out.first = _val._m_get()->first;
+    out.second = _val._m_get()->second;
+    return true;
+  }
+
+ public:
+  explicit optimistic_map(const Compare &comp = Compare()) : _m_tree(comp), _m_version(0), _m_size(0) {
+    pthread_mutex_init(&_m_write_lock, 0);
+  }
+
+  ~optimistic_map() { pthread_mutex_destroy(&_m_write_lock); }
+
+  key_compare key_comp() const { return _m_tree.key_comp(); }
+
+  size_type size() const { return __atomic_load_n(&_m_size, __ATOMIC_RELAXED); }
+
+  bool empty() const { return size() == 0; }
+
+  /* ****************************************************** */
+  /*                 Lookup (no lock)                       */
+  /* ****************************************************** */
+
+  /**
+   * @brief copies the value of k into out, returns false (out untouched) if there is none
+   */
+  bool find(const key_type &k, mapped_type &out) const {
+    _storage _val = _storage();
+    if (!_m_read(k, _s_find, _val))
+      return false;
+    out = _val._m_get()->second;
+    return true;
+  }
+
+  size_type count(const key_type &k) const {
+    _storage _val = _storage();
+    return _m_read(k, _s_find, _val);
+  }
+
+  /**
+   * @brief copies the first element whose key is not less than k into out, false if there is none
+   */
+  bool lower_bound(const key_type &k, pair<key_type, mapped_type> &out) const {
+    return _m_bound(k, _s_lower, out);
+  }
+
+  /**
+   * @brief copies the first element whose key is greater than k into out, false if there is none
+   */
+  bool upper_bound(const key_type &k, pair<key_type, mapped_type> &out) const {
+    return _m_bound(k, _s_upper, out);
+  }
+
+  /* ****************************************************** */
+  /*                 Modifiers (one writer)                 */
+  /* ****************************************************** */
+
+  bool insert(const value_type &val) {
+    _write_section _section(this);
+    return _m_tree.insert_unique(val).second;
+  }
+
+  /**
+   * @brief sets the value of k to obj, returns true if k was inserted
+   */
+  bool insert_or_assign(const key_type &k, const mapped_type &obj) {
+    _write_section _section(this);
+    pair<typename rep_type::iterator, bool> _r = _m_tree.try_emplace_unique(k, obj);
+    if (!_r.second)
+      _rb_tree_atomic_copy(&_r.first->second, &obj, sizeof(mapped_type));
+    return _r.second;
+  }
+
+  size_type erase(const key_type &k) {
+    _write_section _section(this);
+    return _m_tree.erase(k);
+  }
+
+  void clear() {
+    _write_section _section(this);
+    _m_tree.clear();
+  }
+};
+}
+
+#endif //OPTIMISTIC_MAP_HPP_
@@ -10,6 +10,11 @@
 #define PAIR_HPP_
 
 namespace ft {
+/**
+ * @brief tag of pair(a, _value_init_t()) : second is value-initialized in place, no temporary second_type
+ */
+struct _value_init_t {};
+
 /**
  * @brief This class couples together a pair of values, which may be of different types (T1 and T2). The individual values can be accessed through its public members first and second.
  * @tparam T1 first element
@@ -32,6 +37,8 @@ struct pair {
 
   pair(const first_type &a, const second_type &b) : first(a), second(b) {}
 
+  pair(const first_type &a, _value_init_t) : first(a), second() {}
+
   pair &operator=(const pair &pr) {
     first = pr.first;
     second = pr.second;
@@ -0,0 +1,625 @@
+/*
+ * File: persistent_map.hpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#ifndef PERSISTENT_MAP_HPP_
+#define PERSISTENT_MAP_HPP_
+
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include "pair.hpp"
+#include "algorithm.hpp"
+#include "function.hpp"
+#include "tree.hpp"
+
+namespace ft {
+
+/**
+ * @brief red-black node shared by several versions of a persistent_map
+ *
+ * 여러 부모가 같은 노드를 가리킬 수 있으므로 parent link 가 없다.
+ * _m_refs 는 이 노드를 가리키는 부모와 map 의 수이고, 여러 thread 가 같은 snapshot 을 복사할 수 있도록 atomic 하게 바꾼다.
+ * 한 번 만들어진 노드는 바뀌지 않는다 (refs 제외).
+ */
+template<class Val>
+struct _persistent_node {
+  _persistent_node *_m_left;
+  _persistent_node *_m_right;
+  size_t _m_refs;
+  _rb_tree_color _m_color;
+  Val _m_value_field;
+};
+
+// height of a red-black tree is at most 2 * log2(n + 1)
+enum { _s_persistent_max_height = 2 * sizeof(size_t) * CHAR_BIT };
+
+/**
+ * @brief iterator of persistent_map : keeps the path from the root because the nodes have no parent
+ *
+ * 원소는 바꿀 수 없으므로 iterator 와 const_iterator 가 같다.
+ * iterator 는 노드의 refs 를 올리지 않으므로 그 원소를 가진 version (persistent_map) 이 살아있는 동안만 쓸 수 있다.
+ */
+template<class Val>
+class _persistent_map_iterator {
+  typedef const _persistent_node<Val> *_node_ptr;
+
+ public:
+  typedef std::bidirectional_iterator_tag iterator_category;
+  typedef Val value_type;
+  typedef ptrdiff_t difference_type;
+  typedef const Val *pointer;
+  typedef const Val &reference;
+
+  _persistent_map_iterator() : _m_root(0), _m_depth(0) {}
+  explicit _persistent_map_iterator(_node_ptr root) : _m_root(root), _m_depth(0) {}
+
+  reference operator*() const { return _m_path[_m_depth - 1]->_m_value_field; }
+  pointer operator->() const { return &(operator*()); }
+
+  _persistent_map_iterator &operator++() {
+    _node_ptr _x = _m_path[_m_depth - 1];
+    if (_x->_m_right) {
+      _m_push_leftmost(_x->_m_right);
+      return *this;
+    }
+    // climb while coming from a right child
+    do {
+      _x = _m_path[--_m_depth];
+    } while (_m_depth != 0 && _m_path[_m_depth - 1]->_m_right == _x);
+    return *this;
+  }
+
+  _persistent_map_iterator operator++(int) {
+    _persistent_map_iterator _tmp = *this;
+    ++*this;
+    return _tmp;
+  }
+
+  // --end() is the last element
+  _persistent_map_iterator &operator--() {
+    if (_m_depth == 0) {
+      _m_push_rightmost(_m_root);
+      return *this;
+    }
+    _node_ptr _x = _m_path[_m_depth - 1];
+    if (_x->_m_left) {
+      _m_push_rightmost(_x->_m_left);
+      return *this;
+    }
+    do {
+      _x = _m_path[--_m_depth];
+    } while (_m_depth != 0 && _m_path[_m_depth - 1]->_m_left == _x);
+    return *this;
+  }
+
+  _persistent_map_iterator operator--(int) {
+    _persistent_map_iterator _tmp = *this;
+    --*this;
+    return _tmp;
+  }
+
+  friend bool operator==(const _persistent_map_iterator &x, const _persistent_map_iterator &y) {
+    if (x._m_depth == 0 || y._m_depth == 0)
+      return x._m_depth == y._m_depth;
+    return x._m_path[x._m_depth - 1] == y._m_path[y._m_depth - 1];
+  }
+
+  friend bool operator!=(const _persistent_map_iterator &x, const _persistent_map_iterator &y) {
+    return !(x == y);
+  }
+
+  void _m_push(_node_ptr x) { _m_path[_m_depth++] = x; }
+
+  void _m_push_leftmost(_node_ptr x) {
+    for (; x != 0; x = x->_m_left)
+      _m_push(x);
+  }
+
+  void _m_push_rightmost(_node_ptr x) {
+    for (; x != 0; x = x->_m_right)
+      _m_push(x);
+  }
+
+  size_t _m_get_depth() const { return _m_depth; }
+  void _m_truncate(size_t depth) { _m_depth = depth; }
+
+ private:
+  _node_ptr _m_root;
+  size_t _m_depth; // 0 : end()
+  _node_ptr _m_path[_s_persistent_max_height];
+};
+
+/**
+ * @brief immutable, structurally shared map : copies are O(1) snapshots, updates copy only the search path
+ * @tparam Key key
+ * @tparam T mapped type
+ * @tparam Compare key_compare type (functor class)
+ * @tparam Alloc allocator type
+ *
+ * ex) ft::persistent_map<std::string, route> next = current; next.set(k, r); publish(next);
+ * insert / set / erase 는 이 version 만 바꾸고, 전에 복사한 version (snapshot) 들은 그대로 남는다.
+ * 바뀐 경로의 O(log n) 노드만 새로 만들고 나머지는 공유하므로 메모리는 map 크기가 아니라 변경 수에 비례해서 는다.
+ * 노드는 reference count 로 해제되며, 마지막 version 이 놓는 순간 해제된다.
+ *
+ * 한 persistent_map 객체를 여러 thread 가 동시에 바꾸면 안 되지만, 바뀌지 않는 snapshot 은
+ * 여러 thread 가 동시에 읽고 복사해도 된다 (복사는 root 의 refs 를 atomic 하게 올리는 것뿐이다).
+ * 삽입과 삭제는 Kahrs 의 함수형 red-black tree 로 구현되어 있다 (S. Kahrs, "Red-black trees with types", 2001).
+ */
+template<class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::pair<const Key, T> > >
+class persistent_map {
+ public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef pair<const Key, T> value_type;
+  typedef Compare key_compare;
+  typedef Alloc allocator_type;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef const value_type &reference;
+  typedef const value_type &const_reference;
+  typedef _persistent_map_iterator<value_type> iterator;
+  typedef iterator const_iterator;
+
+ private:
+  typedef _persistent_node<value_type> _node;
+  typedef typename Alloc::template rebind<_node>::other _node_allocator;
+
+  /**
+   * @brief counted reference to a node (0 is the empty tree)
+   *
+   * 갱신 중에 만든 노드는 모두 _ref 가 들고 있으므로 예외가 나면 자동으로 해제되고, 원래 version 은 바뀌지 않는다.
+   * left() / right() 는 count 를 올리지 않고 빌려온다 (borrowed) : 부모가 갱신이 끝날 때까지 살아있기 때문이다.
+   * 빌려온 _ref 를 복사해도 빌려온 것이고, 새로 만든 노드가 가리키거나 root 가 될 때만 count 가 올라간다.
+   */
+  class _ref {
+   public:
+    _ref(_node *x, _node_allocator *alloc, bool owned = true) : _m_node(x), _m_alloc(alloc), _m_owned(owned) {
+      if (_m_owned)
+        _s_acquire(x);
+    }
+    _ref(const _ref &x) : _m_node(x._m_node), _m_alloc(x._m_alloc), _m_owned(x._m_owned) {
+      if (_m_owned)
+        _s_acquire(_m_node);
+    }
+    ~_ref() {
+      if (_m_owned)
+        _s_release(_m_alloc, _m_node);
+    }
+
+    _ref &operator=(const _ref &x) {
+      if (x._m_owned)
+        _s_acquire(x._m_node);
+      if (_m_owned)
+        _s_release(_m_alloc, _m_node);
+      _m_node = x._m_node;
+      _m_alloc = x._m_alloc;
+      _m_owned = x._m_owned;
+      return *this;
+    }
+
+    _node *operator->() const { return _m_node; }
+    _node *get() const { return _m_node; }
+
+    _ref left() const { return _ref(_m_node->_m_left, _m_alloc, false); }
+    _ref right() const { return _ref(_m_node->_m_right, _m_alloc, false); }
+
+    bool red() const { return _m_node != 0 && _m_node->_m_color == _s_red; }
+    bool black_node() const { return _m_node != 0 && _m_node->_m_color == _s_black; }
+
+    // hand a count over to the caller (persistent_map::_m_root)
+    _node *release() {
+      if (!_m_owned)
+        _s_acquire(_m_node);
+      _node *_x = _m_node;
+      _m_node = 0;
+      return _x;
+    }
+
+   private:
+    _node *_m_node;
+    _node_allocator *_m_alloc;
+    bool _m_owned;
+  };
+
+  _node_allocator _m_alloc;
+  key_compare _m_key_compare;
+  _node *_m_root;
+  size_type _m_size;
+
+  static void _s_acquire(_node *x) {
+    if (x)
+      __sync_add_and_fetch(&x->_m_refs, 1);
+  }
+
+  // free x when the last reference goes, children are released the same way (depth <= tree height)
+  static void _s_release(_node_allocator *alloc, _node *x) {
+    while (x != 0 && __sync_sub_and_fetch(&x->_m_refs, 1) == 0) {
+      _node *_left = x->_m_left;
+      _node *_right = x->_m_right;
+      x->_m_value_field.~value_type();
+      alloc->deallocate(x, 1);
+      _s_release(alloc, _left);
+      x = _right;
+    }
+  }
+
+  _ref _m_empty() { return _ref(0, &_m_alloc, false); }
+  // the tree being updated, alive until _m_set_root
+  _ref _m_top() { return _ref(_m_root, &_m_alloc, false); }
+
+  // new node (color, l, v, r), the only place where nodes are allocated
+  _ref _m_make(_rb_tree_color color, const _ref &l, const value_type &v, const _ref &r) {
+    _node *_x = _m_alloc.allocate(1);
+    try {
+      ::new(static_cast<void *>(&_x->_m_value_field)) value_type(v);
+    } catch (...) {
+      _m_alloc.deallocate(_x, 1);
+      throw;
+    }
+    _x->_m_color = color;
+    _x->_m_refs = 0;
+    _x->_m_left = l.get();
+    _x->_m_right = r.get();
+    _s_acquire(_x->_m_left);
+    _s_acquire(_x->_m_right);
+    return _ref(_x, &_m_alloc);
+  }
+
+  _ref _m_recolor(const _ref &x, _rb_tree_color color) {
+    if (x->_m_color == color)
+      return x;
+    return _m_make(color, x.left(), x->_m_value_field, x.right());
+  }
+
+  const key_type &_s_key(const _node *x) const { return x->_m_value_field.first; }
+  bool _m_less(const key_type &a, const key_type &b) const { return _m_key_compare(a, b); }
+
+  /* ****************************************************** */
+  /*          Kahrs' red-black tree (path copying)          */
+  /* ****************************************************** */
+
+  // black node over l, v, r, turning a red-red pair below it into a red node with two black children
+  _ref _m_balance(const _ref &l, const value_type &v, const _ref &r) {
+    if (l.red() && r.red())
+      return _m_make(_s_red, _m_recolor(l, _s_black), v, _m_recolor(r, _s_black));
+    if (l.red()) {
+      _ref _ll = l.left();
+      _ref _lr = l.right();
+      if (_ll.red())
+        return _m_make(_s_red, _m_recolor(_ll, _s_black), l->_m_value_field,
+                       _m_make(_s_black, _lr, v, r));
+      if (_lr.red())
+        return _m_make(_s_red, _m_make(_s_black, _ll, l->_m_value_field, _lr.left()), _lr->_m_value_field,
+                       _m_make(_s_black, _lr.right(), v, r));
+    }
+    if (r.red()) {
+      _ref _rl = r.left();
+      _ref _rr = r.right();
+      if (_rr.red())
+        return _m_make(_s_red, _m_make(_s_black, l, v, _rl), r->_m_value_field,
+                       _m_recolor(_rr, _s_black));
+      if (_rl.red())
+        return _m_make(_s_red, _m_make(_s_black, l, v, _rl.left()), _rl->_m_value_field,
+                       _m_make(_s_black, _rl.right(), r->_m_value_field, _rr));
+    }
+    return _m_make(_s_black, l, v, r);
+  }
+
+  // insert v under t (or replace the element with the same key when assign), the root may come back red
+  _ref _m_ins(const _ref &t, const value_type &v, bool assign) {
+    if (t.get() == 0)
+      return _m_make(_s_red, _m_empty(), v, _m_empty());
+    if (_m_less(v.first, _s_key(t.get()))) {
+      if (t->_m_color == _s_black)
+        return _m_balance(_m_ins(t.left(), v, assign), t->_m_value_field, t.right());
+      return _m_make(_s_red, _m_ins(t.left(), v, assign), t->_m_value_field, t.right());
+    }
+    if (_m_less(_s_key(t.get()), v.first)) {
+      if (t->_m_color == _s_black)
+        return _m_balance(t.left(), t->_m_value_field, _m_ins(t.right(), v, assign));
+      return _m_make(_s_red, t.left(), t->_m_value_field, _m_ins(t.right(), v, assign));
+    }
+    if (!assign)
+      return t;
+    return _m_make(t->_m_color, t.left(), v, t.right());
+  }
+
+  // black node of a black height one less, only called on black nodes
+  _ref _m_sub1(const _ref &t) { return _m_recolor(t, _s_red); }
+
+  // the left subtree l lost one black level
+  _ref _m_balance_left(const _ref &l, const value_type &v, const _ref &r) {
+    if (l.red())
+      return _m_make(_s_red, _m_recolor(l, _s_black), v, r);
+    if (r.black_node())
+      return _m_balance(l, v, _m_recolor(r, _s_red));
+    // r is red with a black left child
+    _ref _rl = r.left();
+    return _m_make(_s_red, _m_make(_s_black, l, v, _rl.left()), _rl->_m_value_field,
+                   _m_balance(_rl.right(), r->_m_value_field, _m_sub1(r.right())));
+  }
+
+  // the right subtree r lost one black level
+  _ref _m_balance_right(const _ref &l, const value_type &v, const _ref &r) {
+    if (r.red())
+      return _m_make(_s_red, l, v, _m_recolor(r, _s_black));
+    if (l.black_node())
+      return _m_balance(_m_recolor(l, _s_red), v, r);
+    // l is red with a black right child
+    _ref _lr = l.right();
+    return _m_make(_s_red, _m_balance(_m_sub1(l.left()), l->_m_value_field, _lr.left()), _lr->_m_value_field,
+                   _m_make(_s_black, _lr.right(), v, r));
+  }
+
+  // join two subtrees of the same black height, every key of l goes before every key of r
+  _ref _m_append(const _ref &l, const _ref &r) {
+    if (l.get() == 0)
+      return r;
+    if (r.get() == 0)
+      return l;
+    if (l.red() && r.red()) {
+      _ref _m = _m_append(l.right(), r.left());
+      if (_m.red())
+        return _m_make(_s_red, _m_make(_s_red, l.left(), l->_m_value_field, _m.left()), _m->_m_value_field,
+                       _m_make(_s_red, _m.right(), r->_m_value_field, r.right()));
+      return _m_make(_s_red, l.left(), l->_m_value_field, _m_make(_s_red, _m, r->_m_value_field, r.right()));
+    }
+    if (!l.red() && !r.red()) {
+      _ref _m = _m_append(l.right(), r.left());
+      if (_m.red())
+        return _m_make(_s_red, _m_make(_s_black, l.left(), l->_m_value_field, _m.left()), _m->_m_value_field,
+                       _m_make(_s_black, _m.right(), r->_m_value_field, r.right()));
+      return _m_balance_left(l.left(), l->_m_value_field, _m_make(_s_black, _m, r->_m_value_field, r.right()));
+    }
+    if (r.red())
+      return _m_make(_s_red, _m_append(l, r.left()), r->_m_value_field, r.right());
+    return _m_make(_s_red, l.left(), l->_m_value_field, _m_append(l.right(), r));
+  }
+
+  // remove k (which must be in t) from t
+  _ref _m_del(const _ref &t, const key_type &k) {
+    if (_m_less(k, _s_key(t.get()))) {
+      _ref _l = t.left();
+      if (_l.black_node())
+        return _m_balance_left(_m_del(_l, k), t->_m_value_field, t.right());
+      return _m_make(_s_red, _m_del(_l, k), t->_m_value_field, t.right());
+    }
+    if (_m_less(_s_key(t.get()), k)) {
+      _ref _r = t.right();
+      if (_r.black_node())
+        return _m_balance_right(t.left(), t->_m_value_field, _m_del(_r, k));
+      return _m_make(_s_red, t.left(), t->_m_value_field, _m_del(_r, k));
+    }
+    return _m_append(t.left(), t.right());
+  }
+
+  // the new root is black, then it replaces the old one (whose nodes go if no other version has them)
+  void _m_set_root(_ref root) {
+    if (root.red())
+      root = _m_recolor(root, _s_black);
+    _node *_old = _m_root;
+    _m_root = root.release();
+    _s_release(&_m_alloc, _old);
+  }
+
+  const _node *_m_find_node(const key_type &k) const {
+    const _node *_x = _m_root;
+    while (_x != 0) {
+      if (_m_less(k, _s_key(_x)))
+        _x = _x->_m_left;
+      else if (_m_less(_s_key(_x), k))
+        _x = _x->_m_right;
+      else
+        return _x;
+    }
+    return 0;
+  }
+
+  // upper : first key > k instead of >= k
+  iterator _m_bound(const key_type &k, bool upper) const {
+    iterator _it(_m_root);
+    size_t _found = 0; // path length up to the answer, 0 : end()
+    for (const _node *_x = _m_root; _x != 0;) {
+      _it._m_push(_x);
+      if (upper ? _m_less(k, _s_key(_x)) : !_m_less(_s_key(_x), k)) {
+        _found = _it._m_get_depth();
+        _x = _x->_m_left;
+      } else {
+        _x = _x->_m_right;
+      }
+    }
+    _it._m_truncate(_found);
+    return _it;
+  }
+
+ public:
+  explicit persistent_map(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type())
+      : _m_alloc(alloc), _m_key_compare(comp), _m_root(0), _m_size(0) {}
+
+  template<class InputIterator>
+  persistent_map(InputIterator first, InputIterator last,
+                 const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type())
+      : _m_alloc(alloc), _m_key_compare(comp), _m_root(0), _m_size(0) {
+    insert(first, last);
+  }
+
+  // O(1) : shares every node with x
+  persistent_map(const persistent_map &x)
+      : _m_alloc(x._m_alloc), _m_key_compare(x._m_key_compare), _m_root(x._m_root), _m_size(x._m_size) {
+    _s_acquire(_m_root);
+  }
+
+  ~persistent_map() { _s_release(&_m_alloc, _m_root); }
+
+  persistent_map &operator=(const persistent_map &x) {
+    persistent_map _tmp(x);
+    swap(_tmp);
+    return *this;
+  }
+
+  /**
+   * @brief O(1) copy of this version, later updates of either map do not show in the other
+   */
+  persistent_map snapshot() const { return *this; }
+
+  void swap(persistent_map &x) {
+    ft::swap(_m_alloc, x._m_alloc);
+    ft::swap(_m_key_compare, x._m_key_compare);
+    ft::swap(_m_root, x._m_root);
+    ft::swap(_m_size, x._m_size);
+  }
+
+  allocator_type get_allocator() const { return allocator_type(_m_alloc); }
+  key_compare key_comp() const { return _m_key_compare; }
+
+  size_type size() const { return _m_size; }
+  bool empty() const { return _m_size == 0; }
+
+  iterator begin() const {
+    iterator _it(_m_root);
+    _it._m_push_leftmost(_m_root);
+    return _it;
+  }
+
+  iterator end() const { return iterator(_m_root); }
+
+  iterator find(const key_type &k) const {
+    iterator _it = lower_bound(k);
+    return (_it == end() || _m_less(k, _it->first)) ? end() : _it;
+  }
+
+  iterator lower_bound(const key_type &k) const { return _m_bound(k, false); }
+  iterator upper_bound(const key_type &k) const { return _m_bound(k, true); }
+
+  pair<iterator, iterator> equal_range(const key_type &k) const {
+    return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+  }
+
+  size_type count(const key_type &k) const { return _m_find_node(k) != 0; }
+
+  /**
+   * @brief pointer to the value mapped to k, 0 if there is none (no iterator is built)
+   */
+  const mapped_type *get(const key_type &k) const {
+    const _node *_x = _m_find_node(k);
+    return _x ? &_x->_m_value_field.second : 0;
+  }
+
+  /**
+   * @brief Returns the value mapped to k
+   * @exception std::out_of_range if k is not in the map
+   */
+  const mapped_type &at(const key_type &k) const {
+    const mapped_type *_v = get(k);
+    if (_v == 0)
+      throw std::out_of_range("ft::persistent_map::at");
+    return *_v;
+  }
+
+  /**
+   * @brief insert val if its key is not there yet
+   * @return true if inserted, nothing is copied otherwise
+   */
+  bool insert(const value_type &val) {
+    if (_m_find_node(val.first))
+      return false;
+    _m_set_root(_m_ins(_m_top(), val, false));
+    ++_m_size;
+    return true;
+  }
+
+  template<class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  /**
+   * @brief map k to obj, inserting or replacing (insert_or_assign)
+   * @return true if k was not in the map
+   */
+  bool set(const key_type &k, const mapped_type &obj) {
+    bool _inserted = _m_find_node(k) == 0;
+    _m_set_root(_m_ins(_m_top(), value_type(k, obj), true));
+    if (_inserted)
+      ++_m_size;
+    return _inserted;
+  }
+
+  // @return number of erased elements (0 or 1)
+  size_type erase(const key_type &k) {
+    if (_m_find_node(k) == 0)
+      return 0;
+    _m_set_root(_m_del(_m_top(), k));
+    --_m_size;
+    return 1;
+  }
+
+  void clear() {
+    _s_release(&_m_alloc, _m_root);
+    _m_root = 0;
+    _m_size = 0;
+  }
+
+  // true if both versions are the same tree (a snapshot that has not been changed since)
+  bool shares_root(const persistent_map &x) const { return _m_root == x._m_root; }
+
+  /**
+   * @brief check red-black properties, order and size (for tests, O(n))
+   */
+  bool _m_verify() const {
+    if (_m_root && _m_root->_m_color != _s_black)
+      return false;
+    size_type _n = 0;
+    return _m_black_height(_m_root, 0, 0, _n) >= 0 && _n == _m_size;
+  }
+
+ private:
+  // -1 on a violation
+  int _m_black_height(const _node *x, const key_type *lo, const key_type *hi, size_type &n) const {
+    if (x == 0)
+      return 0;
+    ++n;
+    if ((lo && !_m_less(*lo, _s_key(x))) || (hi && !_m_less(_s_key(x), *hi)) || x->_m_refs == 0)
+      return -1;
+    if (x->_m_color == _s_red && ((x->_m_left && x->_m_left->_m_color == _s_red)
+        || (x->_m_right && x->_m_right->_m_color == _s_red)))
+      return -1;
+    int _l = _m_black_height(x->_m_left, lo, &_s_key(x), n);
+    int _r = _m_black_height(x->_m_right, &_s_key(x), hi, n);
+    if (_l < 0 || _l != _r)
+      return -1;
+    return _l + (x->_m_color == _s_black);
+  }
+};
+
+template<class Key, class T, class Compare, class Alloc>
+bool operator==(const persistent_map<Key, T, Compare, Alloc> &lhs, const persistent_map<Key, T, Compare, Alloc> &rhs) {
+  if (lhs.size() != rhs.size())
+    return false;
+  if (lhs.shares_root(rhs))
+    return true;
+  return ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<class Key, class T, class Compare, class Alloc>
+bool operator!=(const persistent_map<Key, T, Compare, Alloc> &lhs, const persistent_map<Key, T, Compare, Alloc> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<class Key, class T, class Compare, class Alloc>
+void swap(persistent_map<Key, T, Compare, Alloc> &x, persistent_map<Key, T, Compare, Alloc> &y) {
+  x.swap(y);
+}
+
+} // namespace ft
+
+#endif //PERSISTENT_MAP_HPP_
@@ -0,0 +1,250 @@
+/*
+ * File: pool_allocator.hpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#ifndef POOL_ALLOCATOR_HPP_
+#define POOL_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <new>
+#include "type_traits.hpp"
+
+namespace ft {
+
+/**
+ * @brief Fixed size block pool that hands out blocks of sizeof(T) from chunked slabs
+ * @tparam T block type
+ *
+ * 블록은 free-list 에서 먼저 꺼내고, 없으면 현재 slab 에서 bump 방식으로 잘라서 준다.
+ * slab 크기는 2 배씩 늘어나며 (_s_max_slab_blocks 까지) 한번 받은 slab 은 pool 이 소멸될 때 까지 반환하지 않는다.
+ */
+template<class T>
+class _node_pool {
+  struct _slab {
+    _slab *_m_next;
+    size_t _m_blocks;
+  };
+
+  struct _free_block {
+    _free_block *_m_next;
+  };
+
+  static const size_t _s_align = __alignof__(T) > sizeof(void *) ? __alignof__(T) : sizeof(void *);
+  static const size_t _s_raw_block = sizeof(T) > sizeof(_free_block) ? sizeof(T) : sizeof(_free_block);
+  static const size_t _s_block_size = (_s_raw_block + _s_align - 1) / _s_align * _s_align;
+  static const size_t _s_header_size = (sizeof(_slab) + _s_align - 1) / _s_align * _s_align;
+  static const size_t _s_min_slab_blocks = 32;
+  static const size_t _s_max_slab_blocks = 8192;
+
+  _slab *_m_slabs;        // first slab (allocation order)
+  _slab *_m_current;      // slab the bump cursor is in
+  char *_m_cursor;
+  char *_m_cursor_end;
+  _free_block *_m_free;
+  size_t _m_in_use;
+  size_t _m_refs;
+
+  _node_pool(const _node_pool &);
+  _node_pool &operator=(const _node_pool &);
+
+  static char *_s_begin(_slab *s) { return reinterpret_cast<char *>(s) + _s_header_size; }
+  static char *_s_end(_slab *s) { return _s_begin(s) + s->_m_blocks * _s_block_size; }
+
+  void _m_bump_into(_slab *s) {
+    _m_current = s;
+    _m_cursor = _s_begin(s);
+    _m_cursor_end = _s_end(s);
+  }
+
+  // 다음 slab 으로 넘어가거나 (reset 이후 재사용) 새 slab 을 받아온다
+  void _m_next_slab() {
+    if (_m_current != 0 && _m_current->_m_next != 0) {
+      _m_bump_into(_m_current->_m_next);
+      return;
+    }
+    size_t _n = _m_current == 0 ? _s_min_slab_blocks : _m_current->_m_blocks * 2;
+    if (_n > _s_max_slab_blocks)
+      _n = _s_max_slab_blocks;
+    _slab *_s = static_cast<_slab *>(::operator new(_s_header_size + _n * _s_block_size));
+    _s->_m_next = 0;
+    _s->_m_blocks = _n;
+    if (_m_current == 0)
+      _m_slabs = _s;
+    else
+      _m_current->_m_next = _s;
+    _m_bump_into(_s);
+  }
+
+ public:
+  _node_pool()
+      : _m_slabs(0), _m_current(0), _m_cursor(0), _m_cursor_end(0), _m_free(0), _m_in_use(0), _m_refs(1) {}
+
+  ~_node_pool() {
+    while (_m_slabs != 0) {
+      _slab *_next = _m_slabs->_m_next;
+      ::operator delete(_m_slabs);
+      _m_slabs = _next;
+    }
+  }
+
+  void *allocate() {
+    void *_p;
+    if (_m_free != 0) {
+      _p = _m_free;
+      _m_free = _m_free->_m_next;
+    } else {
+      if (_m_cursor == _m_cursor_end)
+        _m_next_slab();
+      _p = _m_cursor;
+      _m_cursor += _s_block_size;
+    }
+    ++_m_in_use;
+    return _p;
+  }
+
+  void deallocate(void *p) {
+    _free_block *_b = static_cast<_free_block *>(p);
+    _b->_m_next = _m_free;
+    _m_free = _b;
+    --_m_in_use;
+  }
+
+  /**
+   * @brief Return every block to the pool at once
+   * @param live number of blocks the caller still owns
+   * @return true if all blocks were released, false if some other owner still holds blocks
+   *
+   * The caller must not touch any block it owned afterwards. Slabs are kept and reused in order,
+   * so the cost is O(1) regardless of how many blocks were handed out.
+   */
+  bool release(size_t live) {
+    if (live != _m_in_use)
+      return false;
+    _m_free = 0;
+    _m_in_use = 0;
+    if (_m_slabs != 0)
+      _m_bump_into(_m_slabs);
+    return true;
+  }
+
+  size_t in_use() const { return _m_in_use; }
+
+  void _m_acquire() { ++_m_refs; }
+  bool _m_unref() { return --_m_refs == 0; }
+};
+
+/**
+ * @brief Allocator that serves single objects from a slab pool with free-list reuse
+ * @tparam T value type
+ *
+ * allocate(1) / deallocate(p, 1) 은 pool 을 통해서 처리하고, 그 외의 크기는 operator new 로 넘긴다.
+ * 복사된 allocator 는 같은 pool 을 공유하고 (operator== 가 true), rebind 된 allocator 는 자신의 pool 을 따로 가진다.
+ * pool 은 처음 allocate 하거나 복사 / 비교할 때 만들어지므로 get_allocator() 처럼 잠깐 쓰고 버리는 rebind 는 비용이 없다.
+ * 복사와 비교가 pool 을 먼저 만들어 두므로 아직 allocate 하지 않은 두 allocator 도 pool 이 같을 때만 같다.
+ * Not thread-safe : every container using the allocator must be used from one thread at a time.
+ */
+template<class T>
+class pool_allocator {
+ public:
+  typedef T value_type;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template<class U>
+  struct rebind { typedef pool_allocator<U> other; };
+
+ private:
+  mutable _node_pool<T> *_m_pool;
+
+  _node_pool<T> *_m_get_pool() const {
+    if (_m_pool == 0)
+      _m_pool = new _node_pool<T>();
+    return _m_pool;
+  }
+
+  void _m_unref() {
+    if (_m_pool != 0 && _m_pool->_m_unref())
+      delete _m_pool;
+    _m_pool = 0;
+  }
+
+ public:
+  pool_allocator() throw(): _m_pool(0) {}
+  pool_allocator(const pool_allocator &x) : _m_pool(x._m_get_pool()) { _m_pool->_m_acquire(); }
+  template<class U>
+  pool_allocator(const pool_allocator<U> &) throw(): _m_pool(0) {}
+
+  ~pool_allocator() { _m_unref(); }
+
+  pool_allocator &operator=(const pool_allocator &x) {
+    _node_pool<T> *_p = x._m_get_pool();
+    if (_m_pool != _p) {
+      _p->_m_acquire();
+      _m_unref();
+      _m_pool = _p;
+    }
+    return *this;
+  }
+
+  pointer address(reference x) const { return &x; }
+  const_pointer address(const_reference x) const { return &x; }
+
+  pointer allocate(size_type n, const void * = 0) {
+    if (n == 1)
+      return static_cast<pointer>(_m_get_pool()->allocate());
+    if (n > max_size())
+      throw std::bad_alloc();
+    return static_cast<pointer>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(pointer p, size_type n) {
+    if (n == 1)
+      _m_pool->deallocate(p);
+    else
+      ::operator delete(p);
+  }
+
+  size_type max_size() const throw() { return size_type(-1) / sizeof(T); }
+
+  void construct(pointer p, const T &val) { ::new(static_cast<void *>(p)) T(val); }
+  void destroy(pointer p) { p->~T(); }
+
+  /**
+   * @brief Recycle every slab of the pool if @a live is the number of blocks still handed out
+   * @return true if the blocks were recycled (the caller must forget all of them)
+   */
+  bool release(size_type live) { return _m_pool == 0 ? live == 0 : _m_pool->release(live); }
+
+  /**
+   * @return number of single blocks currently handed out by the pool
+   */
+  size_type in_use() const { return _m_pool == 0 ? 0 : _m_pool->in_use(); }
+
+  friend bool operator==(const pool_allocator &lhs, const pool_allocator &rhs) {
+    return lhs._m_get_pool() == rhs._m_get_pool();
+  }
+  friend bool operator!=(const pool_allocator &lhs, const pool_allocator &rhs) {
+    return !(lhs == rhs);
+  }
+};
+
+/**
+ * @brief Traits class that identifies whether Alloc can recycle all of its blocks at once
+ */
+template<class Alloc>
+struct is_pool_allocator : public false_type {};
+
+template<class T>
+struct is_pool_allocator<pool_allocator<T> > : public true_type {};
+
+}
+
+#endif //POOL_ALLOCATOR_HPP_
@@ -0,0 +1,393 @@
+/*
+ * File: set.hpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#ifndef SET_HPP_
+#define SET_HPP_
+
+#include <functional>
+#include "pair.hpp"
+#include "function.hpp"
+#include "tree.hpp"
+
+namespace ft {
+
+/**
+ * @brief sorted container of unique keys, the same red-black tree as map with Identity as the key extractor
+ *
+ * 노드에는 key 만 들어있으므로 map<Key, char> 를 set 으로 쓰는 것보다 노드가 작고 pair 를 거치지 않는다.
+ * 원소는 key 이므로 iterator 와 const_iterator 모두 원소를 바꿀 수 없다.
+ */
+template<class Key, class Compare = std::less<Key>, class Alloc = std::allocator<Key> >
+class set {
+ public:
+  typedef Key key_type;
+  typedef Key value_type;
+  typedef Compare key_compare;
+  typedef Compare value_compare;
+
+ private:
+  typedef _rb_tree<key_type, value_type, Identity<value_type>, key_compare, Alloc> rep_type;
+  rep_type _m_tree;
+
+ public:
+  typedef typename rep_type::allocator_type allocator_type;
+  typedef typename rep_type::const_reference reference;
+  typedef typename rep_type::const_reference const_reference;
+  typedef typename rep_type::const_iterator iterator;
+  typedef typename rep_type::const_iterator const_iterator;
+  typedef typename rep_type::size_type size_type;
+  typedef typename rep_type::difference_type difference_type;
+  typedef typename rep_type::const_pointer pointer;
+  typedef typename rep_type::const_pointer const_pointer;
+  typedef typename rep_type::const_reverse_iterator reverse_iterator;
+  typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
+
+  explicit set(const key_compare &comp = key_compare(),
+               const allocator_type &alloc = allocator_type()) : _m_tree(comp, alloc) {}
+
+  template<class InputIterator>
+  set(InputIterator first,
+      InputIterator last,
+      const key_compare &comp = key_compare(),
+      const allocator_type &alloc = allocator_type()) : _m_tree(comp, alloc) {
+    _m_tree.insert_unique(first, last);
+  }
+
+  // range already sorted by comp without duplicated keys : linear, the order is not checked
+  template<class InputIterator>
+  set(sorted_unique_t,
+      InputIterator first,
+      InputIterator last,
+      const key_compare &comp = key_compare(),
+      const allocator_type &alloc = allocator_type()) : _m_tree(comp, alloc) {
+    _m_tree.insert_sorted_unique(first, last);
+  }
+
+  set(const set &x) : _m_tree(x._m_tree) {}
+
+  ~set() {}
+
+  set &operator=(const set &x) {
+    _m_tree = x._m_tree;
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return _m_tree.get_allocator(); }
+
+  /* ****************************************************** */
+  /*                      Iterators                         */
+  /* ****************************************************** */
+
+  iterator begin() const { return _m_tree.begin(); }
+  iterator end() const { return _m_tree.end(); }
+  reverse_iterator rbegin() const { return _m_tree.rbegin(); }
+  reverse_iterator rend() const { return _m_tree.rend(); }
+
+  /* ****************************************************** */
+  /*                      Capacity                          */
+  /* ****************************************************** */
+
+  size_type size() const { return _m_tree.size(); }
+  size_type max_size() const { return _m_tree.max_size(); }
+  bool empty() const { return _m_tree.empty(); }
+
+  /* ****************************************************** */
+  /*                      Modifiers                         */
+  /* ****************************************************** */
+
+  pair<iterator, bool> insert(const value_type &val) {
+    pair<typename rep_type::iterator, bool> _ret = _m_tree.insert_unique(val);
+    return ft::make_pair(iterator(_ret.first), _ret.second);
+  }
+  iterator insert(iterator position, const value_type &val) { return _m_tree.insert_unique(position, val); }
+  template<class InputIterator>
+  void insert(InputIterator first, InputIterator last) { _m_tree.insert_unique(first, last); }
+  template<class InputIterator>
+  void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+    _m_tree.insert_sorted_unique(first, last);
+  }
+
+  void erase(iterator position) { _m_tree.erase(position._m_const_cast()); }
+  size_type erase(const key_type &k) { return _m_tree.erase(k); }
+  void erase(iterator first, iterator last) { _m_tree.erase(first._m_const_cast(), last._m_const_cast()); }
+
+  void swap(set &x) { _m_tree.swap(x._m_tree); }
+  void clear() { _m_tree.clear(); }
+
+  /**
+   * @brief set algebra on the trees themselves, O(n + m) (see map::merge / assign_union)
+   *
+   * ex) a.intersect(b); diff.assign_difference(yesterday, today);
+   */
+  void merge(set &src) { _m_tree.merge(src._m_tree, keep_first()); }
+  void intersect(const set &other) { _m_tree.intersect(other._m_tree); }
+  void subtract(const set &other) { _m_tree.subtract(other._m_tree); }
+  void assign_union(const set &a, const set &b) { _m_tree.assign_union(a._m_tree, b._m_tree, keep_first()); }
+  void assign_intersection(const set &a, const set &b) { _m_tree.assign_intersection(a._m_tree, b._m_tree); }
+  void assign_difference(const set &a, const set &b) { _m_tree.assign_difference(a._m_tree, b._m_tree); }
+
+  /* ****************************************************** */
+  /*                      Observers                         */
+  /* ****************************************************** */
+
+  key_compare key_comp() const { return _m_tree.key_comp(); }
+  value_compare value_comp() const { return _m_tree.key_comp(); }
+
+  /* ****************************************************** */
+  /*                      Operations                        */
+  /* ****************************************************** */
+
+  iterator find(const key_type &k) const { return _m_tree.find(k); }
+  size_type count(const key_type &k) const { return _m_tree.find(k) == _m_tree.end() ? 0 : 1; }
+  iterator lower_bound(const key_type &k) const { return _m_tree.lower_bound(k); }
+  iterator upper_bound(const key_type &k) const { return _m_tree.upper_bound(k); }
+  pair<iterator, iterator> equal_range(const key_type &k) const { return _m_tree.equal_range(k); }
+
+  // heterogeneous lookup, only when key_compare has is_transparent (ex: set<std::string, ft::less<> >::find("key"))
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type find(const K &k) const {
+    return _m_tree.find(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, size_type>::type count(const K &k) const {
+    return _m_tree.count(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type lower_bound(const K &k) const {
+    return _m_tree.lower_bound(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type upper_bound(const K &k) const {
+    return _m_tree.upper_bound(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, pair<iterator, iterator> >::type
+  equal_range(const K &k) const {
+    return _m_tree.equal_range(k);
+  }
+
+  template<class Key1, class Compare1, class Alloc1>
+  friend bool operator==(const set<Key1, Compare1, Alloc1> &lhs, const set<Key1, Compare1, Alloc1> &rhs);
+
+  template<class Key1, class Compare1, class Alloc1>
+  friend bool operator<(const set<Key1, Compare1, Alloc1> &lhs, const set<Key1, Compare1, Alloc1> &rhs);
+};
+
+template<class Key, class Compare, class Alloc>
+bool operator==(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
+  return lhs._m_tree == rhs._m_tree;
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator!=(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator<(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
+  return lhs._m_tree < rhs._m_tree;
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator<=(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
+  return !(rhs < lhs);
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator>(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
+  return rhs < lhs;
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator>=(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
+  return !(lhs < rhs);
+}
+
+template<class Key, class Compare, class Alloc>
+void swap(set<Key, Compare, Alloc> &x, set<Key, Compare, Alloc> &y) {
+  x.swap(y);
+}
+
+/**
+ * @brief sorted container of keys that may repeat, equivalent keys stay in insertion order
+ */
+template<class Key, class Compare = std::less<Key>, class Alloc = std::allocator<Key> >
+class multiset {
+ public:
+  typedef Key key_type;
+  typedef Key value_type;
+  typedef Compare key_compare;
+  typedef Compare value_compare;
+
+ private:
+  typedef _rb_tree<key_type, value_type, Identity<value_type>, key_compare, Alloc> rep_type;
+  rep_type _m_tree;
+
+ public:
+  typedef typename rep_type::allocator_type allocator_type;
+  typedef typename rep_type::const_reference reference;
+  typedef typename rep_type::const_reference const_reference;
+  typedef typename rep_type::const_iterator iterator;
+  typedef typename rep_type::const_iterator const_iterator;
+  typedef typename rep_type::size_type size_type;
+  typedef typename rep_type::difference_type difference_type;
+  typedef typename rep_type::const_pointer pointer;
+  typedef typename rep_type::const_pointer const_pointer;
+  typedef typename rep_type::const_reverse_iterator reverse_iterator;
+  typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
+
+  explicit multiset(const key_compare &comp = key_compare(),
+                    const allocator_type &alloc = allocator_type()) : _m_tree(comp, alloc) {}
+
+  template<class InputIterator>
+  multiset(InputIterator first,
+           InputIterator last,
+           const key_compare &comp = key_compare(),
+           const allocator_type &alloc = allocator_type()) : _m_tree(comp, alloc) {
+    _m_tree.insert_equal(first, last);
+  }
+
+  multiset(const multiset &x) : _m_tree(x._m_tree) {}
+
+  ~multiset() {}
+
+  multiset &operator=(const multiset &x) {
+    _m_tree = x._m_tree;
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return _m_tree.get_allocator(); }
+
+  /* ****************************************************** */
+  /*                      Iterators                         */
+  /* ****************************************************** */
+
+  iterator begin() const { return _m_tree.begin(); }
+  iterator end() const { return _m_tree.end(); }
+  reverse_iterator rbegin() const { return _m_tree.rbegin(); }
+  reverse_iterator rend() const { return _m_tree.rend(); }
+
+  /* ****************************************************** */
+  /*                      Capacity                          */
+  /* ****************************************************** */
+
+  size_type size() const { return _m_tree.size(); }
+  size_type max_size() const { return _m_tree.max_size(); }
+  bool empty() const { return _m_tree.empty(); }
+
+  /* ****************************************************** */
+  /*                      Modifiers                         */
+  /* ****************************************************** */
+
+  // after the elements with an equivalent key
+  iterator insert(const value_type &val) { return _m_tree.insert_equal(val); }
+  // as close before position as the order allows
+  iterator insert(iterator position, const value_type &val) { return _m_tree.insert_equal(position, val); }
+  template<class InputIterator>
+  void insert(InputIterator first, InputIterator last) { _m_tree.insert_equal(first, last); }
+
+  void erase(iterator position) { _m_tree.erase(position._m_const_cast()); }
+  // every element with key k
+  size_type erase(const key_type &k) { return _m_tree.erase(k); }
+  void erase(iterator first, iterator last) { _m_tree.erase(first._m_const_cast(), last._m_const_cast()); }
+
+  void swap(multiset &x) { _m_tree.swap(x._m_tree); }
+  void clear() { _m_tree.clear(); }
+
+  /* ****************************************************** */
+  /*                      Observers                         */
+  /* ****************************************************** */
+
+  key_compare key_comp() const { return _m_tree.key_comp(); }
+  value_compare value_comp() const { return _m_tree.key_comp(); }
+
+  /* ****************************************************** */
+  /*                      Operations                        */
+  /* ****************************************************** */
+
+  // first of the equivalent elements
+  iterator find(const key_type &k) const { return _m_tree.find(k); }
+  size_type count(const key_type &k) const { return _m_tree.count(k); }
+  iterator lower_bound(const key_type &k) const { return _m_tree.lower_bound(k); }
+  iterator upper_bound(const key_type &k) const { return _m_tree.upper_bound(k); }
+  pair<iterator, iterator> equal_range(const key_type &k) const { return _m_tree.equal_range(k); }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type find(const K &k) const {
+    return _m_tree.find(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, size_type>::type count(const K &k) const {
+    return _m_tree.count(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type lower_bound(const K &k) const {
+    return _m_tree.lower_bound(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type upper_bound(const K &k) const {
+    return _m_tree.upper_bound(k);
+  }
+
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, pair<iterator, iterator> >::type
+  equal_range(const K &k) const {
+    return _m_tree.equal_range(k);
+  }
+
+  template<class Key1, class Compare1, class Alloc1>
+  friend bool operator==(const multiset<Key1, Compare1, Alloc1> &lhs, const multiset<Key1, Compare1, Alloc1> &rhs);
+
+  template<class Key1, class Compare1, class Alloc1>
+  friend bool operator<(const multiset<Key1, Compare1, Alloc1> &lhs, const multiset<Key1, Compare1, Alloc1> &rhs);
+};
+
+template<class Key, class Compare, class Alloc>
+bool operator==(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
+  return lhs._m_tree == rhs._m_tree;
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator!=(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator<(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
+  return lhs._m_tree < rhs._m_tree;
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator<=(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
+  return !(rhs < lhs);
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator>(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
+  return rhs < lhs;
+}
+
+template<class Key, class Compare, class Alloc>
+bool operator>=(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
+  return !(lhs < rhs);
+}
+
+template<class Key, class Compare, class Alloc>
+void swap(multiset<Key, Compare, Alloc> &x, multiset<Key, Compare, Alloc> &y) {
+  x.swap(y);
+}
+}
+
+#endif //SET_HPP_
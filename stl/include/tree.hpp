@@ -14,10 +14,21 @@
 #include "function.hpp"
 #include "pair.hpp"
 #include "algorithm.hpp"
+#include "type_traits.hpp"
+#include "pool_allocator.hpp"
+#include <climits>
 #include <memory>
+#include <new>
 
 //#include <iostream>
 
+// hint the cpu to start loading the cache line of p (no-op on other compilers)
+#if defined(__GNUC__) || defined(__clang__)
+#define FT_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define FT_PREFETCH(p) ((void) 0)
+#endif
+
 namespace ft {
 
 /**
@@ -38,10 +49,65 @@ struct _rb_tree_node_base {
   typedef _rb_tree_node_base *_base_ptr;
   typedef const _rb_tree_node_base *_const_base_ptr;
 
+#ifdef FT_RB_TREE_COMPACT
+  // parent pointer with the color in its low bit (nodes are at least 4 byte aligned)
+  // header 는 red (0) 이므로 header 의 slot 에는 root 포인터가 그대로 들어있다.
+  _base_ptr _m_parent_color;
+#else
   bool _m_color;
+  // number of nodes of the subtree, only maintained by order statistic trees.
+  // 32 bit 라서 _m_color 뒤의 padding 에 들어가므로 노드 크기는 늘어나지 않는다.
+  unsigned int _m_size;
   _base_ptr _m_parent;
+#endif
   _base_ptr _m_left;
   _base_ptr _m_right;
+#ifdef FT_RB_TREE_THREADED
+  // in-order neighbours (the header closes the ring), kept by insert / erase so that ++ and -- are one load
+  _base_ptr _m_next;
+  _base_ptr _m_prev;
+#endif
+
+#ifdef FT_RB_TREE_COMPACT
+  _base_ptr _m_get_parent() const {
+    return reinterpret_cast<_base_ptr>(reinterpret_cast<size_t>(_m_parent_color) & ~size_t(1));
+  }
+  void _m_set_parent(_base_ptr p) {
+    _m_parent_color = reinterpret_cast<_base_ptr>(reinterpret_cast<size_t>(p)
+        | (reinterpret_cast<size_t>(_m_parent_color) & size_t(1)));
+  }
+  bool _m_get_color() const { return reinterpret_cast<size_t>(_m_parent_color) & size_t(1); }
+  void _m_set_color(bool c) {
+    _m_parent_color = reinterpret_cast<_base_ptr>((reinterpret_cast<size_t>(_m_parent_color) & ~size_t(1))
+        | static_cast<size_t>(c));
+  }
+  // no room for the subtree size : order statistic trees are not available in the compact layout
+  unsigned int _m_get_size() const { return 0; }
+  void _m_set_size(unsigned int) {}
+  _base_ptr &_m_root_slot() { return _m_parent_color; }
+  _base_ptr _m_load_root() const {
+    return reinterpret_cast<_base_ptr>(reinterpret_cast<size_t>(_s_load_link(_m_parent_color)) & ~size_t(1));
+  }
+#else
+  _base_ptr _m_get_parent() const { return _m_parent; }
+  void _m_set_parent(_base_ptr p) { _m_parent = p; }
+  bool _m_get_color() const { return _m_color; }
+  void _m_set_color(bool c) { _m_color = c; }
+  unsigned int _m_get_size() const { return _m_size; }
+  void _m_set_size(unsigned int n) { _m_size = n; }
+  // header only : parent slot of the header is the root
+  _base_ptr &_m_root_slot() { return _m_parent; }
+  _base_ptr _m_load_root() const { return _s_load_link(_m_parent); }
+#endif
+
+  /**
+   * @brief the root slot, _m_left and _m_right as seen by an optimistic reader (optimistic_map)
+   *
+   * reader 는 writer 가 바꾸는 중인 link 를 읽으므로 has_optimistic_readers 인 트리는 insert / erase / rotation 의
+   * link 쓰기와 reader 의 읽기를 모두 relaxed atomic 으로 해서 race 를 정의된 동작으로 만든다.
+   */
+  static void _s_store_link(_base_ptr &slot, _base_ptr x) { __atomic_store_n(&slot, x, __ATOMIC_RELAXED); }
+  static _base_ptr _s_load_link(const _base_ptr &slot) { return __atomic_load_n(&slot, __ATOMIC_RELAXED); }
 
   static _base_ptr _s_minimum(_base_ptr x) {
     while (x->_m_left != 0) x = x->_m_left;
@@ -88,16 +154,21 @@ struct _rb_tree_node : public _rb_tree_node_base {
 struct _rb_tree_header {
   _rb_tree_node_base _m_header;
   size_t _m_node_count; // keeps track of size of tree
+  bool _m_defer_destroy; // clear() hands the nodes to the reclaimer thread (set_deferred_destruction)
 
-  _rb_tree_header() : _m_header(), _m_node_count() {
-    _m_header._m_color = _s_red;
+  _rb_tree_header() : _m_header(), _m_node_count(), _m_defer_destroy(false) {
+    _m_header._m_set_color(_s_red);
     _m_reset();
   }
 
   void _m_reset() {
-    _m_header._m_parent = NULL;
+    _m_header._m_set_parent(NULL);
     _m_header._m_left = &_m_header;
     _m_header._m_right = &_m_header;
+#ifdef FT_RB_TREE_THREADED
+    _m_header._m_next = &_m_header;
+    _m_header._m_prev = &_m_header;
+#endif
     _m_node_count = 0;
   }
 };
@@ -107,16 +178,102 @@ const _rb_tree_node_base *_rb_tree_increment(const _rb_tree_node_base *x) throw(
 _rb_tree_node_base *_rb_tree_decrement(_rb_tree_node_base *x) throw();
 const _rb_tree_node_base *_rb_tree_decrement(const _rb_tree_node_base *x) throw();
 
-template<typename T>
+// set _m_next / _m_prev of every node from the tree structure, O(n) (threaded layout only)
+void _rb_tree_thread(_rb_tree_node_base *header) throw();
+
+/**
+ * @brief copy n bytes with relaxed atomic loads and stores, in the widest word dst, src and n are aligned to
+ *
+ * optimistic_map 이 writer 와 겹친 reader 의 원소 복사와 writer 의 원소 쓰기에 쓴다 (trivially copyable 타입만).
+ */
+void _rb_tree_atomic_copy(void *dst, const void *src, size_t n) throw();
+
+/**
+ * @brief successor / predecessor used by the iterators
+ *
+ * FT_RB_TREE_THREADED 이면 node 에 저장된 링크를 읽기만 하고, 아니면 부모를 타고 올라가며 찾는다.
+ */
+template<class NodePtr>
+inline NodePtr _rb_tree_next(NodePtr x) throw() {
+#ifdef FT_RB_TREE_THREADED
+  return x->_m_next;
+#else
+  return _rb_tree_increment(x);
+#endif
+}
+
+template<class NodePtr>
+inline NodePtr _rb_tree_prev(NodePtr x) throw() {
+#ifdef FT_RB_TREE_THREADED
+  return x->_m_prev;
+#else
+  return _rb_tree_decrement(x);
+#endif
+}
+
+// number of black nodes from x down to a leaf, x included (0 for an empty tree)
+size_t _rb_tree_black_height(const _rb_tree_node_base *x) throw();
+
+/**
+ * @brief link l, k and r (keys of l < k < keys of r) into one red-black tree in O(|lh - rh| + 1)
+ * @param lh, rh black heights of l and r (_rb_tree_black_height)
+ * @param header becomes the parent of the returned root
+ * @param h black height of the joined tree
+ * @param sized also keep the subtree sizes (order statistic tree)
+ * @return root of the joined tree
+ */
+_rb_tree_node_base *_rb_tree_join(_rb_tree_node_base *l, size_t lh, _rb_tree_node_base *k,
+                                  _rb_tree_node_base *r, size_t rh,
+                                  _rb_tree_node_base *header, size_t &h, bool sized) throw();
+
+/**
+ * @brief detached nodes waiting for the reclaimer thread, _m_destroy frees the nodes and the garbage itself
+ */
+struct _rb_tree_garbage {
+  void (*_m_destroy)(_rb_tree_garbage *);
+  size_t _m_nodes;
+  _rb_tree_garbage *_m_next;
+};
+
+// queue g for the reclaimer thread, false if it would exceed the limit (the caller frees g itself)
+bool _rb_tree_defer_destroy(_rb_tree_garbage *g) throw();
+
+/**
+ * @brief block until every deferred node has been freed
+ */
+void flush_deferred_destruction() throw();
+
+/**
+ * @brief most nodes that may wait for the reclaimer at once, beyond it clear() frees on the caller's thread
+ * @return previous limit
+ */
+size_t set_deferred_destruction_limit(size_t nodes) throw();
+
+// order statistic tree only
+size_t _rb_tree_rank(const _rb_tree_node_base *x) throw();
+_rb_tree_node_base *_rb_tree_select(_rb_tree_node_base *root, size_t k) throw();
+_rb_tree_node_base *_rb_tree_advance(_rb_tree_node_base *x, ptrdiff_t n) throw();
+
+// parallel copy : number of online cpus, and task(arg, i) for i in [0, count) on up to threads threads
+enum { _s_parallel_max_threads = 64 };
+unsigned _rb_tree_hardware_threads() throw();
+void _rb_tree_run_parallel(void (*task)(void *, size_t), void *arg, size_t count, unsigned threads) throw();
+
+/**
+ * @brief bidirectional iterator of rb_tree
+ * @tparam T value type
+ * @tparam Sized iterator of an order statistic tree : it + n, it - n and it1 - it2 take O(log n)
+ */
+template<typename T, bool Sized = false>
 struct _rb_tree_iterator {
-  typedef _rb_tree_iterator<T> iterator;
+  typedef _rb_tree_iterator<T, Sized> iterator;
   typedef ptrdiff_t difference_type;
   typedef T &reference;
   typedef T *pointer;
   typedef T value_type;
   typedef std::bidirectional_iterator_tag iterator_category;
 
-  typedef _rb_tree_iterator<T> _self;
+  typedef _rb_tree_iterator<T, Sized> _self;
   typedef _rb_tree_node_base::_base_ptr _base_ptr;
   typedef _rb_tree_node<T> *_link_type;
 
@@ -143,24 +300,47 @@ struct _rb_tree_iterator {
     return *static_cast<_link_type>(_m_node)->_m_valptr();
   } // *node
   _self &operator++() {
-    _m_node = _rb_tree_increment(_m_node);
+    _m_node = _rb_tree_next(_m_node);
     return *this;
   } // ++node
   _self operator++(int) {
     _self _tmp = *this;
-    _m_node = _rb_tree_increment(_m_node);
+    _m_node = _rb_tree_next(_m_node);
     return _tmp;
   } // node++
   _self &operator--() {
-    _m_node = _rb_tree_decrement(_m_node);
+    _m_node = _rb_tree_prev(_m_node);
     return *this;
   } // --node
   _self operator--(int) {
     _self _tmp = *this;
-    _m_node = _rb_tree_decrement(_m_node);
+    _m_node = _rb_tree_prev(_m_node);
     return _tmp;
   } // node--
 
+  template<typename Distance>
+  typename enable_if<Sized && is_integral<Distance>::value, _self>::type operator+(Distance n) const {
+    return _self(_rb_tree_advance(_m_node, n));
+  } // node + n
+  template<typename Distance>
+  typename enable_if<Sized && is_integral<Distance>::value, _self>::type operator-(Distance n) const {
+    return _self(_rb_tree_advance(_m_node, -static_cast<difference_type>(n)));
+  } // node - n
+  template<typename Distance>
+  typename enable_if<Sized && is_integral<Distance>::value, _self &>::type operator+=(Distance n) {
+    _m_node = _rb_tree_advance(_m_node, n);
+    return *this;
+  } // node += n
+  template<typename Distance>
+  typename enable_if<Sized && is_integral<Distance>::value, _self &>::type operator-=(Distance n) {
+    _m_node = _rb_tree_advance(_m_node, -static_cast<difference_type>(n));
+    return *this;
+  } // node -= n
+  template<bool B>
+  typename enable_if<B, difference_type>::type operator-(const _rb_tree_iterator<T, B> &y) const {
+    return static_cast<difference_type>(_rb_tree_rank(_m_node)) - static_cast<difference_type>(_rb_tree_rank(y._m_node));
+  } // node1 - node2
+
   friend bool operator==(const _self &x, const _self &y) {
     return x._m_node == y._m_node;
   }
@@ -169,16 +349,16 @@ struct _rb_tree_iterator {
   }
 };
 
-template<typename T>
+template<typename T, bool Sized = false>
 struct _rb_tree_const_iterator {
-  typedef _rb_tree_iterator<T> iterator;
+  typedef _rb_tree_iterator<T, Sized> iterator;
   typedef ptrdiff_t difference_type;
   typedef const T &reference;
   typedef const T *pointer;
   typedef T value_type;
   typedef std::bidirectional_iterator_tag iterator_category;
 
-  typedef _rb_tree_const_iterator<T> _self;
+  typedef _rb_tree_const_iterator<T, Sized> _self;
   typedef _rb_tree_node_base::_const_base_ptr _base_ptr;
   typedef const _rb_tree_node<T> *_link_type;
 
@@ -187,6 +367,7 @@ struct _rb_tree_const_iterator {
   _rb_tree_const_iterator() : _m_node() {}
   explicit _rb_tree_const_iterator(_base_ptr x) : _m_node(x) {}
   _rb_tree_const_iterator(const iterator &it) : _m_node(it._m_node) {}
+  _rb_tree_const_iterator(const _self &src) : _m_node(src._m_node) {}
 
   // const rb_iterator to non-const rb_iterator
   iterator _m_const_cast() const {
@@ -205,24 +386,47 @@ struct _rb_tree_const_iterator {
     return *static_cast<_link_type>(_m_node)->_m_valptr();
   } // *node
   _self &operator++() {
-    _m_node = _rb_tree_increment(_m_node);
+    _m_node = _rb_tree_next(_m_node);
     return *this;
   } // ++node
   _self operator++(int) {
     _self _tmp = *this;
-    _m_node = _rb_tree_increment(_m_node);
+    _m_node = _rb_tree_next(_m_node);
     return _tmp;
   } // node++
   _self &operator--() {
-    _m_node = _rb_tree_decrement(_m_node);
+    _m_node = _rb_tree_prev(_m_node);
     return *this;
   } // --node
   _self operator--(int) {
     _self _tmp = *this;
-    _m_node = _rb_tree_decrement(_m_node);
+    _m_node = _rb_tree_prev(_m_node);
     return _tmp;
   } // node--
 
+  template<typename Distance>
+  typename enable_if<Sized && is_integral<Distance>::value, _self>::type operator+(Distance n) const {
+    return _self(_rb_tree_advance(const_cast<_rb_tree_node_base *>(_m_node), n));
+  } // node + n
+  template<typename Distance>
+  typename enable_if<Sized && is_integral<Distance>::value, _self>::type operator-(Distance n) const {
+    return _self(_rb_tree_advance(const_cast<_rb_tree_node_base *>(_m_node), -static_cast<difference_type>(n)));
+  } // node - n
+  template<typename Distance>
+  typename enable_if<Sized && is_integral<Distance>::value, _self &>::type operator+=(Distance n) {
+    _m_node = _rb_tree_advance(const_cast<_rb_tree_node_base *>(_m_node), n);
+    return *this;
+  } // node += n
+  template<typename Distance>
+  typename enable_if<Sized && is_integral<Distance>::value, _self &>::type operator-=(Distance n) {
+    _m_node = _rb_tree_advance(const_cast<_rb_tree_node_base *>(_m_node), -static_cast<difference_type>(n));
+    return *this;
+  } // node -= n
+  template<bool B>
+  typename enable_if<B, difference_type>::type operator-(const _rb_tree_const_iterator<T, B> &y) const {
+    return static_cast<difference_type>(_rb_tree_rank(_m_node)) - static_cast<difference_type>(_rb_tree_rank(y._m_node));
+  } // node1 - node2
+
   friend bool operator==(const _self &x, const _self &y) {
     return x._m_node == y._m_node;
   }
@@ -230,6 +434,157 @@ struct _rb_tree_const_iterator {
     return x._m_node != y._m_node;
   }
 };
+/**
+ * @brief tag for the range functions whose input is already sorted without duplicated keys
+ */
+struct sorted_unique_t {};
+static const sorted_unique_t sorted_unique = sorted_unique_t();
+
+/**
+ * @brief tag for the copy constructors that clone the tree on several threads
+ *
+ * ex) ft::map<int, int> snapshot(m, ft::parallel_copy(8)); // 0 : every online cpu
+ */
+struct parallel_copy_t {
+  unsigned threads;
+  explicit parallel_copy_t(unsigned n) : threads(n) {}
+};
+inline parallel_copy_t parallel_copy(unsigned threads = 0) { return parallel_copy_t(threads); }
+
+/**
+ * @brief allocators that may allocate and deallocate from several threads at once (parallel copy)
+ *
+ * pool_allocator 처럼 lock 이 없는 allocator 는 false 이고, 이 경우 parallel copy 는 한 thread 로 복사한다.
+ * 직접 만든 thread safe allocator 는 특수화해서 true 로 만들면 된다.
+ */
+template<class Alloc>
+struct is_thread_safe_allocator : public false_type {};
+
+template<class T>
+struct is_thread_safe_allocator<std::allocator<T> > : public true_type {};
+
+/**
+ * @brief owner of one node taken out of a tree by extract(), give it back with insert(node)
+ *
+ * C++98 에는 move 가 없으므로 auto_ptr 처럼 복사하면 노드가 넘어가고 원본은 비게 된다.
+ * 다시 insert 되지 않은 노드는 handle 이 가진 allocator 로 해제된다.
+ */
+template<class Key, class Val, class KeyOfValue, class Alloc>
+class _rb_tree_node_handle {
+  typedef typename Alloc::template rebind<_rb_tree_node<Val> >::other _node_allocator;
+  typedef _rb_tree_node<Val> *_link_type;
+
+ public:
+  typedef Key key_type;
+  typedef Val value_type;
+  typedef Alloc allocator_type;
+
+  _rb_tree_node_handle() : _m_ptr(0), _m_alloc() {}
+  _rb_tree_node_handle(const _rb_tree_node_handle &x) : _m_ptr(x._m_release()), _m_alloc(x._m_alloc) {}
+  _rb_tree_node_handle(_link_type p, const _node_allocator &alloc) : _m_ptr(p), _m_alloc(alloc) {}
+  ~_rb_tree_node_handle() { _m_reset(); }
+
+  _rb_tree_node_handle &operator=(const _rb_tree_node_handle &x) {
+    if (this != &x) {
+      _m_reset();
+      _m_alloc = x._m_alloc;
+      _m_ptr = x._m_release();
+    }
+    return *this;
+  }
+
+  bool empty() const { return _m_ptr == 0; }
+  allocator_type get_allocator() const { return allocator_type(_m_alloc); }
+
+  value_type &value() const { return *_m_ptr->_m_valptr(); }
+  // the key may be changed before the node is inserted again
+  key_type &key() const { return const_cast<key_type &>(KeyOfValue()(*_m_ptr->_m_valptr())); }
+
+  void swap(_rb_tree_node_handle &x) {
+    ft::swap(_m_ptr, x._m_ptr);
+    ft::swap(_m_alloc, x._m_alloc);
+  }
+
+  const _node_allocator &_m_get_node_allocator() const { return _m_alloc; }
+
+  _link_type _m_release() const {
+    _link_type _p = _m_ptr;
+    _m_ptr = 0;
+    return _p;
+  }
+
+ private:
+  void _m_reset() {
+    if (_m_ptr) {
+      allocator_type(_m_alloc).destroy(_m_ptr->_m_valptr());
+      _m_alloc.deallocate(_m_ptr, 1);
+      _m_ptr = 0;
+    }
+  }
+
+  mutable _link_type _m_ptr;
+  _node_allocator _m_alloc;
+};
+
+/**
+ * @brief result of insert(node) : on failure the node is handed back in node
+ */
+template<class Iterator, class NodeHandle>
+struct _node_insert_return {
+  Iterator position;
+  bool inserted;
+  NodeHandle node;
+};
+
+/**
+ * @brief finger search : remembers the node found last and starts the next search from there
+ *
+ * ex) ft::map<long, int>::cursor c = m.get_cursor(); for (...) c.find(timestamp);
+ * 다음 key 가 d 개 떨어져 있으면 root 부터 내려가지 않고 부모를 따라 필요한 만큼만 올라갔다가 내려온다 (보통 O(log d)).
+ * 순서대로 찾으면 한 번에 평균 O(1) 이다. insert 는 cursor 에 영향이 없지만, cursor 가 가리키는 노드가
+ * erase 되면 iterator 처럼 무효가 되므로 seek() 으로 옮기거나 새 cursor 를 받아야 한다.
+ */
+template<class Tree, class Iterator>
+class _rb_tree_cursor {
+ public:
+  typedef typename Tree::key_type key_type;
+  typedef Iterator iterator;
+
+  explicit _rb_tree_cursor(const Tree &t) : _m_tree(&t), _m_node(t._m_end()) {}
+
+  iterator lower_bound(const key_type &k) {
+    _m_node = _m_tree->_m_finger_lower_bound(_m_node, k);
+    return position();
+  }
+
+  iterator upper_bound(const key_type &k) {
+    _m_node = _m_tree->_m_finger_upper_bound(_m_node, k);
+    return position();
+  }
+
+  // the cursor stays at lower_bound(k) even when k is not found
+  iterator find(const key_type &k) {
+    _m_node = _m_tree->_m_finger_lower_bound(_m_node, k);
+    return iterator(const_cast<_rb_tree_node_base *>(_m_tree->_m_found(_m_node, k)));
+  }
+
+  iterator position() const { return iterator(const_cast<_rb_tree_node_base *>(_m_node)); }
+  void seek(iterator position) { _m_node = position._m_node; }
+
+ private:
+  const Tree *_m_tree;
+  const _rb_tree_node_base *_m_node; // end() : no finger yet, the next search starts at the root
+};
+
+/**
+ * @brief true if the trees using Alloc are read by optimistic readers while a writer changes them
+ *
+ * 그런 트리만 insert / erase / clear 의 child / root link 를 relaxed atomic 으로 쓴다 (optimistic_map).
+ * 다른 트리는 보통의 store 를 그대로 쓴다.
+ */
+template<class Alloc>
+struct has_optimistic_readers : public false_type {};
+
 /**
  * @brief Red-Black tree
  * @tparam Key key
@@ -237,11 +592,14 @@ struct _rb_tree_const_iterator {
  * @tparam KeyOfValue template class that select key of value (functor)
  * @tparam Compare key_compare type (functor class)
  * @tparam Alloc allocator type
+ * @tparam OrderStatistic keep the subtree size of every node : rank(), select(), count_range() and
+ * iterator jumps in O(log n) at the cost of updating the sizes on the insert / erase path
  */
 template<class Key, class Val, class KeyOfValue = ft::Select1st<Val>,
-    class Compare = ft::less<Key>, class Alloc = std::allocator<Val> >
+    class Compare = ft::less<Key>, class Alloc = std::allocator<Val>, bool OrderStatistic = false>
 class _rb_tree {
   typedef typename Alloc::template rebind<_rb_tree_node<Val> >::other _node_allocator;
+  template<class, class> friend class _rb_tree_cursor;
 
  protected:
   typedef _rb_tree_node_base *_base_ptr;
@@ -249,6 +607,21 @@ class _rb_tree {
   typedef _rb_tree_node<Val> *_link_type;
   typedef const _rb_tree_node<Val> *_const_link_type;
 
+#ifdef FT_RB_TREE_COMPACT
+  // the compact node layout has no subtree size
+  typedef char _s_order_statistic_needs_full_layout[OrderStatistic ? -1 : 1];
+#endif
+
+  // child / root link 쓰기, optimistic reader 가 있는 트리만 atomic 이다
+  static const bool _s_shared_links = has_optimistic_readers<_node_allocator>::value;
+
+  static void _s_set_link(_base_ptr &slot, _base_ptr x) {
+    if (_s_shared_links)
+      _rb_tree_node_base::_s_store_link(slot, x);
+    else
+      slot = x;
+  }
+
  public:
   // member types
   typedef Key key_type;
@@ -282,9 +655,9 @@ class _rb_tree {
   void _m_construct_node(_link_type node, const value_type &x) {
     try {
       get_allocator().construct(node->_m_valptr(), x);
-    } catch (std::exception &e) {
+    } catch (...) {
       _m_dealloc_node(node);
-      throw e;
+      throw;
     }
   }
 
@@ -296,6 +669,46 @@ class _rb_tree {
     return _tmp;
   }
 
+  // node holding value_type(k, obj) built in place (try_emplace)
+  template<class Mapped>
+  _link_type _m_create_node(const key_type &k, const Mapped &obj) {
+    _link_type _tmp = _m_alloc_node();
+    try {
+      allocator_type _alloc = get_allocator();
+      _s_construct(_alloc, _tmp->_m_valptr(), k, obj);
+    } catch (...) {
+      _m_dealloc_node(_tmp);
+      throw;
+    }
+    return _tmp;
+  }
+
+  // node holding value_type(k, mapped_type()) with the mapped part value-initialized in place (try_emplace(k))
+  _link_type _m_create_key_node(const key_type &k) { return _m_create_node(k, _value_init_t()); }
+
+  /**
+   * @brief construct value_type(a, b) at p through the allocator
+   *
+   * C++98 allocator 의 construct 는 value_type 복사만 받으므로 임시 value_type 을 거친다.
+   * std::allocator 의 construct 는 placement new 이므로 그때만 바로 만든다.
+   */
+#if __cplusplus >= 201103L
+  template<class A, class B>
+  static void _s_construct(allocator_type &alloc, value_type *p, const A &a, const B &b) {
+    std::allocator_traits<allocator_type>::construct(alloc, p, a, b);
+  }
+#else
+  template<class A, class B>
+  static void _s_construct(std::allocator<value_type> &, value_type *p, const A &a, const B &b) {
+    ::new(static_cast<void *>(p)) value_type(a, b);
+  }
+
+  template<class OtherAlloc, class A, class B>
+  static void _s_construct(OtherAlloc &alloc, value_type *p, const A &a, const B &b) {
+    alloc.construct(p, value_type(a, b));
+  }
+#endif
+
   void _m_drop_node(_link_type p) {
     _m_destroy_node(p);
     _m_dealloc_node(p);
@@ -303,7 +716,8 @@ class _rb_tree {
 
   _link_type _m_clone_node(_link_type x) {
     _link_type _tmp = _m_create_node(x->_m_value_field);
-    _tmp->_m_color = x->_m_color;
+    _tmp->_m_set_color(x->_m_get_color());
+    _tmp->_m_set_size(x->_m_get_size());
     _tmp->_m_left = x->_m_left;
     _tmp->_m_right = x->_m_right;
     return _tmp;
@@ -353,8 +767,8 @@ class _rb_tree {
 
  protected:
   // 여기서는 _rb_node_base pointer 를 리턴해줌
-  _base_ptr &_m_root() { return this->_m_impl._m_header._m_parent; }
-  _const_base_ptr _m_root() const { return this->_m_impl._m_header._m_parent; }
+  _base_ptr &_m_root() { return this->_m_impl._m_header._m_root_slot(); }
+  _const_base_ptr _m_root() const { return this->_m_impl._m_header._m_get_parent(); }
 
   _base_ptr &_m_leftmost() { return this->_m_impl._m_header._m_left; }
   _const_base_ptr _m_leftmost() const { return this->_m_impl._m_header._m_left; }
@@ -364,8 +778,8 @@ class _rb_tree {
 
   // 여기는 _rb_node<Val> 를 리턴해줌
   // 여기 필요하면 쓰고 아니면 버리기
-  _link_type _m_begin() { return static_cast<_link_type>(this->_m_impl._m_header._m_parent); }
-  _const_link_type _m_begin() const { return static_cast<_link_type>(this->_m_impl._m_header._m_parent); }
+  _link_type _m_begin() { return static_cast<_link_type>(this->_m_impl._m_header._m_get_parent()); }
+  _const_link_type _m_begin() const { return static_cast<_link_type>(this->_m_impl._m_header._m_get_parent()); }
 
   _link_type _m_end() { return (_link_type) &(this->_m_impl._m_header); }
   _const_base_ptr _m_end() const { return &(this->_m_impl._m_header); }
@@ -376,16 +790,19 @@ class _rb_tree {
   static _link_type &_s_right(_base_ptr x) { return (_link_type &) (x->_m_right); }
   static _const_link_type &_s_right(_const_base_ptr x) { return (_const_link_type &) (x->_m_right); }
 
-  static _link_type &_s_parent(_link_type x) { return (_link_type &) (x->_m_parent); }
-  static _const_link_type &_s_parent(_const_link_type x) { return (_const_link_type &) (x->_m_parent); }
+  static _link_type _s_parent(_base_ptr x) { return static_cast<_link_type>(x->_m_get_parent()); }
+  static _const_link_type _s_parent(_const_base_ptr x) { return static_cast<_const_link_type>(x->_m_get_parent()); }
 
-  static Key _s_key(_base_ptr x) { return KeyOfValue()(((_link_type) x)->_m_value_field); }
+  // by reference : comparisons must not copy the key (std::string key 면 level 마다 할당이 생긴다)
+  static const Key &_s_key(_const_base_ptr x) { return KeyOfValue()(((_const_link_type) x)->_m_value_field); }
 
  public:
-  typedef _rb_tree_iterator<value_type> iterator;
-  typedef _rb_tree_const_iterator<value_type> const_iterator;
+  typedef _rb_tree_iterator<value_type, OrderStatistic> iterator;
+  typedef _rb_tree_const_iterator<value_type, OrderStatistic> const_iterator;
   typedef ft::reverse_iterator<iterator> reverse_iterator;
   typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef _rb_tree_node_handle<Key, Val, KeyOfValue, Alloc> node_type;
+  typedef _node_insert_return<iterator, node_type> insert_return_type;
 
   _rb_tree() : _m_impl() {}
 
@@ -395,10 +812,28 @@ class _rb_tree {
   _rb_tree(const _rb_tree &x) : _m_impl(x._m_impl) {
     if (x._m_root() != 0) {
       _m_root() = _m_copy((_link_type) x._m_root(), _m_end());
-      _m_impl._m_header._m_parent->_m_parent = &_m_impl._m_header;
+      _m_impl._m_header._m_get_parent()->_m_set_parent(&_m_impl._m_header);
+      _m_impl._m_header._m_left = _rb_tree_node_base::_s_minimum(_m_root());
+      _m_impl._m_header._m_right = _rb_tree_node_base::_s_maximum(_m_root());
+      _m_impl._m_node_count = x._m_impl._m_node_count;
+      _m_thread_all();
+    }
+  }
+
+  /**
+   * @brief same tree as the copy constructor, the subtrees below the top levels are cloned in parallel
+   *
+   * 위쪽 몇 level 은 이 thread 가 복사하고, 그 아래 subtree 들을 task 로 나눠 _m_copy 로 복사해서 그 자리에 붙인다.
+   * 모양과 색은 _m_copy 와 똑같다. 작은 트리나 thread safe 하지 않은 allocator 는 그냥 복사한다.
+   */
+  _rb_tree(const _rb_tree &x, parallel_copy_t p) : _m_impl(x._m_impl) {
+    if (x._m_root() != 0) {
+      _m_root() = _m_copy_parallel((_link_type) x._m_root(), _m_end(), x.size(), p.threads);
+      _m_impl._m_header._m_get_parent()->_m_set_parent(&_m_impl._m_header);
       _m_impl._m_header._m_left = _rb_tree_node_base::_s_minimum(_m_root());
       _m_impl._m_header._m_right = _rb_tree_node_base::_s_maximum(_m_root());
       _m_impl._m_node_count = x._m_impl._m_node_count;
+      _m_thread_all();
     }
   }
 
@@ -410,10 +845,11 @@ class _rb_tree {
       _m_impl._m_key_compare = x._m_impl._m_key_compare;
       if (x._m_root() != 0) {
         _m_root() = _m_copy((_link_type) x._m_root(), _m_end());
-        _m_impl._m_header._m_parent->_m_parent = &_m_impl._m_header;
+        _m_impl._m_header._m_get_parent()->_m_set_parent(&_m_impl._m_header);
         _m_impl._m_header._m_left = _rb_tree_node_base::_s_minimum(_m_root());
         _m_impl._m_header._m_right = _rb_tree_node_base::_s_maximum(_m_root());
         _m_impl._m_node_count = x._m_impl._m_node_count;
+        _m_thread_all();
       }
     }
     return *this;
@@ -435,17 +871,22 @@ class _rb_tree {
 
   size_type size() const { return _m_impl._m_node_count; }
 
-  size_type max_size() const { return _m_impl.max_size(); }
+  // an order-statistic node keeps its subtree size in 32 bits (_rb_tree_node_base::_m_size)
+  size_type max_size() const {
+    size_type _n = _m_impl.max_size();
+    size_type _limit = static_cast<unsigned int>(-1);
+    return OrderStatistic && _n > _limit ? _limit : _n;
+  }
 
   bool empty() const { return _m_impl._m_node_count == 0; }
 
-  void swap(_rb_tree<Key, Val, KeyOfValue, Compare, Alloc> &t) {
+  void swap(_rb_tree &t) {
     if (_m_root() == 0) {
       if (t._m_root() != 0) {
         _m_root() = t._m_root();
         _m_leftmost() = t._m_leftmost();
         _m_rightmost() = t._m_rightmost();
-        _m_root()->_m_parent = _m_end();
+        _m_root()->_m_set_parent(_m_end());
 
         t._m_root() = 0;
         t._m_leftmost() = t._m_end();
@@ -455,7 +896,7 @@ class _rb_tree {
       t._m_root() = _m_root();
       t._m_leftmost() = _m_leftmost();
       t._m_rightmost() = _m_rightmost();
-      t._m_root()->_m_parent = t._m_end();
+      t._m_root()->_m_set_parent(t._m_end());
 
       _m_root() = 0;
       _m_leftmost() = _m_end();
@@ -465,92 +906,60 @@ class _rb_tree {
       ft::swap(_m_leftmost(), t._m_leftmost());
       ft::swap(_m_rightmost(), t._m_rightmost());
 
-      _m_root()->_m_parent = _m_end();
-      t._m_root()->_m_parent = t._m_end();
+      _m_root()->_m_set_parent(_m_end());
+      t._m_root()->_m_set_parent(t._m_end());
     }
     // No need to swap header's color as it does not change.
     ft::swap(this->_m_impl._m_node_count, t._m_impl._m_node_count);
     ft::swap(this->_m_impl._m_key_compare, t._m_impl._m_key_compare);
+    // nodes must go back to the allocator (pool) they came from
+    ft::swap(_m_get_node_allocator(), t._m_get_node_allocator());
+    _m_thread_header();
+    t._m_thread_header();
   }
 
-  iterator find(const key_type &k) {
-    iterator _j = lower_bound(k);
-    return (_j == end() || _m_impl._m_key_compare(k, KeyOfValue()(*_j))) ? end() : _j;
-  }
-
-  const_iterator find(const key_type &k) const {
-    const_iterator _j = lower_bound(k);
-    return (_j == end() || _m_impl._m_key_compare(k, KeyOfValue()(*_j))) ? end() : _j;
-  }
+  iterator find(const key_type &k) { return iterator(const_cast<_base_ptr>(_m_find(k))); }
+  const_iterator find(const key_type &k) const { return const_iterator(_m_find(k)); }
 
   size_type count(const key_type &k) const {
     pair<const_iterator, const_iterator> _p = equal_range(k);
-    size_type _n = std::distance(_p.first, _p.second);
-    return _n;
-  }
-
-  iterator lower_bound(const key_type &k) {
-    // node >= k 를 만족하는 가장 첫 번째 node 반환
-    _link_type _y = (_link_type) _m_end(); // header
-    _link_type _x = (_link_type) _m_root(); // root
-
-    while (_x != 0) {
-      if (!_m_impl._m_key_compare(_s_key(_x), k)) {
-        _y = _x;
-        _x = _s_left(_x);
-      } else {
-        _x = _s_right(_x);
-      }
-    }
-    return iterator(_y);
-  }
-
-  const_iterator lower_bound(const key_type &k) const {
-    // node >= k 를 만족하는 가장 첫 번째 node 반환
-    _link_type _y = (_link_type) _m_end(); // header
-    _link_type _x = (_link_type) _m_root(); // root
-
-    while (_x != 0) {
-      if (!_m_impl._m_key_compare(_s_key(_x), k)) {
-        _y = _x;
-        _x = _s_left(_x);
-      } else {
-        _x = _s_right(_x);
-      }
-    }
-    return const_iterator(_y);
+    return _m_distance(_p.first, _p.second);
   }
 
-  iterator upper_bound(const key_type &k) {
-    // upper_bound 초과
-    _link_type _y = (_link_type) _m_end(); // header
-    _link_type _x = (_link_type) _m_root(); // root
-
-    while (_x != 0) {
-      if (_m_impl._m_key_compare(k, _s_key(_x))) {
-        _y = _x;
-        _x = _s_left(_x);
-      } else {
-        _x = _s_right(_x);
-      }
-    }
-    return iterator(_y);
-  }
+  // node >= k 를 만족하는 가장 첫 번째 node 반환
+  iterator lower_bound(const key_type &k) { return iterator(const_cast<_base_ptr>(_m_lower_bound(k))); }
+  const_iterator lower_bound(const key_type &k) const { return const_iterator(_m_lower_bound(k)); }
 
-  const_iterator upper_bound(const key_type &k) const {
-    // upper_bound 초과
-    _link_type _y = (_link_type) _m_end(); // header
-    _link_type _x = (_link_type) _m_root(); // root
+  // upper_bound 초과
+  iterator upper_bound(const key_type &k) { return iterator(const_cast<_base_ptr>(_m_upper_bound(k))); }
+  const_iterator upper_bound(const key_type &k) const { return const_iterator(_m_upper_bound(k)); }
 
-    while (_x != 0) {
-      if (_m_impl._m_key_compare(k, _s_key(_x))) {
+  /**
+   * @brief lower_bound (or upper_bound) for a reader racing with a writer (optimistic_map)
+   * @return false if the descent took more steps than a valid red-black tree allows
+   *
+   * writer 가 rotation 중인 트리를 읽으면 link 가 잠깐 cycle 을 만들 수 있으므로 높이의 한계만큼만 내려간다.
+   * 결과는 호출하는 쪽이 version 으로 검증해야 한다. 노드 메모리가 돌려지지 않는 allocator (pool_allocator) 에서만 쓸 수 있다.
+   * link 와 key 는 relaxed atomic 으로 읽고 (key 는 복사본을 비교), key_type 은 trivially copyable 이어야 한다.
+   */
+  bool _m_optimistic_bound(const key_type &k, bool upper, const_iterator &out) const {
+    char _key[sizeof(key_type)] __attribute__((aligned(__alignof__(key_type))));
+    const key_type &_x_key = *static_cast<const key_type *>(static_cast<const void *>(_key));
+    _const_base_ptr _x = this->_m_impl._m_header._m_load_root();
+    _const_base_ptr _y = _m_end();
+    for (size_type _steps = 0; _x != 0; ++_steps) {
+      if (_steps == 2 * sizeof(size_type) * CHAR_BIT)
+        return false;
+      _rb_tree_atomic_copy(_key, &_s_key(_x), sizeof(key_type));
+      if (upper ? _m_impl._m_key_compare(k, _x_key) : !_m_impl._m_key_compare(_x_key, k)) {
         _y = _x;
-        _x = _s_left(_x);
+        _x = _rb_tree_node_base::_s_load_link(_x->_m_left);
       } else {
-        _x = _s_right(_x);
+        _x = _rb_tree_node_base::_s_load_link(_x->_m_right);
       }
     }
-    return const_iterator(_y);
+    out = const_iterator(_y);
+    return true;
   }
 
   /**
@@ -567,116 +976,600 @@ class _rb_tree {
   }
 
   /**
-   * @brief for map.insert(const value_type)
-   * @param val pair<key, value>
-   * @return if the key unique, return <iterator: new element, true> else return <iterator: same key element, false>
+   * @brief heterogeneous lookup : k is any type Compare can compare with Key, key_type is never constructed
+   *
+   * Compare 에 is_transparent 가 있을 때만 (ex. ft::less<>) overload 후보가 된다.
+   * k 와 equivalent 한 key 가 여러 개일 수 있으므로 count 는 equal_range 의 길이를 센다.
    */
-  pair<iterator, bool> insert_unique(const value_type &val) {
-    _link_type _x = _m_begin();
-    _link_type _y = (_link_type) _m_end();
-    bool _comp = true;
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type find(const K &k) {
+    return iterator(const_cast<_base_ptr>(_m_find(k)));
+  }
 
-    while (_x != 0) {
-      _y = _x;
-      _comp = _m_impl._m_key_compare(KeyOfValue()(val), KeyOfValue()(_x->_m_value_field));
-      _x = _comp ? _s_left(_x) : _s_right(_x);
-    }
-    iterator _j = iterator(_y);
-    if (_comp) {
-      // if _x is left side of parent(_y)
-      if (_j == begin()) // root 노드가 없을 때
-        return ::ft::make_pair(_m_insert(_x, _y, val), true);
-      else
-        --_j; // left side 일 때 확인
-    }
-    // 중복된 키가 없을 경우
-    if (_m_impl._m_key_compare(_s_key(_j._m_node), KeyOfValue()(val))) {
-      iterator _it = _m_insert(_x, _y, val);
-      return ::ft::make_pair(_it, true);
-    }
-    return ::ft::make_pair(_j, false);
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, const_iterator>::type find(const K &k) const {
+    return const_iterator(_m_find(k));
   }
 
-  /**
-   * @brief hint for the position where element can be inserted
-   * @param position hint
-   * @param val value
-   * @return iterator pointing to either the newly inserted element or to the element that already had an equivalent key in the map.
-   */
-  iterator insert_unique(const_iterator position, const value_type &val) {
-    iterator pos = position._m_const_cast();
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, size_type>::type count(const K &k) const {
+    return _m_distance(const_iterator(_m_lower_bound(k)), const_iterator(_m_upper_bound(k)));
+  }
 
-    if (pos._m_node == this->_m_impl._m_header._m_left) {
-      if (size() > 0 &&
-          _m_impl._m_key_compare(KeyOfValue()(val), _s_key(pos._m_node)))
-        return _m_insert(pos._m_node, pos._m_node, val);
-      else
-        return insert_unique(val).first;
-    } else if (pos._m_node == &this->_m_impl._m_header) {
-      if (_m_impl._m_key_compare(_s_key(_m_rightmost()), KeyOfValue()(val)))
-        return _m_insert(0, _m_rightmost(), val);
-      else
-        return insert_unique(val).first;
-    } else {
-      iterator _before = pos;
-      --_before;
-      if (_m_impl._m_key_compare(_s_key(_before._m_node), KeyOfValue()(val))
-          && _m_impl._m_key_compare(KeyOfValue()(val), _s_key(pos._m_node))) {
-        if (_s_right(_before._m_node) == 0)
-          return _m_insert(0, _before._m_node, val);
-        else
-          return _m_insert(pos._m_node, pos._m_node, val);
-      } else
-        return insert_unique(val).first;
-    }
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type lower_bound(const K &k) {
+    return iterator(const_cast<_base_ptr>(_m_lower_bound(k)));
   }
 
-  template<class InputIterator>
-  void insert_unique(InputIterator first, InputIterator last) {
-    for (; first != last; ++first) {
-      insert_unique(*first);
-    }
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, const_iterator>::type lower_bound(const K &k) const {
+    return const_iterator(_m_lower_bound(k));
   }
 
-  void erase(iterator position) {
-    _link_type _y = (_link_type) _rb_tree_rebalance_for_erase(position._m_node,
-                                                              _m_impl._m_header._m_parent,
-                                                              _m_impl._m_header._m_left,
-                                                              _m_impl._m_header._m_right);
-    _m_drop_node(_y);
-    --_m_impl._m_node_count;
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, iterator>::type upper_bound(const K &k) {
+    return iterator(const_cast<_base_ptr>(_m_upper_bound(k)));
   }
 
-  /**
-   * @brief remove key of the element from map
-   * @param k key
-   * @return number of element erased
-   */
-  size_type erase(const key_type &k) {
-    pair<iterator, iterator> _p = equal_range(k);
-    size_type _n = std::distance(_p.first, _p.second);
-    erase(_p.first, _p.second);
-    return _n;
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, const_iterator>::type upper_bound(const K &k) const {
+    return const_iterator(_m_upper_bound(k));
   }
 
-  void erase(iterator first, iterator last) {
-    if (first == begin() && last == end()) {
-      clear();
-    } else {
-      while (first != last) erase(first++);
-    }
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, pair<iterator, iterator> >::type equal_range(const K &k) {
+    return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
   }
 
-  void clear() {
-    if (_m_impl._m_node_count != 0) {
-      _m_erase(static_cast<_link_type>(_m_root()));
-      _m_leftmost() = _m_end();
-      _m_root() = 0;
+  template<class K>
+  typename enable_if<is_transparent<Compare, K>::value, pair<const_iterator, const_iterator> >::type
+  equal_range(const K &k) const {
+    return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+  }
+
+  /**
+   * @brief find() for every key of [first, last), results are written to out in the same order
+   * @return out past the last result
+   *
+   * _s_find_batch 개의 탐색을 한 level 씩 번갈아 진행하면서 다음 child 를 prefetch 해서 cache miss 가 겹치게 한다.
+   */
+  template<class ForwardIterator, class OutputIterator>
+  OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) {
+    _const_base_ptr _result[_s_find_batch];
+    while (first != last) {
+      size_type _n = _m_find_batch(first, last, _result);
+      for (size_type i = 0; i < _n; ++i, ++out)
+        *out = iterator(const_cast<_base_ptr>(_result[i]));
+    }
+    return out;
+  }
+
+  template<class ForwardIterator, class OutputIterator>
+  OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) const {
+    _const_base_ptr _result[_s_find_batch];
+    while (first != last) {
+      size_type _n = _m_find_batch(first, last, _result);
+      for (size_type i = 0; i < _n; ++i, ++out)
+        *out = const_iterator(_result[i]);
+    }
+    return out;
+  }
+
+  /* ****************************************************** */
+  /*          Order statistic (OrderStatistic only)         */
+  /* ****************************************************** */
+
+  /**
+   * @return number of elements whose key goes before k (index of lower_bound(k))
+   */
+  size_type rank(const key_type &k) const {
+    _s_order_statistic_only();
+    size_type _r = 0;
+    _const_base_ptr _x = _m_root();
+
+    while (_x != 0) {
+      if (_m_impl._m_key_compare(_s_key(_x), k)) {
+        _r += _s_size(_x->_m_left) + 1;
+        _x = _x->_m_right;
+      } else {
+        _x = _x->_m_left;
+      }
+    }
+    return _r;
+  }
+
+  /**
+   * @return iterator to the k-th (0-based) element in order, end() if k >= size()
+   */
+  iterator select(size_type k) {
+    _s_order_statistic_only();
+    _base_ptr _x = _rb_tree_select(_m_root(), k);
+    return _x == 0 ? end() : iterator(_x);
+  }
+
+  const_iterator select(size_type k) const {
+    _s_order_statistic_only();
+    _const_base_ptr _x = _rb_tree_select(const_cast<_base_ptr>(_m_root()), k);
+    return _x == 0 ? end() : const_iterator(_x);
+  }
+
+  /**
+   * @return number of elements whose key is in [lo, hi)
+   */
+  size_type count_range(const key_type &lo, const key_type &hi) const {
+    if (!_m_impl._m_key_compare(lo, hi))
+      return 0;
+    return rank(hi) - rank(lo);
+  }
+
+  /* ****************************************************** */
+  /*                     Split / join                       */
+  /* ****************************************************** */
+
+  /**
+   * @brief move every element whose key is not less than k into right (right is cleared first)
+   *
+   * k 를 찾아 내려가는 경로에서 트리를 자르고, 잘린 조각들을 black height 에 맞춰 이어붙이므로 O(log n).
+   * 노드는 옮겨지기만 하고 복사되지 않는다 (right 는 이 트리의 allocator 를 같이 쓰게 된다).
+   * 원소 수는 order statistic tree 면 subtree size 로 바로 구하고, 아니면 작은 쪽을 세서 구한다.
+   */
+  void split(const key_type &k, _rb_tree &right) {
+    if (&right == this)
+      return;
+    right.clear();
+    right._m_get_node_allocator() = _m_get_node_allocator();
+    if (empty())
+      return;
+    _base_ptr _leftmost = _m_leftmost();
+    _base_ptr _rightmost = _m_rightmost();
+    size_type _n = size();
+    _base_ptr _l;
+    _base_ptr _r;
+    size_type _lh;
+    size_type _rh;
+    _m_split(_m_root(), _rb_tree_black_height(_m_root()), k, _l, _lh, _r, _rh);
+
+    if (_l)
+      _m_set_root(_l, _leftmost, _rb_tree_node_base::_s_maximum(_l));
+    else
+      _m_set_root(0, _m_end(), _m_end());
+    if (_r)
+      right._m_set_root(_r, _rb_tree_node_base::_s_minimum(_r), _rightmost);
+    else
+      right._m_set_root(0, right._m_end(), right._m_end());
+    _m_impl._m_node_count = _m_split_count(right, _n);
+    right._m_impl._m_node_count = _n - _m_impl._m_node_count;
+  }
+
+  /**
+   * @brief move every element of right into this tree, right keeps only the elements whose key is already here
+   *
+   * 모든 key 가 이 트리의 key 보다 크면 right 의 가장 작은 노드를 떼어내서 두 트리를 잇는 노드로 쓴다 (O(log n)).
+   * key 범위가 겹치거나 allocator 가 다르면 splice 처럼 원소를 하나씩 옮기고 (allocator 가 같으면 노드를 다시 엮는다),
+   * 이미 있는 key 의 원소는 right 에 남는다.
+   */
+  void join(_rb_tree &right) {
+    if (&right == this || right.empty())
+      return;
+    if (empty() && _m_get_node_allocator() == right._m_get_node_allocator()) {
+      swap(right);
+      return;
+    }
+    if (!(_m_get_node_allocator() == right._m_get_node_allocator())
+        || !_m_impl._m_key_compare(_s_key(_m_rightmost()), _s_key(right._m_leftmost()))) {
+      splice(right);
+      return;
+    }
+    size_type _n = size() + right.size();
+    _base_ptr _k = _rb_tree_rebalance_for_erase(right._m_leftmost(), right._m_root(), right._m_leftmost(),
+                                                right._m_rightmost(), OrderStatistic);
+    _base_ptr _r = right._m_root();
+    _base_ptr _rightmost = _r ? right._m_rightmost() : _k;
+    _s_thread_link(_m_rightmost(), _k);
+    if (_r)
+      _s_thread_link(_k, right._m_leftmost());
+    right._m_set_root(0, right._m_end(), right._m_end());
+    right._m_impl._m_node_count = 0;
+
+    size_type _h;
+    _m_set_root(_rb_tree_join(_m_root(), _rb_tree_black_height(_m_root()), _k, _r, _rb_tree_black_height(_r),
+                              _m_end(), _h, OrderStatistic), _m_leftmost(), _rightmost);
+    _m_impl._m_node_count = _n;
+  }
+
+  /* ****************************************************** */
+  /*                     Set algebra                        */
+  /* ****************************************************** */
+
+  /**
+   * @brief move every element of src into this tree, src becomes empty
+   * @param resolve for a key in both trees, resolve(mine, theirs) == true keeps mine (keep_first)
+   *
+   * 두 트리를 key 순서로 한 번 훑으면서 남길 노드를 list 로 엮고, 그 list 로 균형 트리를 바로 만든다 : O(n + m).
+   * allocator 가 같으면 노드를 그대로 가져오고 (할당 없음), 다르면 src 의 값을 복사한다.
+   * resolve 나 key_compare 가 던지면 원소는 하나도 없어지거나 겹치지 않는다 : 이미 훑은 key 들은 합쳐진 채
+   * 이 트리에 남고 (진 쪽 원소는 src 로), 아직 못 훑은 원소는 원래 트리에 남는다.
+   */
+  template<class Resolve>
+  void merge(_rb_tree &src, Resolve resolve) {
+    if (&src == this || src.empty())
+      return;
+    if (!(_m_get_node_allocator() == src._m_get_node_allocator())) {
+      _rb_tree _tmp(_m_impl._m_key_compare, get_allocator());
+      _tmp.assign_union(*this, src, resolve);
+      swap(_tmp);
+      src.clear();
+      return;
+    }
+    _set_builder<Resolve> _b(*this, _s_union, true, resolve);
+    _base_ptr _x = _m_leftmost();
+    _base_ptr _y = src._m_leftmost();
+    try {
+      _m_merge_walk(_x, _m_end(), _y, src._m_end(), _b);
+    } catch (...) {
+      // both rests are chained before either tree is relinked : the walk from _x / _y reads visited nodes
+      _s_chain_rest(_b._m_keep, _x, _m_end());
+      _s_chain_rest(_b._m_dropped, _y, src._m_end());
+      _m_link_chain(_b._m_keep);
+      src._m_link_chain(_b._m_dropped);
+      throw;
+    }
+    // equal allocators : this tree may free the nodes that came from src
+    _m_drop_chain(_b._m_dropped);
+    src._m_set_root(0, src._m_end(), src._m_end());
+    src._m_impl._m_node_count = 0;
+    _m_link_chain(_b._m_keep);
+  }
+
+  // keep only the elements whose key is also in other, O(n + m) without allocation
+  void intersect(const _rb_tree &other) {
+    if (other.empty())
+      clear();
+    else if (&other != this)
+      _m_retain(other, _s_intersection);
+  }
+
+  // remove the elements whose key is in other, O(n + m) without allocation
+  void subtract(const _rb_tree &other) {
+    if (&other == this)
+      clear();
+    else if (!other.empty())
+      _m_retain(other, _s_difference);
+  }
+
+  /**
+   * @brief replace the content by a copy of a | b, a & b or a - b (values always come from a, except for
+   * the keys of a | b where resolve prefers b)
+   *
+   * 한 번의 merge 로 결과 값들을 순서대로 복사하고 회전 없이 트리를 만든다 : O(n + m).
+   * a, b 는 이 트리 자신이면 안 된다.
+   */
+  template<class Resolve>
+  void assign_union(const _rb_tree &a, const _rb_tree &b, Resolve resolve) {
+    _m_assign_set(a, b, _s_union, resolve);
+  }
+
+  void assign_intersection(const _rb_tree &a, const _rb_tree &b) {
+    _m_assign_set(a, b, _s_intersection, keep_first());
+  }
+
+  void assign_difference(const _rb_tree &a, const _rb_tree &b) {
+    _m_assign_set(a, b, _s_difference, keep_first());
+  }
+
+  /* ****************************************************** */
+  /*                     Node handle                        */
+  /* ****************************************************** */
+
+  /**
+   * @brief unlink the element at position and hand its node over, nothing is copied or freed
+   */
+  node_type extract(const_iterator position) {
+    _base_ptr _z = _rb_tree_rebalance_for_erase(position._m_const_cast()._m_node, _m_root(),
+                                                _m_impl._m_header._m_left, _m_impl._m_header._m_right,
+                                                OrderStatistic, _s_shared_links);
+    --_m_impl._m_node_count;
+    return node_type(static_cast<_link_type>(_z), _m_get_node_allocator());
+  }
+
+  // empty handle if k is not in the tree
+  node_type extract(const key_type &k) {
+    iterator _it = find(k);
+    return _it == end() ? node_type() : extract(_it);
+  }
+
+  /**
+   * @brief link the node of nh back into a tree, nh becomes empty on success
+   *
+   * 같은 allocator 에서 온 노드면 그대로 다시 엮고, 아니면 값을 복사하고 handle 의 노드는 handle 이 해제한다.
+   */
+  insert_return_type insert_unique(const node_type &nh) {
+    insert_return_type _ret;
+    if (nh.empty()) {
+      _ret.position = end();
+      _ret.inserted = false;
+      return _ret;
+    }
+    pair<_base_ptr, _base_ptr> _p = _m_get_insert_unique_pos(nh.key());
+    if (_p.second == 0) {
+      _ret.position = iterator(_p.first);
+      _ret.inserted = false;
+      _ret.node = nh;
+      return _ret;
+    }
+    if (_m_get_node_allocator() == nh._m_get_node_allocator()) {
+      bool _insert_left = _m_insert_left(_p.first, _p.second, nh.key());
+      _ret.position = _m_link_node(_insert_left, _p.second, nh._m_release());
+    } else {
+      _ret.position = _m_insert(_p.first, _p.second, nh.value());
+      node_type _drop(nh);
+    }
+    _ret.inserted = true;
+    return _ret;
+  }
+
+  /**
+   * @brief move the element at position of other into this tree unless its key is already here
+   * @return true if it was moved
+   *
+   * allocator 가 같으면 노드를 other 에서 떼어내 그대로 엮으므로 할당도 복사도 없다.
+   */
+  bool splice(_rb_tree &other, iterator position) {
+    if (&other == this)
+      return false;
+    pair<_base_ptr, _base_ptr> _p = _m_get_insert_unique_pos(_s_key(position._m_node));
+    if (_p.second == 0)
+      return false;
+    bool _insert_left = _m_insert_left(_p.first, _p.second, _s_key(position._m_node));
+    if (_m_get_node_allocator() == other._m_get_node_allocator()) {
+      _m_link_node(_insert_left, _p.second, other.extract(position)._m_release());
+    } else {
+      _m_insert(_p.first, _p.second, *position);
+      other.erase(position);
+    }
+    return true;
+  }
+
+  // move every element of other whose key is not here yet, the others stay in other (O(m log(n + m)))
+  void splice(_rb_tree &other) {
+    if (&other == this)
+      return;
+    for (iterator _it = other.begin(); _it != other.end();) {
+      iterator _next = _it;
+      ++_next;
+      splice(other, _it);
+      _it = _next;
+    }
+  }
+
+  /**
+   * @brief for map.insert(const value_type)
+   * @param val pair<key, value>
+   * @return if the key unique, return <iterator: new element, true> else return <iterator: same key element, false>
+   */
+  pair<iterator, bool> insert_unique(const value_type &val) {
+    pair<_base_ptr, _base_ptr> _p = _m_get_insert_unique_pos(KeyOfValue()(val));
+    if (_p.second)
+      return ::ft::make_pair(_m_insert(_p.first, _p.second, val), true);
+    return ::ft::make_pair(iterator(_p.first), false);
+  }
+
+  /**
+   * @brief insert value_type(k, obj) if k is not there yet, nothing is constructed when it is
+   * @return same as insert_unique(val)
+   *
+   * insert_unique 처럼 먼저 위치를 찾고, 새 노드를 만들 때만 값을 노드 안에서 바로 생성한다 (임시 value_type 이 없다).
+   * value_type 이 (key, mapped) 로 생성되는 pair 일 때만 쓸 수 있다 (map).
+   */
+  template<class Mapped>
+  pair<iterator, bool> try_emplace_unique(const key_type &k, const Mapped &obj) {
+    pair<_base_ptr, _base_ptr> _p = _m_get_insert_unique_pos(k);
+    if (_p.second == 0)
+      return ::ft::make_pair(iterator(_p.first), false);
+    bool _insert_left = _m_insert_left(_p.first, _p.second, k);
+    return ::ft::make_pair(_m_link_node(_insert_left, _p.second, _m_create_node(k, obj)), true);
+  }
+
+  // mapped value is value initialized, only when a node is created
+  pair<iterator, bool> try_emplace_unique(const key_type &k) {
+    pair<_base_ptr, _base_ptr> _p = _m_get_insert_unique_pos(k);
+    if (_p.second == 0)
+      return ::ft::make_pair(iterator(_p.first), false);
+    bool _insert_left = _m_insert_left(_p.first, _p.second, k);
+    return ::ft::make_pair(_m_link_node(_insert_left, _p.second, _m_create_key_node(k)), true);
+  }
+
+  /**
+   * @brief insert val after every element with an equivalent key (multiset)
+   * @return the new element
+   */
+  iterator insert_equal(const value_type &val) {
+    pair<_base_ptr, _base_ptr> _p = _m_get_insert_equal_pos(KeyOfValue()(val));
+    return _m_insert(_p.first, _p.second, val);
+  }
+
+  /**
+   * @brief insert val as close before position as the order allows, O(1) amortized if the hint is right
+   *
+   * hint 가 틀리면 (val 이 position 과 그 앞 원소 사이에 들어갈 수 없으면) insert_equal(val) 과 같다.
+   */
+  iterator insert_equal(const_iterator position, const value_type &val) {
+    iterator _pos = position._m_const_cast();
+    const key_type &_k = KeyOfValue()(val);
+    if (_pos._m_node == &this->_m_impl._m_header) {
+      if (size() > 0 && !_m_impl._m_key_compare(_k, _s_key(_m_rightmost())))
+        return _m_insert(0, _m_rightmost(), val);
+      return insert_equal(val);
+    }
+    if (!_m_impl._m_key_compare(_s_key(_pos._m_node), _k)) {
+      if (_pos._m_node == _m_leftmost())
+        return _m_insert(_pos._m_node, _pos._m_node, val);
+      iterator _before = _pos;
+      --_before;
+      if (!_m_impl._m_key_compare(_k, _s_key(_before._m_node))) {
+        // right below before if it has no right child, otherwise pos is the leftmost of that subtree
+        if (_before._m_node->_m_right == 0)
+          return _m_insert(0, _before._m_node, val);
+        return _m_insert(_pos._m_node, _pos._m_node, val);
+      }
+    }
+    return insert_equal(val);
+  }
+
+  template<class InputIterator>
+  void insert_equal(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      insert_equal(end(), *first);
+  }
+
+  // where a node with key k goes after every equivalent key : (x, parent) to pass to _m_insert
+  pair<_base_ptr, _base_ptr> _m_get_insert_equal_pos(const key_type &k) {
+    _link_type _x = _m_begin();
+    _link_type _y = (_link_type) _m_end();
+    while (_x != 0) {
+      _y = _x;
+      _x = _m_impl._m_key_compare(k, _s_key(_x)) ? _s_left(_x) : _s_right(_x);
+    }
+    return pair<_base_ptr, _base_ptr>(_x, _y);
+  }
+
+  /**
+   * @brief where a node with key k goes
+   * @return (x, parent) to pass to _m_insert, or (node with the same key, 0) if k is already there
+   */
+  pair<_base_ptr, _base_ptr> _m_get_insert_unique_pos(const key_type &k) {
+    _link_type _x = _m_begin();
+    _link_type _y = (_link_type) _m_end();
+    bool _comp = true;
+
+    while (_x != 0) {
+      _y = _x;
+      _comp = _m_impl._m_key_compare(k, KeyOfValue()(_x->_m_value_field));
+      _x = _comp ? _s_left(_x) : _s_right(_x);
+    }
+    iterator _j = iterator(_y);
+    if (_comp) {
+      // if _x is left side of parent(_y)
+      if (_j == begin()) // root 노드가 없을 때
+        return pair<_base_ptr, _base_ptr>(_x, _y);
+      else
+        --_j; // left side 일 때 확인
+    }
+    // 중복된 키가 없을 경우
+    if (_m_impl._m_key_compare(_s_key(_j._m_node), k))
+      return pair<_base_ptr, _base_ptr>(_x, _y);
+    return pair<_base_ptr, _base_ptr>(_j._m_node, 0);
+  }
+
+  /**
+   * @brief hint for the position where element can be inserted
+   * @param position hint
+   * @param val value
+   * @return iterator pointing to either the newly inserted element or to the element that already had an equivalent key in the map.
+   */
+  iterator insert_unique(const_iterator position, const value_type &val) {
+    iterator pos = position._m_const_cast();
+
+    if (pos._m_node == this->_m_impl._m_header._m_left) {
+      if (size() > 0 &&
+          _m_impl._m_key_compare(KeyOfValue()(val), _s_key(pos._m_node)))
+        return _m_insert(pos._m_node, pos._m_node, val);
+      else
+        return insert_unique(val).first;
+    } else if (pos._m_node == &this->_m_impl._m_header) {
+      if (_m_impl._m_key_compare(_s_key(_m_rightmost()), KeyOfValue()(val)))
+        return _m_insert(0, _m_rightmost(), val);
+      else
+        return insert_unique(val).first;
+    } else {
+      iterator _before = pos;
+      --_before;
+      if (_m_impl._m_key_compare(_s_key(_before._m_node), KeyOfValue()(val))
+          && _m_impl._m_key_compare(KeyOfValue()(val), _s_key(pos._m_node))) {
+        if (_s_right(_before._m_node) == 0)
+          return _m_insert(0, _before._m_node, val);
+        else
+          return _m_insert(pos._m_node, pos._m_node, val);
+      } else
+        return insert_unique(val).first;
+    }
+  }
+
+  /**
+   * @brief insert range, an already sorted range is linked in O(n) when the tree is empty
+   *
+   * forward iterator 는 두 번 순회할 수 있으므로 먼저 정렬/중복 여부를 확인하고,
+   * 정렬되어 있으면 rebalance 없이 _m_build_sorted 로 트리를 바로 만든다.
+   * 그 외에는 end() 를 hint 로 넣어서 정렬된 입력이면 탐색 없이 맨 오른쪽에 붙인다.
+   */
+  template<class InputIterator>
+  void insert_unique(InputIterator first, InputIterator last) {
+    _m_insert_range_unique(first, last, typename iterator_traits<InputIterator>::iterator_category());
+  }
+
+  /**
+   * @brief insert range which the caller guarantees to be sorted by key_comp() without duplicated keys
+   *
+   * 정렬 확인을 생략한다. 조건을 지키지 않으면 트리가 망가진다.
+   */
+  template<class InputIterator>
+  void insert_sorted_unique(InputIterator first, InputIterator last) {
+    _m_insert_sorted_unique(first, last, typename iterator_traits<InputIterator>::iterator_category());
+  }
+
+  void erase(iterator position) {
+    _link_type _y = (_link_type) _rb_tree_rebalance_for_erase(position._m_node,
+                                                              _m_root(),
+                                                              _m_impl._m_header._m_left,
+                                                              _m_impl._m_header._m_right,
+                                                              OrderStatistic, _s_shared_links);
+    _m_drop_node(_y);
+    --_m_impl._m_node_count;
+  }
+
+  /**
+   * @brief remove key of the element from map
+   * @param k key
+   * @return number of element erased
+   */
+  size_type erase(const key_type &k) {
+    pair<iterator, iterator> _p = equal_range(k);
+    size_type _n = _m_distance(_p.first, _p.second);
+    erase(_p.first, _p.second);
+    return _n;
+  }
+
+  void erase(iterator first, iterator last) {
+    if (first == begin() && last == end()) {
+      clear();
+    } else {
+      while (first != last) erase(first++);
+    }
+  }
+
+  void clear() {
+    if (_m_impl._m_node_count != 0) {
+      if (!_m_release_nodes(integral_constant<bool, is_pool_allocator<_node_allocator>::value
+          && is_trivially_destructible<Val>::value>()) && !_m_defer_erase())
+        _m_erase(static_cast<_link_type>(_m_root()));
+      _m_leftmost() = _m_end();
+      _s_set_link(_m_root(), 0);
       _m_rightmost() = _m_end();
       _m_impl._m_node_count = 0;
+      _m_thread_header();
     }
   }
 
+  /**
+   * @brief let clear() and the destructor detach the nodes in O(1) and free them on a background thread
+   *
+   * 큰 트리를 지울 때 호출한 thread 가 모든 노드를 방문하지 않게 한다. thread safe 한 allocator 에서만 동작하고,
+   * 작은 트리나 기다리는 노드가 set_deferred_destruction_limit 를 넘으면 평소처럼 바로 해제한다.
+   * 값의 소멸자가 다른 thread 에서 불리므로 소멸자가 thread 에 묶인 일을 하면 쓰지 않는다.
+   */
+  void set_deferred_destruction(bool on) { _m_impl._m_defer_destroy = on; }
+  bool deferred_destruction() const { return _m_impl._m_defer_destroy; }
+
   /**
    * @brief insert node and rebalance tree
    * @param x target node position
@@ -687,78 +1580,868 @@ class _rb_tree {
    * insert 는 항상 leaf node 에 된다. -> bst insert 와 같은 원리
    */
   iterator _m_insert(_base_ptr x, _base_ptr y, const value_type &val) {
-    _link_type _x = (_link_type) x;
+    bool _insert_left = _m_insert_left(x, y, KeyOfValue()(val));
+    return _m_link_node(_insert_left, y, _m_create_node(val));
+  }
+
+  // root 노드가 없거나 key 가 부모 노드의 키 값보다 작은 경우 (key < parent) 왼쪽
+  bool _m_insert_left(_base_ptr x, _base_ptr y, const key_type &k) const {
+    return y == _m_end() || x != 0 || _m_impl._m_key_compare(k, _s_key(y));
+  }
+
+  /**
+   * @brief link the detached node z as a child of y and rebalance, no allocation
+   * @param insert_left z becomes the left child of y (see _m_insert_left)
+   */
+  iterator _m_link_node(bool insert_left, _base_ptr y, _link_type z) {
     _link_type _y = (_link_type) y;
-    _link_type _z;
-
-    if (_y == &this->_m_impl._m_header || _x != 0
-        || _m_impl._m_key_compare(KeyOfValue()(val), KeyOfValue()(_y->_m_value_field))) {
-      // root 노드가 없는 경우
-      // val 의 키 값이 부모 노드의 키 값보다 작은 경우 (val < parent)
-      _z = _m_create_node(val);
-      _s_left(_y) = _z;
+
+    // z may be a recycled block an optimistic reader still looks at : clear its links before publishing it
+    _s_set_link(z->_m_left, 0);
+    _s_set_link(z->_m_right, 0);
+    if (insert_left) {
+      _s_set_link(_y->_m_left, z);
       if (_y == &this->_m_impl._m_header) {
-        _m_root() = _z;
-        _m_rightmost() = _z;
+        _s_set_link(_m_root(), z);
+        _m_rightmost() = z;
       } else if (_y == _m_leftmost()) {
-        _m_leftmost() = _z;
+        _m_leftmost() = z;
       }
     } else {
-      // val 의 키 값이 부모 노드의 키 값보다 큰 경우 (val > parent)
-      _z = _m_create_node(val);
-      _s_right(_y) = _z;
+      _s_set_link(_y->_m_right, z);
       if (_y == _m_rightmost()) {
-        _m_rightmost() = _z;
+        _m_rightmost() = z;
       }
     }
-    _s_parent(_z) = _y;
-    _s_left(_z) = 0;
-    _s_right(_z) = 0;
-    _rb_tree_rebalance(_z, this->_m_impl._m_header._m_parent);
+    z->_m_set_parent(_y);
+    z->_m_set_size(1);
+    _rb_tree_rebalance(z, _m_root(), OrderStatistic, _s_shared_links);
     ++(this->_m_impl._m_node_count);
-    return iterator(_z);
+    return iterator(z);
   }
 
-  //
-  _link_type _m_copy(_link_type x, _link_type p) {
-    // top node clone
-    // insert 문으로 하게 되면 -> rebalance 하는데에 너무 많은 리소스가 들어가게됨
-    _link_type _top = _m_clone_node(x);
-    _top->_m_parent = p;
+  template<class InputIterator>
+  void _m_insert_range_unique(InputIterator first, InputIterator last, std::input_iterator_tag) {
+    for (; first != last; ++first)
+      insert_unique(end(), *first);
+  }
 
+  template<class ForwardIterator>
+  void _m_insert_range_unique(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+    if (empty()) {
+      size_type _n = _m_sorted_unique_length(first, last);
+      if (_n != 0) {
+        _m_build_sorted(first, _n);
+        return;
+      }
+    }
+    _m_insert_range_unique(first, last, std::input_iterator_tag());
+  }
+
+  template<class InputIterator>
+  void _m_insert_sorted_unique(InputIterator first, InputIterator last, std::input_iterator_tag) {
+    _m_insert_range_unique(first, last, std::input_iterator_tag());
+  }
+
+  template<class ForwardIterator>
+  void _m_insert_sorted_unique(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+    if (empty())
+      _m_build_sorted(first, std::distance(first, last));
+    else
+      _m_insert_range_unique(first, last, std::input_iterator_tag());
+  }
+
+  /**
+   * @return length of [first, last) if the keys are strictly increasing, otherwise 0
+   */
+  template<class ForwardIterator>
+  size_type _m_sorted_unique_length(ForwardIterator first, ForwardIterator last) const {
+    if (first == last)
+      return 0;
+    size_type _n = 1;
+    ForwardIterator _prev = first;
+    for (++first; first != last; ++first, ++_n) {
+      if (!_m_impl._m_key_compare(KeyOfValue()(*_prev), KeyOfValue()(*first)))
+        return 0;
+      _prev = first;
+    }
+    return _n;
+  }
+
+  /**
+   * @brief build the whole tree from n sorted unique values without any rotation (tree must be empty)
+   *
+   * 가운데 값을 root 로 하는 완전 균형 트리를 만들고, 가장 깊은 level (depth == floor(log2(n))) 만 red 로 칠한다.
+   * 모든 leaf 가 그 level 이나 바로 위 level 에 있으므로 black height 가 모두 같아진다.
+   */
+  template<class ForwardIterator>
+  void _m_build_sorted(ForwardIterator first, size_type n) {
+    if (n == 0)
+      return;
+    _m_root() = _m_build_sorted(first, n, 0, _s_red_depth(n), _m_end());
+    _m_leftmost() = _rb_tree_node_base::_s_minimum(_m_root());
+    _m_rightmost() = _rb_tree_node_base::_s_maximum(_m_root());
+    _m_impl._m_node_count = n;
+    _m_thread_all();
+  }
+
+  /**
+   * @brief link n values of first (in order) under p, same direct linking as _m_copy
+   * @param first advanced past the consumed values
+   * @param depth depth of the returned subtree root
+   * @param red_depth nodes on this depth are red
+   * @return subtree root
+   */
+  template<class ForwardIterator>
+  _link_type _m_build_sorted(ForwardIterator &first, size_type n, size_type depth, size_type red_depth,
+                             _base_ptr p) {
+    if (n == 0)
+      return 0;
+    size_type _left_n = (n - 1) / 2;
+    _link_type _left = _m_build_sorted(first, _left_n, depth + 1, red_depth, 0);
+    _link_type _top;
     try {
-      if (x->_m_right) {
-        _top->_m_right = _m_copy(_s_right(x), _top);
+      _top = _m_create_node(*first);
+    } catch (...) {
+      _m_erase(_left);
+      throw;
+    }
+    ++first;
+    _top->_m_set_color((depth == red_depth && depth != 0) ? _s_red : _s_black);
+    _top->_m_set_size(n);
+    _top->_m_set_parent(p);
+    _top->_m_left = _left;
+    _top->_m_right = 0;
+    if (_left)
+      _left->_m_set_parent(_top);
+    try {
+      _top->_m_right = _m_build_sorted(first, n - _left_n - 1, depth + 1, red_depth, _top);
+    } catch (...) {
+      _m_erase(_top);
+      throw;
+    }
+    return _top;
+  }
+
+  /**
+   * @brief clone the subtree x (same shape, colors and sizes) under p, without recursion
+   * @return root of the clone
+   *
+   * 원본을 in-order 로 훑으면서 복사하므로 복사본의 노드는 key 순서대로 할당된다 (순회할 때 메모리를 순서대로 읽음).
+   * 방문할 원본 노드는 고정 크기 stack 에 쌓는다. red-black 트리의 높이는 2 * log2(n + 1) 을 넘지 않으므로
+   * size_type 의 bit 수 두 배면 충분하다. 부모가 아직 없는 노드는 _m_parent 에
+   * "오른쪽 subtree 를 만드는 중인 가장 가까운 조상" 을 임시로 넣어두고, 부모를 만들 때 그 값을 물려준다.
+   */
+  _link_type _m_copy(_link_type x, _link_type p) {
+    struct _entry {
+      _const_base_ptr _m_src;
+      _base_ptr _m_pending; // temporary parent of the clone of _m_src
+    } _stack[2 * sizeof(size_type) * CHAR_BIT];
+    size_type _top = 0;
+    _base_ptr _c = 0; // clone of the subtree completed last
+    for (_const_base_ptr _s = x; _s != 0; _s = _s->_m_left) {
+      _stack[_top]._m_src = _s;
+      _stack[_top++]._m_pending = p;
+    }
+    for (;;) {
+      // visit the top : its left subtree (if any) is _c
+      const _entry _e = _stack[--_top];
+      _base_ptr _d;
+      try {
+        _d = _m_clone_node((_link_type) _e._m_src);
+      } catch (...) {
+        _m_copy_unwind(_e._m_src->_m_left ? _c : 0, _e._m_src->_m_left ? _c->_m_get_parent() : _e._m_pending, p);
+        throw;
+      }
+      if (_e._m_src->_m_left) {
+        _d->_m_set_parent(_c->_m_get_parent());
+        _c->_m_set_parent(_d);
+        _d->_m_left = _c;
+      } else {
+        _d->_m_set_parent(_e._m_pending);
+        _d->_m_left = 0;
       }
-      p = _top;
-      x = _s_left(x);
-
-      while (x != 0) {
-        _link_type _y = _m_clone_node(x);
-        p->_m_left = _y;
-        _y->_m_parent = p;
-        if (x->_m_right)
-          _y->_m_right = _m_copy(_s_right(x), _y);
-        p = _y;
-        x = _s_left(x);
+      _d->_m_right = 0;
+      if (_e._m_src->_m_right) {
+        for (_const_base_ptr _s = _e._m_src->_m_right; _s != 0; _s = _s->_m_left) {
+          _stack[_top]._m_src = _s;
+          _stack[_top++]._m_pending = _d;
+        }
+        continue;
       }
-    } catch (std::exception &e) {
+      // every pending parent below the next node to visit now has its whole right subtree
+      _base_ptr _stop = _top ? _stack[_top - 1]._m_pending : p;
+      for (_c = _d; _c->_m_get_parent() != _stop; _c = _c->_m_get_parent())
+        _c->_m_get_parent()->_m_right = _c;
+      if (_top == 0)
+        return (_link_type) _c;
+    }
+  }
+
+  // free what _m_copy built before a clone failed : c (completed subtree) and the chain of pending parents up to p
+  void _m_copy_unwind(_base_ptr c, _base_ptr pending, _base_ptr p) {
+    if (c)
+      _m_erase((_link_type) c);
+    while (pending != p) {
+      _base_ptr _next = pending->_m_get_parent();
+      pending->_m_right = 0;
+      _m_erase((_link_type) pending);
+      pending = _next;
+    }
+  }
+
+
+  // smaller trees are not worth starting threads for
+  enum { _s_parallel_copy_min = 1 << 16 };
+
+  struct _copy_task {
+    _link_type _m_src;
+    _link_type _m_parent;
+    _link_type *_m_slot;
+    bool _m_failed;
+  };
+
+  struct _copy_job {
+    _rb_tree *_m_tree;
+    size_type _m_depth;  // subtrees rooted at this depth become tasks
+    size_type _m_count;
+    _copy_task _m_tasks[_s_parallel_max_threads * 8];
+  };
+
+  /**
+   * @brief _m_copy on several threads, n is the number of nodes under x
+   *
+   * task 가 실패하면 (bad_alloc 등) 이 thread 에서 다시 복사해서 예외가 여기서 나오게 한다.
+   */
+  _link_type _m_copy_parallel(_link_type x, _link_type p, size_type n, unsigned threads) {
+    if (threads == 0)
+      threads = _rb_tree_hardware_threads();
+    if (threads > _s_parallel_max_threads)
+      threads = _s_parallel_max_threads;
+    if (threads < 2 || n < _s_parallel_copy_min || !is_thread_safe_allocator<_node_allocator>::value)
+      return _m_copy(x, p);
+
+    // about 8 tasks per thread so that uneven subtrees still keep every thread busy
+    _copy_job _job;
+    _job._m_tree = this;
+    _job._m_depth = 0;
+    _job._m_count = 0;
+    while ((size_type(1) << _job._m_depth) < size_type(threads) * 8)
+      ++_job._m_depth;
+    _link_type _top = 0;
+    try {
+      _m_copy_top(x, p, _top, 0, _job);
+    } catch (...) {
       _m_erase(_top);
-      throw e;
+      throw;
+    }
+    _rb_tree_run_parallel(&_s_copy_task, &_job, _job._m_count, threads);
+    try {
+      for (size_type i = 0; i < _job._m_count; ++i) {
+        _copy_task &_t = _job._m_tasks[i];
+        if (_t._m_failed)
+          *_t._m_slot = _m_copy(_t._m_src, _t._m_parent);
+      }
+    } catch (...) {
+      _m_erase(_top);
+      throw;
+    }
+    return _top;
+  }
+
+  // clone the levels above the task depth, slot is where the clone of x goes (0 until its task ran)
+  void _m_copy_top(_link_type x, _link_type p, _link_type &slot, size_type depth, _copy_job &job) {
+    if (depth == job._m_depth) {
+      _copy_task &_t = job._m_tasks[job._m_count++];
+      _t._m_src = x;
+      _t._m_parent = p;
+      _t._m_slot = &slot;
+      _t._m_failed = false;
+      return;
+    }
+    slot = _m_clone_node(x);
+    slot->_m_set_parent(p);
+    slot->_m_left = 0;
+    slot->_m_right = 0;
+    if (x->_m_left)
+      _m_copy_top(_s_left(x), slot, _s_left(slot), depth + 1, job);
+    if (x->_m_right)
+      _m_copy_top(_s_right(x), slot, _s_right(slot), depth + 1, job);
+  }
+
+  static void _s_copy_task(void *job, size_t i) {
+    _copy_job &_job = *static_cast<_copy_job *>(job);
+    _copy_task &_t = _job._m_tasks[i];
+    try {
+      *_t._m_slot = _job._m_tree->_m_copy(_t._m_src, _t._m_parent);
+    } catch (...) {
+      _t._m_failed = true;
+    }
+  }
+
+  static size_type _s_size(_const_base_ptr x) { return x ? x->_m_get_size() : 0; }
+
+  // threaded layout : link the header with the current leftmost / rightmost (after swap, clear)
+  void _m_thread_header() {
+#ifdef FT_RB_TREE_THREADED
+    _base_ptr _h = _m_end();
+    _h->_m_next = _m_leftmost();
+    _h->_m_prev = _m_rightmost();
+    _m_leftmost()->_m_prev = _h;
+    _m_rightmost()->_m_next = _h;
+#endif
+  }
+
+  // threaded layout : make b the successor of a
+  static void _s_thread_link(_base_ptr a, _base_ptr b) {
+#ifdef FT_RB_TREE_THREADED
+    a->_m_next = b;
+    b->_m_prev = a;
+#else
+    (void) a;
+    (void) b;
+#endif
+  }
+
+  // install a tree linked by hand : root (0 if empty), its leftmost and rightmost
+  void _m_set_root(_base_ptr root, _base_ptr leftmost, _base_ptr rightmost) {
+    _m_root() = root;
+    if (root)
+      root->_m_set_parent(_m_end());
+    _m_leftmost() = leftmost;
+    _m_rightmost() = rightmost;
+    _m_thread_header();
+  }
+
+  /**
+   * @brief cut the subtree x (black height xh) into l (keys less than k) and r (the others)
+   * @param lh, rh black heights of the results
+   *
+   * 경로 위의 노드마다 그 노드와 경로 밖의 subtree 를 반대쪽 결과에 join 한다.
+   * black height 는 내려가면서 계산하고, join 비용이 두 트리의 black height 차이에 비례하므로 전체는 O(log n).
+   */
+  void _m_split(_base_ptr x, size_type xh, const key_type &k, _base_ptr &l, size_type &lh,
+                _base_ptr &r, size_type &rh) {
+    if (x == 0) {
+      l = 0;
+      r = 0;
+      lh = 0;
+      rh = 0;
+      return;
+    }
+    _base_ptr _left = x->_m_left;
+    _base_ptr _right = x->_m_right;
+    size_type _child_h = xh - (x->_m_get_color() == _s_black);
+    _base_ptr _mid;
+    size_type _mid_h;
+    if (_m_impl._m_key_compare(_s_key(x), k)) {
+      _m_split(_right, _child_h, k, _mid, _mid_h, r, rh);
+      l = _rb_tree_join(_left, _child_h, x, _mid, _mid_h, _m_end(), lh, OrderStatistic);
+    } else {
+      _m_split(_left, _child_h, k, l, lh, _mid, _mid_h);
+      r = _rb_tree_join(_mid, _mid_h, x, _right, _child_h, _m_end(), rh, OrderStatistic);
+    }
+  }
+
+  // number of nodes left in this tree after split() from n nodes
+  size_type _m_split_count(const _rb_tree &right, size_type n) const {
+    if (OrderStatistic)
+      return _s_size(_m_root());
+    // count both trees in lockstep and stop at the end of the smaller one
+    const_iterator _l = begin();
+    const_iterator _r = right.begin();
+    size_type _c = 0;
+    for (; _l != end() && _r != right.end(); ++_l, ++_r)
+      ++_c;
+    return _l == end() ? _c : n - _c;
+  }
+
+  static const value_type &_s_value(_const_base_ptr x) { return *static_cast<_const_link_type>(x)->_m_valptr(); }
+
+  enum _set_op { _s_union, _s_intersection, _s_difference };
+
+  // nodes linked in key order through _m_left, the other links are untouched until _m_link_chain
+  struct _node_chain {
+    _base_ptr _m_head;
+    _base_ptr *_m_tail;
+    size_type _m_size;
+
+    _node_chain() : _m_head(0), _m_tail(&_m_head), _m_size(0) {}
+
+    void push(_base_ptr x) {
+      *_m_tail = x;
+      _m_tail = &x->_m_left;
+      ++_m_size;
+    }
+    _base_ptr close() {
+      *_m_tail = 0;
+      return _m_head;
+    }
+
+   private:
+    _node_chain(const _node_chain &);
+    _node_chain &operator=(const _node_chain &);
+  };
+
+  /**
+   * @brief decides what happens to each node met by _m_merge_walk
+   *
+   * steal 이면 노드 자체를 _m_keep 에 엮고 버릴 노드는 _m_dropped 에 모아둔다 (walk 가 끝난 뒤에 해제).
+   * key 마다 많아야 하나만 버려지므로 _m_dropped 도 key 순서이고 key 가 겹치지 않는다.
+   * 아니면 남길 값만 out 의 새 노드로 복사한다.
+   */
+  template<class Resolve>
+  struct _set_builder {
+    _rb_tree &_m_out;
+    _set_op _m_op;
+    bool _m_steal;
+    Resolve _m_resolve;
+    _node_chain _m_keep;
+    _node_chain _m_dropped;
+
+    _set_builder(_rb_tree &out, _set_op op, bool steal, Resolve resolve)
+        : _m_out(out), _m_op(op), _m_steal(steal), _m_resolve(resolve) {}
+
+    // key only in the first tree
+    void first(_base_ptr x) {
+      if (_m_op == _s_intersection)
+        _m_drop(x);
+      else
+        _m_take(x);
+    }
+    // key only in the second tree
+    void second(_base_ptr y) {
+      if (_m_op == _s_union)
+        _m_take(y);
     }
+    // key in both trees
+    void both(_base_ptr x, _base_ptr y) {
+      if (_m_op == _s_difference) {
+        _m_drop(x);
+      } else if (_m_op == _s_union && !_m_resolve(_s_value(x), _s_value(y))) {
+        _m_take(y);
+        _m_drop(x);
+      } else {
+        _m_take(x);
+        if (_m_op == _s_union)
+          _m_drop(y);
+      }
+    }
+
+    void _m_take(_base_ptr x) { _m_keep.push(_m_steal ? x : _m_out._m_create_node(_s_value(x))); }
+    void _m_drop(_base_ptr x) {
+      if (_m_steal)
+        _m_dropped.push(x);
+    }
+  };
+
+  /**
+   * @brief visit the nodes of [x, x_end) and [y, y_end) in key order, equal keys together
+   *
+   * 다음 노드를 먼저 구한 뒤에 action 을 부르므로 action 은 넘겨받은 노드의 _m_left 를 바꿔도 된다.
+   * (_rb_tree_increment 는 아직 방문하지 않은 노드의 _m_left 와 parent, _m_right 만 읽는다)
+   * 예외가 나면 x, y 는 아직 action 에 넘기지 않은 첫 노드에 남는다.
+   */
+  template<class Action>
+  void _m_merge_walk(_base_ptr &x, _base_ptr x_end, _base_ptr &y, _base_ptr y_end, Action &act) const {
+    _base_ptr _next;
+    while (x != x_end && y != y_end) {
+      if (_m_impl._m_key_compare(_s_key(x), _s_key(y))) {
+        _next = _rb_tree_increment(x);
+        act.first(x);
+        x = _next;
+      } else if (_m_impl._m_key_compare(_s_key(y), _s_key(x))) {
+        _next = _rb_tree_increment(y);
+        act.second(y);
+        y = _next;
+      } else {
+        _base_ptr _next_y = _rb_tree_increment(y);
+        _next = _rb_tree_increment(x);
+        act.both(x, y);
+        x = _next;
+        y = _next_y;
+      }
+    }
+    for (; x != x_end; x = _next) {
+      _next = _rb_tree_increment(x);
+      act.first(x);
+    }
+    for (; y != y_end; y = _next) {
+      _next = _rb_tree_increment(y);
+      act.second(y);
+    }
+  }
+
+  // intersect / subtract : relink the nodes of this tree that stay
+  void _m_retain(const _rb_tree &other, _set_op op) {
+    if (empty())
+      return;
+    _set_builder<keep_first> _b(*this, op, true, keep_first());
+    _base_ptr _x = _m_leftmost();
+    _base_ptr _y = const_cast<_base_ptr>(other._m_leftmost());
+    try {
+      _m_merge_walk(_x, _m_end(), _y, const_cast<_base_ptr>(other._m_end()), _b);
+    } catch (...) {
+      // key_compare threw : what was dropped so far stays dropped, the rest is kept
+      _s_chain_rest(_b._m_keep, _x, _m_end());
+      _m_drop_chain(_b._m_dropped);
+      _m_link_chain(_b._m_keep);
+      throw;
+    }
+    _m_drop_chain(_b._m_dropped);
+    _m_link_chain(_b._m_keep);
+  }
+
+  template<class Resolve>
+  void _m_assign_set(const _rb_tree &a, const _rb_tree &b, _set_op op, Resolve resolve) {
+    if (&a == this || &b == this) {
+      _rb_tree _tmp(_m_impl._m_key_compare, get_allocator());
+      _tmp._m_assign_set(a, b, op, resolve);
+      swap(_tmp);
+      return;
+    }
+    clear();
+    _set_builder<Resolve> _b(*this, op, false, resolve);
+    _base_ptr _x = const_cast<_base_ptr>(a._m_leftmost());
+    _base_ptr _y = const_cast<_base_ptr>(b._m_leftmost());
+    try {
+      _m_merge_walk(_x, const_cast<_base_ptr>(a._m_end()), _y, const_cast<_base_ptr>(b._m_end()), _b);
+    } catch (...) {
+      _m_drop_chain(_b._m_keep);
+      throw;
+    }
+    _m_link_chain(_b._m_keep);
+  }
+
+  // push the nodes of [x, end) that a merge walk did not reach, in order
+  static void _s_chain_rest(_node_chain &c, _base_ptr x, _base_ptr end) {
+    while (x != end) {
+      _base_ptr _next = _rb_tree_increment(x);
+      c.push(x);
+      x = _next;
+    }
+  }
+
+  void _m_drop_chain(_node_chain &c) {
+    for (_base_ptr _x = c.close(); _x != 0;) {
+      _base_ptr _next = _x->_m_left;
+      _m_drop_node(static_cast<_link_type>(_x));
+      _x = _next;
+    }
+  }
+
+  // make the chain the whole content of this tree, shaped like _m_build_sorted
+  void _m_link_chain(_node_chain &c) {
+    _base_ptr _first = c.close();
+    size_type _n = c._m_size;
+    if (_n == 0) {
+      _m_set_root(0, _m_end(), _m_end());
+    } else {
+      _base_ptr _root = _s_link_chain(_first, _n, 0, _s_red_depth(_n));
+      _m_set_root(_root, _rb_tree_node_base::_s_minimum(_root), _rb_tree_node_base::_s_maximum(_root));
+    }
+    _m_impl._m_node_count = _n;
+    _m_thread_all();
+  }
+
+  // link the next n nodes of chain, chain is advanced past them
+  static _base_ptr _s_link_chain(_base_ptr &chain, size_type n, size_type depth, size_type red_depth) {
+    if (n == 0)
+      return 0;
+    size_type _left_n = (n - 1) / 2;
+    _base_ptr _left = _s_link_chain(chain, _left_n, depth + 1, red_depth);
+    _base_ptr _top = chain;
+    chain = chain->_m_left;
+    _top->_m_set_color((depth == red_depth && depth != 0) ? _s_red : _s_black);
+    _top->_m_set_size(n);
+    _top->_m_left = _left;
+    if (_left)
+      _left->_m_set_parent(_top);
+    _top->_m_right = _s_link_chain(chain, n - _left_n - 1, depth + 1, red_depth);
+    if (_top->_m_right)
+      _top->_m_right->_m_set_parent(_top);
     return _top;
   }
 
-  void _m_erase(_link_type x) {
-    // erase without rebalancing
+  // depth of the red level of a perfectly balanced tree of n nodes, floor(log2(n))
+  static size_type _s_red_depth(size_type n) {
+    size_type _d = 0;
+    for (; n > 1; n >>= 1)
+      ++_d;
+    return _d;
+  }
+
+  // threaded layout : link every node, for trees linked directly without _m_insert (copy, sorted build)
+  void _m_thread_all() {
+#ifdef FT_RB_TREE_THREADED
+    _rb_tree_thread(_m_end());
+#endif
+  }
+
+  enum { _s_find_batch = 16 };
+
+  /**
+   * @brief run up to _s_find_batch lookups in lockstep, first is advanced past the keys taken
+   * @return number of results written (header for a missing key)
+   */
+  template<class ForwardIterator>
+  size_type _m_find_batch(ForwardIterator &first, ForwardIterator last, _const_base_ptr *result) const {
+    ForwardIterator _keys = first;
+    _const_base_ptr _x[_s_find_batch];
+    _const_base_ptr _y[_s_find_batch];
+    size_type _n = 0;
+    for (; _n < _s_find_batch && first != last; ++_n, ++first) {
+      _x[_n] = _m_root();
+      _y[_n] = _m_end();
+    }
+    for (bool _active = _m_root() != 0; _active;) {
+      _active = false;
+      ForwardIterator _k = _keys;
+      for (size_type i = 0; i < _n; ++i, ++_k) {
+        if (_x[i] == 0)
+          continue;
+        if (!_m_impl._m_key_compare(_s_key(_x[i]), *_k)) {
+          _y[i] = _x[i];
+          _x[i] = _x[i]->_m_left;
+        } else {
+          _x[i] = _x[i]->_m_right;
+        }
+        if (_x[i] != 0) {
+          FT_PREFETCH(static_cast<_const_link_type>(_x[i])->_m_valptr());
+          _active = true;
+        }
+      }
+    }
+    for (size_type i = 0; i < _n; ++i, ++_keys)
+      result[i] = (_y[i] == _m_end() || _m_impl._m_key_compare(*_keys, _s_key(_y[i]))) ? _m_end() : _y[i];
+    return _n;
+  }
+
+  // compile error on trees without subtree size
+  static void _s_order_statistic_only() { (void) sizeof(char[OrderStatistic ? 1 : -1]); }
+
+  template<class Iterator>
+  size_type _m_distance(Iterator first, Iterator last) const {
+    return _m_distance(first, last, integral_constant<bool, OrderStatistic>());
+  }
+  template<class Iterator>
+  size_type _m_distance(Iterator first, Iterator last, true_type) const { return last - first; }
+  template<class Iterator>
+  size_type _m_distance(Iterator first, Iterator last, false_type) const { return std::distance(first, last); }
+
+  /**
+   * @brief hand every node back to a pool allocator at once instead of visiting each node
+   * @return false if the nodes still have to be dropped one by one
+   *
+   * only used when Val has nothing to destroy, the pool refuses if it is shared with another tree.
+   */
+  bool _m_release_nodes(true_type) { return _m_get_node_allocator().release(_m_impl._m_node_count); }
+  bool _m_release_nodes(false_type) { return false; }
+
+  // erase without rebalancing
+  void _m_erase(_link_type x) { _s_erase(_m_get_node_allocator(), x); }
+
+  // below this many nodes freeing right away is cheaper than waking the reclaimer
+  enum { _s_defer_min = 1 << 12 };
+
+  struct _garbage : public _rb_tree_garbage {
+    _node_allocator _m_alloc;
+    _link_type _m_root;
+
+    _garbage(const _node_allocator &alloc, _link_type root, size_type n) : _m_alloc(alloc), _m_root(root) {
+      _m_destroy = &_s_destroy_garbage;
+      _m_nodes = n;
+      _m_next = 0;
+    }
+  };
+
+  // clear() : hand the whole node graph to the reclaimer, false if the nodes must be freed here
+  bool _m_defer_erase() {
+    if (!_m_impl._m_defer_destroy || !is_thread_safe_allocator<_node_allocator>::value
+        || _m_impl._m_node_count < _s_defer_min)
+      return false;
+    _garbage *_g = new(std::nothrow) _garbage(_m_get_node_allocator(), static_cast<_link_type>(_m_root()),
+                                              _m_impl._m_node_count);
+    if (_g == 0)
+      return false;
+    if (_rb_tree_defer_destroy(_g))
+      return true;
+    delete _g;
+    return false;
+  }
+
+  // runs on the reclaimer thread
+  static void _s_destroy_garbage(_rb_tree_garbage *g) {
+    _garbage *_g = static_cast<_garbage *>(g);
+    _s_erase(_g->_m_alloc, _g->_m_root);
+    delete _g;
+  }
+
+  // lookups shared by key_type and heterogeneous (transparent) keys
+  template<class K>
+  _const_base_ptr _m_lower_bound(const K &k) const { return _m_lower_bound(_m_root(), _m_end(), k); }
+
+  template<class K>
+  _const_base_ptr _m_upper_bound(const K &k) const { return _m_upper_bound(_m_root(), _m_end(), k); }
+
+  template<class K>
+  _const_base_ptr _m_find(const K &k) const { return _m_found(_m_lower_bound(k), k); }
+
+  // j is lower_bound(k) : j itself if its key is k, end() otherwise
+  template<class K>
+  _const_base_ptr _m_found(_const_base_ptr j, const K &k) const {
+    return (j == _m_end() || _m_impl._m_key_compare(k, _s_key(j))) ? _m_end() : j;
+  }
+
+  // lower_bound in the subtree x, y if every key of the subtree goes before k
+  template<class K>
+  _const_base_ptr _m_lower_bound(_const_base_ptr x, _const_base_ptr y, const K &k) const {
+    while (x != 0) {
+      if (!_m_impl._m_key_compare(_s_key(x), k)) {
+        y = x;
+        x = x->_m_left;
+      } else {
+        x = x->_m_right;
+      }
+    }
+    return y;
+  }
+
+  template<class K>
+  _const_base_ptr _m_upper_bound(_const_base_ptr x, _const_base_ptr y, const K &k) const {
+    while (x != 0) {
+      if (_m_impl._m_key_compare(k, _s_key(x))) {
+        y = x;
+        x = x->_m_left;
+      } else {
+        x = x->_m_right;
+      }
+    }
+    return y;
+  }
+
+  /**
+   * @brief lower_bound(k) starting from the node f instead of the root (_rb_tree_cursor)
+   *
+   * f 에서 부모로 올라가다가, 지금 subtree 의 바로 다음 조상이 k 이상이면 (또는 k <= f 일 때 바로 이전 조상이 k 미만이면)
+   * 답은 그 subtree 안 (또는 그 조상) 에 있으므로 거기서부터 내려간다.
+   */
+  template<class K>
+  _const_base_ptr _m_finger_lower_bound(_const_base_ptr f, const K &k) const {
+    if (f == _m_end())
+      return _m_lower_bound(k);
+    _const_base_ptr _x = f;
+    _const_base_ptr _y = _m_end();
+    if (_m_impl._m_key_compare(_s_key(f), k)) {
+      while (_x != _m_root()) {
+        _const_base_ptr _p = _x->_m_get_parent();
+        if (_x == _p->_m_left && !_m_impl._m_key_compare(_s_key(_p), k)) {
+          _y = _p;
+          break;
+        }
+        _x = _p;
+      }
+    } else {
+      _y = f;
+      while (_x != _m_root()) {
+        _const_base_ptr _p = _x->_m_get_parent();
+        if (_x == _p->_m_right && _m_impl._m_key_compare(_s_key(_p), k))
+          break;
+        _x = _p;
+      }
+    }
+    return _m_lower_bound(_x, _y, k);
+  }
+
+  template<class K>
+  _const_base_ptr _m_finger_upper_bound(_const_base_ptr f, const K &k) const {
+    if (f == _m_end())
+      return _m_upper_bound(k);
+    _const_base_ptr _x = f;
+    _const_base_ptr _y = _m_end();
+    if (!_m_impl._m_key_compare(k, _s_key(f))) {
+      while (_x != _m_root()) {
+        _const_base_ptr _p = _x->_m_get_parent();
+        if (_x == _p->_m_left && _m_impl._m_key_compare(k, _s_key(_p))) {
+          _y = _p;
+          break;
+        }
+        _x = _p;
+      }
+    } else {
+      _y = f;
+      while (_x != _m_root()) {
+        _const_base_ptr _p = _x->_m_get_parent();
+        if (_x == _p->_m_right && !_m_impl._m_key_compare(k, _s_key(_p)))
+          break;
+        _x = _p;
+      }
+    }
+    return _m_upper_bound(_x, _y, k);
+  }
+
+  /**
+   * @brief free the subtree x in key order without recursion (_m_erase without a tree)
+   *
+   * 왼쪽 child 가 있으면 오른쪽으로 회전시켜서 x 가 항상 남은 것 중 가장 작은 노드가 되게 한다.
+   * 회전은 노드당 최대 한 번이라 O(n) 이고, sorted 로 할당된 트리는 주소 순서대로 해제된다.
+   */
+  static void _s_erase(_node_allocator &alloc, _link_type x) {
+    allocator_type _alloc(alloc);
     while (x != 0) {
-      _m_erase(_s_right(x));
       _link_type _y = _s_left(x);
-      _m_drop_node(x);
-      x = _y;
+      if (_y != 0) {
+        x->_m_left = _y->_m_right;
+        _y->_m_right = x;
+        x = _y;
+      } else {
+        _y = _s_right(x);
+        _alloc.destroy(x->_m_valptr());
+        alloc.deallocate(x, 1);
+        x = _y;
+      }
     }
   }
 
+  /**
+   * @brief check red-black properties, order, header links and node count (for tests, O(n))
+   * @return true if the tree is a valid red-black tree
+   */
+  bool _m_verify() const {
+    if (_m_impl._m_node_count == 0 || begin() == end())
+      return _m_impl._m_node_count == 0 && begin() == end() && _m_root() == 0
+          && _m_leftmost() == _m_end() && _m_rightmost() == _m_end();
+    if (_m_root()->_m_get_color() != _s_black || _m_root()->_m_get_parent() != _m_end())
+      return false;
+    size_type _len = _rb_tree_black_count(_m_leftmost(), _m_root());
+    size_type _n = 0;
+    for (const_iterator _it = begin(); _it != end(); ++_it, ++_n) {
+      _const_base_ptr _x = _it._m_node;
+      _const_base_ptr _l = _x->_m_left;
+      _const_base_ptr _r = _x->_m_right;
+
+      if (_x->_m_get_color() == _s_red)
+        if ((_l && _l->_m_get_color() == _s_red) || (_r && _r->_m_get_color() == _s_red))
+          return false;
+      if (_l && (_l->_m_get_parent() != _x || _m_impl._m_key_compare(_s_key(_x), _s_key(_l))))
+        return false;
+      if (_r && (_r->_m_get_parent() != _x || _m_impl._m_key_compare(_s_key(_r), _s_key(_x))))
+        return false;
+      // every null link ends a path, not only the ones under a leaf
+      if ((!_l || !_r) && _rb_tree_black_count(_x, _m_root()) != _len)
+        return false;
+      if (OrderStatistic && _x->_m_get_size() != _s_size(_l) + _s_size(_r) + 1)
+        return false;
+#ifdef FT_RB_TREE_THREADED
+      if (_x->_m_next != _rb_tree_increment(_x) || _x->_m_next->_m_prev != _x)
+        return false;
+#endif
+    }
+    return _n == _m_impl._m_node_count
+        && _m_leftmost() == _rb_tree_node_base::_s_minimum(_m_root())
+        && _m_rightmost() == _rb_tree_node_base::_s_maximum(_m_root());
+  }
+
   friend bool operator==(const _rb_tree &lhs, const _rb_tree &rhs) {
     return lhs.size() == rhs.size() && equal(lhs.begin(), lhs.end(), rhs.begin());
   }
@@ -768,13 +2451,41 @@ class _rb_tree {
   }
 };
 
-void _rb_tree_rotate_left(_rb_tree_node_base *x, _rb_tree_node_base *&root);
-void _rb_tree_rotate_right(_rb_tree_node_base *x, _rb_tree_node_base *&root);
-void _rb_tree_rebalance(_rb_tree_node_base *x, _rb_tree_node_base *&root);
+/**
+ * @brief Tags that select the tree engine behind ft::map
+ *
+ * rb_tree_tag : plain red-black tree (default)
+ * rb_tree_order_statistic_tag : red-black tree keeping subtree sizes (rank, select, count_range, it + n)
+ */
+struct rb_tree_tag {};
+struct rb_tree_order_statistic_tag {};
+
+template<class Tag, class Key, class Val, class KeyOfValue, class Compare, class Alloc>
+struct _tree_rep {};
+
+template<class Key, class Val, class KeyOfValue, class Compare, class Alloc>
+struct _tree_rep<rb_tree_tag, Key, Val, KeyOfValue, Compare, Alloc> {
+  typedef _rb_tree<Key, Val, KeyOfValue, Compare, Alloc> type;
+};
+
+template<class Key, class Val, class KeyOfValue, class Compare, class Alloc>
+struct _tree_rep<rb_tree_order_statistic_tag, Key, Val, KeyOfValue, Compare, Alloc> {
+  typedef _rb_tree<Key, Val, KeyOfValue, Compare, Alloc, true> type;
+};
+
+// sized : also keep _m_size of the nodes up to date (order statistic tree)
+void _rb_tree_rotate_left(_rb_tree_node_base *x, _rb_tree_node_base *&root, bool sized = false);
+void _rb_tree_rotate_right(_rb_tree_node_base *x, _rb_tree_node_base *&root, bool sized = false);
+// x must be a new leaf, it is also threaded in (FT_RB_TREE_THREADED)
+// shared : store the child / root links atomically (has_optimistic_readers)
+void _rb_tree_rebalance(_rb_tree_node_base *x, _rb_tree_node_base *&root, bool sized = false, bool shared = false);
 _rb_tree_node_base *_rb_tree_rebalance_for_erase(_rb_tree_node_base *z,
                                                  _rb_tree_node_base *&root,
                                                  _rb_tree_node_base *&leftmost,
-                                                 _rb_tree_node_base *&rightmost);
+                                                 _rb_tree_node_base *&rightmost,
+                                                 bool sized = false,
+                                                 bool shared = false);
+size_t _rb_tree_black_count(const _rb_tree_node_base *node, const _rb_tree_node_base *root) throw();
 
 } // namespace ft
 
@@ -34,6 +34,10 @@ struct integral_constant {
   operator T() const { return v; }
 };
 
+// definition for when value is bound to a reference (ex. by EXPECT_TRUE)
+template<class T, T v>
+const T integral_constant<T, v>::value;
+
 typedef integral_constant<bool, true> true_type;
 typedef integral_constant<bool, false> false_type;
 
@@ -100,6 +104,51 @@ struct is_same : false_type {};
 template<typename T>
 struct is_same<T, T> : true_type {};
 
+/**
+ * @brief Traits class that identifies whether destroying T is a no-op
+ * @tparam T type
+ *
+ * c++98 에서는 직접 판별할 방법이 없어서 compiler builtin (gcc, clang) 을 사용한다.
+ */
+template<typename T>
+struct is_trivially_destructible : public integral_constant<bool, __has_trivial_destructor(T)> {};
+
+/**
+ * @brief Identify whether the comparator Compare declares is_transparent (accepts keys of other types)
+ * @tparam Compare comparator
+ * @tparam K type searched with, only there to make the lookup overloads depend on it (SFINAE)
+ */
+template<class Compare, class K = void>
+struct is_transparent {
+ private:
+  typedef char yes;
+  typedef long no;
+
+  template<class U>
+  static yes test(typename U::is_transparent *);
+
+  template<class U>
+  static no test(...);
+ public:
+  enum { value = sizeof(test<Compare>(0)) == sizeof(yes) };
+};
+
+template<class T1, class T2>
+struct pair;
+
+/**
+ * @brief Traits class that identifies whether T can be moved to another address with memcpy
+ * @tparam T type
+ */
+template<typename T>
+struct is_trivially_relocatable
+    : public integral_constant<bool, __has_trivial_copy(T) && __has_trivial_destructor(T)> {};
+
+// ft::pair 는 복사 생성자가 선언되어 있지만 멤버 단위 복사만 한다
+template<class T1, class T2>
+struct is_trivially_relocatable<pair<T1, T2> >
+    : public integral_constant<bool, is_trivially_relocatable<T1>::value && is_trivially_relocatable<T2>::value> {};
+
 /**
  * @brief Identify whether T has iterator_category or not
  * @tparam T type
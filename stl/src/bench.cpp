@@ -0,0 +1,870 @@
+/*
+ * File: bench.cpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "../include/set.hpp"
+#include "../include/concurrent_map.hpp"
+#include "../include/optimistic_map.hpp"
+#if defined(FT_LOCKFREE)
+#include "../include/lockfree_skiplist.hpp"
+#endif
+
+#define YELLOW "\033[0;33m"
+#define BLUE "\033[0;34m"
+#define CYAN "\033[0;36m"
+#define RESET "\033[0m"
+#define BOLD "\033[1m"
+
+typedef long long ll;
+
+#define SECONDS 1000000LL
+
+/*
+ * usage : ./bench <name> [size ...]
+ * ex) ./bench arena 1000000 10000000 100000000
+ */
+
+// results are stored here so that the compiler can not drop the measured loops
+volatile ll g_sink;
+
+ll get_time(timeval start, timeval end) {
+  return ((end.tv_sec - start.tv_sec) * SECONDS + (end.tv_usec - start.tv_usec));
+}
+
+class Timer {
+  timeval _start;
+ public:
+  Timer() { gettimeofday(&_start, NULL); }
+  ll elapsed() const {
+    timeval _end;
+    gettimeofday(&_end, NULL);
+    return get_time(_start, _end);
+  }
+};
+
+void print_result(const char *name, const char *what, ll us, size_t n) {
+  std::cout << BLUE << BOLD << name << RESET << "\t" << what << "\t" << us << " us\t"
+            << (n ? (double) us * 1000 / n : 0) << " ns/op" << std::endl;
+}
+
+// distinct keys in a random looking order (odd multiplier is a bijection of 32 bit integers)
+std::vector<int> make_keys(size_t n) {
+  std::vector<int> keys(n);
+  for (size_t i = 0; i < n; i++)
+    keys[i] = static_cast<int>(static_cast<unsigned int>(i) * 2654435761u);
+  return keys;
+}
+
+/* ****************************************************** */
+/*                 arena (32 bit links)                   */
+/* ****************************************************** */
+
+template<class Map>
+void bench_map_layout(const char *name, const std::vector<int> &keys, size_t node_size) {
+  size_t n = keys.size();
+  Map m;
+  {
+    Timer t;
+    for (size_t i = 0; i < n; i++)
+      m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+    print_result(name, "insert", t.elapsed(), n);
+  }
+  {
+    Timer t;
+    ll sum = 0;
+    for (size_t i = 0; i < n; i++)
+      sum += m.find(keys[n - 1 - i])->second;
+    print_result(name, "find  ", t.elapsed(), n);
+    g_sink = sum;
+  }
+  {
+    Timer t;
+    ll sum = 0;
+    for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+      sum += it->second;
+    print_result(name, "iterate", t.elapsed(), n);
+    g_sink = sum;
+  }
+  {
+    Timer t;
+    Map copy(m);
+    print_result(name, "copy  ", t.elapsed(), n);
+  }
+  {
+    Timer t;
+    for (size_t i = 0; i < n; i += 2)
+      m.erase(keys[i]);
+    print_result(name, "erase/2", t.elapsed(), n / 2);
+  }
+  std::cout << name << "\tnode size " << node_size << " bytes, ~" << node_size * n / (1024 * 1024)
+            << " MiB of nodes" << std::endl;
+}
+
+void bench_arena(size_t n) {
+  typedef ft::pair<const int, int> value_type;
+  std::vector<int> keys = make_keys(n);
+
+  std::cout << YELLOW << BOLD << "------------- ft::map<int, int> " << n << " -------------" << RESET << std::endl;
+  bench_map_layout<ft::map<int, int> >("pointer", keys, sizeof(ft::_rb_tree_node<value_type>));
+  bench_map_layout<ft::map<int, int, std::less<int>, std::allocator<value_type>, ft::rb_tree_arena_tag> >(
+      "arena  ", keys, sizeof(ft::_rb_arena_node<value_type>));
+}
+
+/* ****************************************************** */
+/*                 find_many (batched lookup)             */
+/* ****************************************************** */
+
+void bench_find_many(size_t n) {
+  typedef ft::map<int, int> map_type;
+  const size_t batch = 256;
+  const size_t lookups = 4000000;
+  std::vector<int> keys = make_keys(n);
+  map_type m;
+  for (size_t i = 0; i < n; i++)
+    m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+
+  // half of the probes miss
+  std::vector<int> probes(lookups);
+  for (size_t i = 0; i < lookups; i++)
+    probes[i] = (i & 1) ? keys[(i * 7919) % n] : static_cast<int>((i * 40503u) ^ 0x5bd1e995u);
+  std::vector<map_type::iterator> found(batch);
+
+  std::cout << YELLOW << BOLD << "------------- ft::map<int, int> " << n << ", batches of " << batch
+            << " -------------" << RESET << std::endl;
+  ll sum = 0;
+  {
+    Timer t;
+    for (size_t i = 0; i + batch <= lookups; i += batch) {
+      for (size_t j = 0; j < batch; j++)
+        found[j] = m.find(probes[i + j]);
+      sum += found[batch - 1] == m.end();
+    }
+    print_result("find     ", "", t.elapsed(), lookups);
+  }
+  {
+    Timer t;
+    for (size_t i = 0; i + batch <= lookups; i += batch) {
+      m.find_many(probes.begin() + i, probes.begin() + i + batch, found.begin());
+      sum += found[batch - 1] == m.end();
+    }
+    print_result("find_many", "", t.elapsed(), lookups);
+  }
+  g_sink = sum;
+}
+
+/* ****************************************************** */
+/*                 frozen (Eytzinger array)               */
+/* ****************************************************** */
+
+// same order as std::less, but not recognized by frozen_map : keeps the Eytzinger layout
+struct int_less {
+  bool operator()(int x, int y) const { return x < y; }
+};
+
+void bench_frozen(size_t n) {
+  typedef ft::map<int, int> map_type;
+  typedef ft::frozen_map<int, int> frozen_type;
+  typedef ft::frozen_map<int, int, int_less> eytzinger_type;
+  const size_t lookups = 4000000;
+  std::vector<int> keys = make_keys(n);
+  map_type m;
+  for (size_t i = 0; i < n; i++)
+    m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+
+  std::cout << YELLOW << BOLD << "------------- ft::map<int, int> " << n << " -------------" << RESET << std::endl;
+  frozen_type f;
+  {
+    Timer t;
+    f = m.freeze();
+    print_result("freeze", "      ", t.elapsed(), n);
+  }
+  eytzinger_type e(m.begin(), m.end());
+  ll sum = 0;
+  {
+    Timer t;
+    for (size_t i = 0; i < lookups; i++)
+      sum += m.lower_bound(keys[(i * 7919) % n] - 1)->second;
+    print_result("map   ", "lower_bound", t.elapsed(), lookups);
+  }
+  {
+    Timer t;
+    for (size_t i = 0; i < lookups; i++)
+      sum += e.lower_bound(keys[(i * 7919) % n] - 1).value();
+    print_result("eytzinger", "lower_bound", t.elapsed(), lookups);
+  }
+  {
+    Timer t;
+    for (size_t i = 0; i < lookups; i++)
+      sum += f.lower_bound(keys[(i * 7919) % n] - 1).value();
+    print_result("block ", "lower_bound", t.elapsed(), lookups);
+  }
+  {
+    Timer t;
+    for (map_type::const_iterator it = m.begin(); it != m.end(); ++it)
+      sum += it->second;
+    print_result("map   ", "iterate", t.elapsed(), n);
+  }
+  {
+    Timer t;
+    for (frozen_type::iterator it = f.begin(); it != f.end(); ++it)
+      sum += it.value();
+    print_result("frozen", "iterate", t.elapsed(), n);
+  }
+  g_sink = sum;
+}
+
+/* ****************************************************** */
+/*                 scan (full iteration)                  */
+/* ****************************************************** */
+
+// build twice, with and without -DFT_RB_TREE_THREADED, to compare the node layouts
+void bench_scan(size_t n) {
+  typedef ft::map<int, int> map_type;
+  std::vector<int> keys = make_keys(n);
+  map_type m;
+  for (size_t i = 0; i < n; i++)
+    m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+
+#ifdef FT_RB_TREE_THREADED
+  const char *layout = "threaded";
+#else
+  const char *layout = "parent  ";
+#endif
+  std::cout << YELLOW << BOLD << "------------- ft::map<int, int> " << n << ", node size "
+            << sizeof(ft::_rb_tree_node<map_type::value_type>) << " -------------" << RESET << std::endl;
+  ll sum = 0;
+  {
+    Timer t;
+    for (map_type::const_iterator it = m.begin(); it != m.end(); ++it)
+      sum += it->second;
+    print_result(layout, "++", t.elapsed(), n);
+  }
+  {
+    Timer t;
+    for (map_type::const_reverse_iterator it = m.rbegin(); it != m.rend(); ++it)
+      sum += it->second;
+    print_result(layout, "--", t.elapsed(), n);
+  }
+  {
+    // successors close in memory : nodes allocated in key order
+    map_type sorted(m.begin(), m.end());
+    Timer t;
+    for (map_type::const_iterator it = sorted.begin(); it != sorted.end(); ++it)
+      sum += it->second;
+    print_result(layout, "++ (sorted alloc)", t.elapsed(), n);
+  }
+  g_sink = sum;
+}
+
+/* ****************************************************** */
+/*                 merge (set algebra)                    */
+/* ****************************************************** */
+
+void bench_merge(size_t n) {
+  typedef ft::map<int, int> map_type;
+  std::vector<int> keys = make_keys(n * 2);
+  map_type a;
+  map_type b;
+  // half of the keys of b are also in a
+  for (size_t i = 0; i < n; i++) {
+    a.insert(ft::make_pair(keys[i], 1));
+    b.insert(ft::make_pair(keys[i + n / 2], 2));
+  }
+
+  std::cout << YELLOW << BOLD << "------------- ft::map<int, int> " << n << " + " << n << " -------------" << RESET
+            << std::endl;
+  {
+    map_type dst(a);
+    Timer t;
+    dst.insert(b.begin(), b.end());
+    print_result("insert(first, last)", "", t.elapsed(), n);
+    g_sink = dst.size();
+  }
+  {
+    map_type dst;
+    Timer t;
+    dst.assign_union(a, b);
+    print_result("assign_union", "", t.elapsed(), 2 * n);
+    g_sink = dst.size();
+  }
+  {
+    map_type dst(a);
+    map_type src(b);
+    Timer t;
+    dst.merge(src);
+    print_result("merge (steal)", "", t.elapsed(), 2 * n);
+    g_sink = dst.size();
+  }
+  {
+    map_type dst(a);
+    Timer t;
+    dst.subtract(b);
+    print_result("subtract", "", t.elapsed(), 2 * n);
+    g_sink = dst.size();
+  }
+}
+
+/* ****************************************************** */
+/*                 copy (parallel clone)                  */
+/* ****************************************************** */
+
+void bench_copy(size_t n) {
+  typedef ft::map<int, int> map_type;
+  std::vector<int> keys = make_keys(n);
+  map_type m;
+  for (size_t i = 0; i < n; i++)
+    m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+
+  std::cout << YELLOW << BOLD << "------------- ft::map<int, int> " << n << ", " << ft::_rb_tree_hardware_threads()
+            << " cpus -------------" << RESET << std::endl;
+  {
+    Timer t;
+    map_type copy(m);
+    print_result("copy      ", "", t.elapsed(), n);
+  }
+  for (unsigned threads = 1; threads <= 16; threads *= 2) {
+    Timer t;
+    map_type copy(m, ft::parallel_copy(threads));
+    std::cout << threads << " ";
+    print_result("threads", "", t.elapsed(), n);
+  }
+}
+
+/* ****************************************************** */
+/*                 clear (deferred destruction)           */
+/* ****************************************************** */
+
+void bench_clear(size_t n) {
+  typedef ft::map<int, int> map_type;
+  std::vector<int> keys = make_keys(n);
+
+  std::cout << YELLOW << BOLD << "------------- ft::map<int, int> " << n << " -------------" << RESET << std::endl;
+  for (int deferred = 0; deferred < 2; deferred++) {
+    map_type m;
+    m.set_deferred_destruction(deferred);
+    for (size_t i = 0; i < n; i++)
+      m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+    Timer t;
+    m.clear();
+    print_result(deferred ? "deferred" : "inline  ", "clear", t.elapsed(), n);
+  }
+  Timer t;
+  ft::flush_deferred_destruction();
+  print_result("reclaimer", "flush", t.elapsed(), n);
+}
+
+/* ****************************************************** */
+/*                 teardown (iterative copy / erase)      */
+/* ****************************************************** */
+
+typedef ft::pair<const int, int> int_pair;
+typedef ft::_rb_tree<int, int_pair, ft::Select1st<int_pair>, std::less<int> > int_tree;
+
+// the recursive _m_copy / _m_erase replaced by the iterative ones, kept here for comparison
+struct recursive_tree : public int_tree {
+  _link_type recursive_copy(_link_type x, _link_type p) {
+    _link_type _top = _m_clone_node(x);
+    _top->_m_set_parent(p);
+    if (x->_m_right)
+      _top->_m_right = recursive_copy(_s_right(x), _top);
+    p = _top;
+    x = _s_left(x);
+    while (x != 0) {
+      _link_type _y = _m_clone_node(x);
+      p->_m_left = _y;
+      _y->_m_set_parent(p);
+      if (x->_m_right)
+        _y->_m_right = recursive_copy(_s_right(x), _y);
+      p = _y;
+      x = _s_left(x);
+    }
+    return _top;
+  }
+
+  void recursive_erase(_link_type x) {
+    while (x != 0) {
+      recursive_erase(_s_right(x));
+      _link_type _y = _s_left(x);
+      _m_drop_node(x);
+      x = _y;
+    }
+  }
+
+  void copy_from(const recursive_tree &x) {
+    _base_ptr _root = recursive_copy((_link_type) x._m_root(), _m_end());
+    _m_set_root(_root, ft::_rb_tree_node_base::_s_minimum(_root), ft::_rb_tree_node_base::_s_maximum(_root));
+    _m_impl._m_node_count = x.size();
+    _m_thread_all();
+  }
+
+  void recursive_clear() {
+    recursive_erase(static_cast<_link_type>(_m_root()));
+    _m_set_root(0, _m_end(), _m_end());
+    _m_impl._m_node_count = 0;
+  }
+};
+
+template<class Tree>
+ll bench_iterate(const Tree &t) {
+  ll sum = 0;
+  for (typename Tree::const_iterator it = t.begin(); it != t.end(); ++it)
+    sum += it->second;
+  return sum;
+}
+
+void bench_teardown(size_t n) {
+  std::vector<int> keys = make_keys(n);
+  recursive_tree src;
+  for (size_t i = 0; i < n; i++)
+    src.insert_unique(int_pair(keys[i], static_cast<int>(i)));
+
+  std::cout << YELLOW << BOLD << "------------- _rb_tree<int, int> " << n << " -------------" << RESET << std::endl;
+  {
+    // fault the pages in first so that neither side pays for fresh memory
+    recursive_tree warm;
+    warm.copy_from(src);
+  }
+  {
+    Timer t;
+    int_tree copy(src);
+    print_result("iterative", "copy   ", t.elapsed(), n);
+    Timer it;
+    g_sink = bench_iterate(copy);
+    print_result("iterative", "iterate", it.elapsed(), n);
+    Timer c;
+    copy.clear();
+    print_result("iterative", "clear  ", c.elapsed(), n);
+  }
+  {
+    recursive_tree copy;
+    Timer t;
+    copy.copy_from(src);
+    print_result("recursive", "copy   ", t.elapsed(), n);
+    Timer it;
+    g_sink = bench_iterate(copy);
+    print_result("recursive", "iterate", it.elapsed(), n);
+    Timer c;
+    copy.recursive_clear();
+    print_result("recursive", "clear  ", c.elapsed(), n);
+  }
+}
+
+/* ****************************************************** */
+/*                 string (long keys)                     */
+/* ****************************************************** */
+
+// keys of the same length sharing a long prefix, so that comparisons read the whole key
+std::vector<std::string> make_string_keys(size_t n, size_t len) {
+  std::vector<int> ids = make_keys(n);
+  std::vector<std::string> keys(n, std::string(len, 'k'));
+  for (size_t i = 0; i < n; i++) {
+    unsigned int _id = static_cast<unsigned int>(ids[i]);
+    for (size_t j = 0; j < 8; j++, _id >>= 4)
+      keys[i][len - 1 - j] = static_cast<char>('a' + (_id & 0xf));
+  }
+  return keys;
+}
+
+void bench_string(size_t n) {
+  typedef ft::map<std::string, int> map_type;
+  const size_t lens[] = {32, 64, 128, 256};
+
+  for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+    std::vector<std::string> keys = make_string_keys(n, lens[l]);
+    std::cout << YELLOW << BOLD << "------------- ft::map<std::string, int> " << n << ", " << lens[l]
+              << " byte keys -------------" << RESET << std::endl;
+    map_type m;
+    {
+      Timer t;
+      for (size_t i = 0; i < n; i++)
+        m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+      print_result("map   ", "insert", t.elapsed(), n);
+    }
+    {
+      Timer t;
+      ll sum = 0;
+      for (size_t i = 0; i < n; i++)
+        sum += m.find(keys[(i * 7919) % n])->second;
+      print_result("map   ", "find  ", t.elapsed(), n);
+      g_sink = sum;
+    }
+    {
+      Timer t;
+      ll sum = 0;
+      for (size_t i = 0; i < n; i++)
+        sum += m.lower_bound(keys[(i * 7919) % n])->second;
+      print_result("map   ", "lower_bound", t.elapsed(), n);
+      g_sink = sum;
+    }
+  }
+}
+
+/* ****************************************************** */
+/*                 finger (cursor search)                 */
+/* ****************************************************** */
+
+template<class Lookup>
+void bench_stream(const char *name, const std::vector<long> &stream, Lookup lookup) {
+  Timer t;
+  ll sum = 0;
+  for (size_t i = 0; i < stream.size(); i++)
+    sum += lookup(stream[i]);
+  print_result(name, "", t.elapsed(), stream.size());
+  g_sink = sum;
+}
+
+struct map_find {
+  const ft::map<long, int> *m;
+  int operator()(long k) const { return m->lower_bound(k)->second; }
+};
+
+struct cursor_find {
+  ft::map<long, int>::const_cursor *c;
+  int operator()(long k) const { return c->lower_bound(k)->second; }
+};
+
+void bench_finger(size_t n) {
+  typedef ft::map<long, int> map_type;
+  map_type m;
+  for (size_t i = 0; i < n; i++)
+    m.insert(m.end(), ft::make_pair(static_cast<long>(i) * 2, static_cast<int>(i)));
+
+  // keys below the largest one so that lower_bound never returns end()
+  std::vector<long> sequential(n), nearby(n), jumps(n), random(n);
+  std::vector<int> perm = make_keys(n);
+  for (size_t i = 0; i < n; i++) {
+    sequential[i] = static_cast<long>(i) * 2;
+    nearby[i] = static_cast<long>(i + (static_cast<unsigned int>(perm[i]) >> 26)) % n * 2;  // +0..63
+    jumps[i] = static_cast<long>(i * 2 + (static_cast<unsigned int>(perm[i]) >> 16)) % n * 2; // +0..65535
+    random[i] = static_cast<long>(static_cast<unsigned int>(perm[i]) % n) * 2;
+  }
+
+  const char *names[] = {"sequential", "nearby (+64)", "jumps (+64k)", "random"};
+  const std::vector<long> *streams[] = {&sequential, &nearby, &jumps, &random};
+  std::cout << YELLOW << BOLD << "------------- ft::map<long, int> " << n << " -------------" << RESET << std::endl;
+  for (size_t i = 0; i < 4; i++) {
+    std::cout << names[i] << std::endl;
+    map_find f = {&m};
+    bench_stream("lower_bound", *streams[i], f);
+    map_type::const_cursor c = static_cast<const map_type &>(m).get_cursor();
+    cursor_find cf = {&c};
+    bench_stream("cursor     ", *streams[i], cf);
+  }
+}
+
+/* ****************************************************** */
+/*                 set (Identity key, no mapped value)    */
+/* ****************************************************** */
+
+// map<long, char> used as a set : the element is a pair, only its key is read back
+inline long set_key(long k) { return k; }
+inline long set_key(const ft::pair<const long, char> &v) { return v.first; }
+inline void set_insert(ft::set<long> &s, long k) { s.insert(k); }
+inline void set_insert(ft::map<long, char> &s, long k) { s.insert(ft::make_pair(k, char())); }
+
+template<class Set>
+void bench_set_insert(const char *name, Set &s, const std::vector<int> &keys) {
+  Timer t;
+  for (size_t i = 0; i < keys.size(); i++)
+    set_insert(s, keys[i]);
+  print_result(name, "insert", t.elapsed(), keys.size());
+}
+
+template<class Set>
+void bench_set_count(const char *name, const Set &s, const std::vector<int> &keys) {
+  size_t n = keys.size();
+  Timer t;
+  ll found = 0;
+  for (size_t i = 0; i < n; i++)
+    found += s.count(keys[(i * 7) % n]);
+  g_sink = found;
+  print_result(name, "count ", t.elapsed(), n);
+}
+
+template<class Set>
+void bench_set_scan(const char *name, const Set &s) {
+  Timer t;
+  ll sum = 0;
+  for (typename Set::const_iterator it = s.begin(); it != s.end(); ++it)
+    sum += set_key(*it);
+  g_sink = sum;
+  print_result(name, "scan  ", t.elapsed(), s.size());
+}
+
+void bench_set(size_t n) {
+  std::vector<int> keys = make_keys(n);
+  std::cout << YELLOW << BOLD << "------------- set of long " << n << " -------------" << RESET << std::endl;
+  std::cout << "node : map<long, char> " << sizeof(ft::_rb_tree_node<ft::pair<const long, char> >)
+            << " bytes, set<long> " << sizeof(ft::_rb_tree_node<long>) << " bytes" << std::endl;
+  // both stay alive and the phases alternate : neither tree reuses the other's freed nodes or always runs second
+  ft::map<long, char> as_map;
+  ft::set<long> as_set;
+  bench_set_insert("map<long, char>", as_map, keys);
+  bench_set_insert("set<long>      ", as_set, keys);
+  bench_set_count("map<long, char>", as_map, keys);
+  bench_set_count("set<long>      ", as_set, keys);
+  bench_set_scan("map<long, char>", as_map);
+  bench_set_scan("set<long>      ", as_set);
+}
+
+/* ****************************************************** */
+/*          concurrent (threads x read ratio)             */
+/* ****************************************************** */
+
+// what we had before concurrent_map : one ft::map behind one mutex
+class mutex_map {
+  ft::map<int, int> _m;
+  pthread_mutex_t _lock;
+ public:
+  mutex_map() { pthread_mutex_init(&_lock, NULL); }
+  ~mutex_map() { pthread_mutex_destroy(&_lock); }
+  bool find(int k, int &out) {
+    pthread_mutex_lock(&_lock);
+    ft::map<int, int>::iterator it = _m.find(k);
+    bool found = it != _m.end();
+    if (found)
+      out = it->second;
+    pthread_mutex_unlock(&_lock);
+    return found;
+  }
+  bool insert_or_assign(int k, int v) {
+    pthread_mutex_lock(&_lock);
+    bool inserted = _m.insert_or_assign(k, v).second;
+    pthread_mutex_unlock(&_lock);
+    return inserted;
+  }
+  bool lower_bound(int k, int &out) {
+    pthread_mutex_lock(&_lock);
+    ft::map<int, int>::iterator it = _m.lower_bound(k);
+    bool found = it != _m.end();
+    if (found)
+      out = it->second;
+    pthread_mutex_unlock(&_lock);
+    return found;
+  }
+  bool insert(int k, int v) {
+    pthread_mutex_lock(&_lock);
+    bool inserted = _m.insert(ft::make_pair(k, v)).second;
+    pthread_mutex_unlock(&_lock);
+    return inserted;
+  }
+  size_t erase(int k) {
+    pthread_mutex_lock(&_lock);
+    size_t erased = _m.erase(k);
+    pthread_mutex_unlock(&_lock);
+    return erased;
+  }
+};
+
+template<class Map>
+struct concurrent_job {
+  Map *m;
+  const std::vector<int> *keys;
+  size_t ops;
+  unsigned read_percent;
+  unsigned seed;
+  ll found;
+};
+
+template<class Map>
+void *concurrent_worker(void *p) {
+  concurrent_job<Map> *job = static_cast<concurrent_job<Map> *>(p);
+  const std::vector<int> &keys = *job->keys;
+  unsigned x = job->seed;
+  ll found = 0;
+  for (size_t i = 0; i < job->ops; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    int k = keys[x % keys.size()];
+    int v;
+    if (x % 100 < job->read_percent)
+      found += job->m->find(k, v);
+    else
+      job->m->insert_or_assign(k, static_cast<int>(i));
+  }
+  job->found = found;
+  return NULL;
+}
+
+// n operations in total, split over the threads
+template<class Map>
+void bench_concurrent_run(const char *name, Map &m, const std::vector<int> &keys, size_t n,
+                          unsigned threads, unsigned read_percent, void *(*worker)(void *)) {
+  std::vector<concurrent_job<Map> > jobs(threads);
+  std::vector<pthread_t> ids(threads);
+  Timer t;
+  for (unsigned i = 0; i < threads; i++) {
+    concurrent_job<Map> job = {&m, &keys, n / threads, read_percent, 2463534242u + i * 7919u, 0};
+    jobs[i] = job;
+    pthread_create(&ids[i], NULL, worker, &jobs[i]);
+  }
+  ll found = 0;
+  for (unsigned i = 0; i < threads; i++) {
+    pthread_join(ids[i], NULL);
+    found += jobs[i].found;
+  }
+  print_result(name, "", t.elapsed(), n);
+  g_sink = found;
+}
+
+void bench_concurrent(size_t n) {
+  typedef ft::concurrent_map<int, int> cmap;
+  std::vector<int> keys = make_keys(n);
+  mutex_map locked;
+  cmap rwlocked(1);
+  cmap sharded(cmap::default_shards);
+  ft::optimistic_map<int, int> optimistic;
+  for (size_t i = 0; i < n; i++) {
+    locked.insert_or_assign(keys[i], static_cast<int>(i));
+    rwlocked.insert_or_assign(keys[i], static_cast<int>(i));
+    sharded.insert_or_assign(keys[i], static_cast<int>(i));
+    optimistic.insert_or_assign(keys[i], static_cast<int>(i));
+  }
+
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned max_threads = cores > 32 ? 32 : cores < 1 ? 1 : static_cast<unsigned>(cores);
+  const unsigned read_percents[] = {100, 95, 50};
+  std::cout << YELLOW << BOLD << "------------- int -> int " << n << " keys, " << n << " ops -------------" << RESET
+            << std::endl;
+  for (size_t r = 0; r < 3; r++) {
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+      std::cout << read_percents[r] << "% find, " << threads << " threads" << std::endl;
+      bench_concurrent_run("mutex     ", locked, keys, n, threads, read_percents[r], concurrent_worker<mutex_map>);
+      bench_concurrent_run("rwlock    ", rwlocked, keys, n, threads, read_percents[r], concurrent_worker<cmap>);
+      bench_concurrent_run("sharded 64", sharded, keys, n, threads, read_percents[r], concurrent_worker<cmap>);
+      bench_concurrent_run("optimistic", optimistic, keys, n, threads, read_percents[r],
+                           concurrent_worker<ft::optimistic_map<int, int> >);
+    }
+  }
+}
+
+/* ****************************************************** */
+/*        lockfree (skip list vs mutex, 1..32 threads)    */
+/* ****************************************************** */
+
+#if defined(FT_LOCKFREE)
+class skiplist_map {
+  ft::lockfree_skiplist<int, int> _m;
+ public:
+  bool lower_bound(int k, int &out) {
+    ft::lockfree_skiplist<int, int>::iterator it = _m.lower_bound(k);
+    bool found = it != _m.end();
+    if (found)
+      out = it->second;
+    return found;
+  }
+  bool insert(int k, int v) { return _m.insert(ft::make_pair(k, v)).second; }
+  size_t erase(int k) { return _m.erase(k); }
+};
+
+// the writes are half inserts and half erases of random keys, so the size stays around n / 2
+template<class Map>
+void *ordered_worker(void *p) {
+  concurrent_job<Map> *job = static_cast<concurrent_job<Map> *>(p);
+  const std::vector<int> &keys = *job->keys;
+  unsigned x = job->seed;
+  ll found = 0;
+  for (size_t i = 0; i < job->ops; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    int k = keys[x % keys.size()];
+    int v;
+    unsigned op = x % 100;
+    if (op < job->read_percent)
+      found += job->m->lower_bound(k, v);
+    else if (op % 2)
+      found += job->m->insert(k, k);
+    else
+      found += job->m->erase(k);
+  }
+  job->found = found;
+  return NULL;
+}
+
+void bench_lockfree(size_t n) {
+  std::vector<int> keys = make_keys(n);
+  mutex_map locked;
+  skiplist_map skiplist;
+  for (size_t i = 0; i < n; i += 2) {
+    locked.insert(keys[i], keys[i]);
+    skiplist.insert(keys[i], keys[i]);
+  }
+
+  const unsigned read_percents[] = {100, 90, 50};
+  std::cout << YELLOW << BOLD << "------------- int -> int " << n / 2 << " keys, " << n << " ops -------------" << RESET
+            << std::endl;
+  for (size_t r = 0; r < 3; r++) {
+    for (unsigned threads = 1; threads <= 32; threads *= 2) {
+      std::cout << read_percents[r] << "% lower_bound, " << threads << " threads" << std::endl;
+      bench_concurrent_run("mutex map", locked, keys, n, threads, read_percents[r], ordered_worker<mutex_map>);
+      bench_concurrent_run("skip list", skiplist, keys, n, threads, read_percents[r], ordered_worker<skiplist_map>);
+    }
+  }
+}
+#endif
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <arena|find_many|frozen|scan|merge|copy|clear|teardown|string|finger|set|concurrent|lockfree> [size ...]" << std::endl;
+    return 1;
+  }
+  std::vector<size_t> sizes;
+  for (int i = 2; i < argc; i++)
+    sizes.push_back(std::strtoul(argv[i], NULL, 10));
+  if (sizes.empty())
+    sizes.push_back(1000000);
+
+  std::cout << CYAN << BOLD << "\n============= " << argv[1] << " ==============\n" << RESET << std::endl;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (std::strcmp(argv[1], "arena") == 0)
+      bench_arena(sizes[i]);
+    else if (std::strcmp(argv[1], "find_many") == 0)
+      bench_find_many(sizes[i]);
+    else if (std::strcmp(argv[1], "frozen") == 0)
+      bench_frozen(sizes[i]);
+    else if (std::strcmp(argv[1], "scan") == 0)
+      bench_scan(sizes[i]);
+    else if (std::strcmp(argv[1], "merge") == 0)
+      bench_merge(sizes[i]);
+    else if (std::strcmp(argv[1], "copy") == 0)
+      bench_copy(sizes[i]);
+    else if (std::strcmp(argv[1], "clear") == 0)
+      bench_clear(sizes[i]);
+    else if (std::strcmp(argv[1], "teardown") == 0)
+      bench_teardown(sizes[i]);
+    else if (std::strcmp(argv[1], "string") == 0)
+      bench_string(sizes[i]);
+    else if (std::strcmp(argv[1], "finger") == 0)
+      bench_finger(sizes[i]);
+    else if (std::strcmp(argv[1], "set") == 0)
+      bench_set(sizes[i]);
+    else if (std::strcmp(argv[1], "concurrent") == 0)
+      bench_concurrent(sizes[i]);
+#if defined(FT_LOCKFREE)
+    else if (std::strcmp(argv[1], "lockfree") == 0)
+      bench_lockfree(sizes[i]);
+#endif
+    else {
+      std::cerr << "unknown benchmark " << argv[1] << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -7,6 +7,10 @@
  */
 
 #include "tree.hpp"
+#include "arena_tree.hpp"
+
+#include <pthread.h>
+#include <unistd.h>
 
 namespace ft {
 
@@ -16,10 +20,10 @@ static _rb_tree_node_base *local_rb_tree_increment(_rb_tree_node_base *x) throw(
     while (x->_m_left != 0)
       x = x->_m_left;
   } else {
-    _rb_tree_node_base *_y = x->_m_parent;
+    _rb_tree_node_base *_y = x->_m_get_parent();
     while (x == _y->_m_right) {
       x = _y;
-      _y = _y->_m_parent;
+      _y = _y->_m_get_parent();
     }
     if (x->_m_right != _y)
       x = _y;
@@ -35,17 +39,17 @@ const _rb_tree_node_base *_rb_tree_increment(const _rb_tree_node_base *x) throw(
 }
 
 static _rb_tree_node_base *local_rb_tree_decrement(_rb_tree_node_base *x) throw() {
-  if (x->_m_color == _s_red && x->_m_parent->_m_parent == x) { // header 일 경우 - header 의 -- 는 rightmost
+  if (x->_m_get_color() == _s_red && x->_m_get_parent()->_m_get_parent() == x) { // header 일 경우 - header 의 -- 는 rightmost
     x = x->_m_right;
   } else if (x->_m_left != 0) {
     x = x->_m_left;
     while (x->_m_right != 0)
       x = x->_m_right;
   } else {
-    _rb_tree_node_base *_y = x->_m_parent;
+    _rb_tree_node_base *_y = x->_m_get_parent();
     while (x == _y->_m_left) {
       x = _y;
-      _y = _y->_m_parent;
+      _y = _y->_m_get_parent();
     }
     x = _y;
   }
@@ -59,96 +63,224 @@ const _rb_tree_node_base *_rb_tree_decrement(const _rb_tree_node_base *x) throw(
   return local_rb_tree_decrement(const_cast<_rb_tree_node_base *>(x));
 }
 
-void _rb_tree_rotate_left(_rb_tree_node_base *x, _rb_tree_node_base *&root) {
+void _rb_tree_thread(_rb_tree_node_base *header) throw() {
+#ifdef FT_RB_TREE_THREADED
+  _rb_tree_node_base *_prev = header;
+  for (_rb_tree_node_base *_x = header->_m_left; _x != header; _x = local_rb_tree_increment(_x)) {
+    _prev->_m_next = _x;
+    _x->_m_prev = _prev;
+    _prev = _x;
+  }
+  _prev->_m_next = header;
+  header->_m_prev = _prev;
+#else
+  (void) header;
+#endif
+}
+
+template<class Word>
+static void local_atomic_copy(void *dst, const void *src, size_t n) throw() {
+  Word *_d = static_cast<Word *>(dst);
+  const Word *_s = static_cast<const Word *>(src);
+  for (size_t i = 0; i < n / sizeof(Word); i++)
+    __atomic_store_n(_d + i, __atomic_load_n(_s + i, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+void _rb_tree_atomic_copy(void *dst, const void *src, size_t n) throw() {
+  size_t _bits = reinterpret_cast<size_t>(dst) | reinterpret_cast<size_t>(src) | n;
+  if (_bits % sizeof(size_t) == 0)
+    local_atomic_copy<size_t>(dst, src, n);
+  else if (_bits % sizeof(unsigned int) == 0)
+    local_atomic_copy<unsigned int>(dst, src, n);
+  else if (_bits % sizeof(unsigned short) == 0)
+    local_atomic_copy<unsigned short>(dst, src, n);
+  else
+    local_atomic_copy<unsigned char>(dst, src, n);
+}
+
+// child / root link store, atomic only if an optimistic reader may be loading it (has_optimistic_readers)
+template<bool Shared>
+static void local_link(_rb_tree_node_base *&slot, _rb_tree_node_base *x) throw() {
+  if (Shared)
+    _rb_tree_node_base::_s_store_link(slot, x);
+  else
+    slot = x;
+}
+
+static size_t local_rb_tree_size(const _rb_tree_node_base *x) throw() {
+  return x ? x->_m_get_size() : 0;
+}
+
+// subtree size 는 회전한 두 노드만 다시 계산하면 된다
+template<bool Sized, bool Shared>
+static void local_rb_tree_rotate_left(_rb_tree_node_base *x, _rb_tree_node_base *&root) {
   _rb_tree_node_base *_y = x->_m_right;
-  x->_m_right = _y->_m_left;
+  local_link<Shared>(x->_m_right, _y->_m_left);
   if (_y->_m_left != 0)
-    _y->_m_left->_m_parent = x;
-  _y->_m_parent = x->_m_parent;
+    _y->_m_left->_m_set_parent(x);
+  _y->_m_set_parent(x->_m_get_parent());
 
   if (x == root)
-    root = _y;
-  else if (x == x->_m_parent->_m_left)
-    x->_m_parent->_m_left = _y;
+    local_link<Shared>(root, _y);
+  else if (x == x->_m_get_parent()->_m_left)
+    local_link<Shared>(x->_m_get_parent()->_m_left, _y);
   else
-    x->_m_parent->_m_right = _y;
-  _y->_m_left = x;
-  x->_m_parent = _y;
+    local_link<Shared>(x->_m_get_parent()->_m_right, _y);
+  local_link<Shared>(_y->_m_left, x);
+  x->_m_set_parent(_y);
+  if (Sized) {
+    _y->_m_set_size(x->_m_get_size());
+    x->_m_set_size(local_rb_tree_size(x->_m_left) + local_rb_tree_size(x->_m_right) + 1);
+  }
 }
 
-void _rb_tree_rotate_right(_rb_tree_node_base *x, _rb_tree_node_base *&root) {
+template<bool Sized, bool Shared>
+static void local_rb_tree_rotate_right(_rb_tree_node_base *x, _rb_tree_node_base *&root) {
   _rb_tree_node_base *_y = x->_m_left;
-  x->_m_left = _y->_m_right;
+  local_link<Shared>(x->_m_left, _y->_m_right);
   if (_y->_m_right != 0)
-    _y->_m_right->_m_parent = x;
-  _y->_m_parent = x->_m_parent;
+    _y->_m_right->_m_set_parent(x);
+  _y->_m_set_parent(x->_m_get_parent());
 
   if (x == root)
-    root = _y;
-  else if (x == x->_m_parent->_m_right)
-    x->_m_parent->_m_right = _y;
+    local_link<Shared>(root, _y);
+  else if (x == x->_m_get_parent()->_m_right)
+    local_link<Shared>(x->_m_get_parent()->_m_right, _y);
+  else
+    local_link<Shared>(x->_m_get_parent()->_m_left, _y);
+  local_link<Shared>(_y->_m_right, x);
+  x->_m_set_parent(_y);
+  if (Sized) {
+    _y->_m_set_size(x->_m_get_size());
+    x->_m_set_size(local_rb_tree_size(x->_m_left) + local_rb_tree_size(x->_m_right) + 1);
+  }
+}
+
+void _rb_tree_rotate_left(_rb_tree_node_base *x, _rb_tree_node_base *&root, bool sized) {
+  if (sized)
+    local_rb_tree_rotate_left<true, false>(x, root);
+  else
+    local_rb_tree_rotate_left<false, false>(x, root);
+}
+
+void _rb_tree_rotate_right(_rb_tree_node_base *x, _rb_tree_node_base *&root, bool sized) {
+  if (sized)
+    local_rb_tree_rotate_right<true, false>(x, root);
   else
-    x->_m_parent->_m_left = _y;
-  _y->_m_right = x;
-  x->_m_parent = _y;
+    local_rb_tree_rotate_right<false, false>(x, root);
 }
 
+template<bool Sized, bool Shared>
+static bool local_rb_tree_insert_fixup(_rb_tree_node_base *x, _rb_tree_node_base *&root);
+
 /**
  * @brief Reblance rb_tree
  * @param x new_node
  * @param root root_node
  */
-void _rb_tree_rebalance(_rb_tree_node_base *x, _rb_tree_node_base *&root) {
-  x->_m_color = _s_red;
-  while (x != root && x->_m_parent->_m_color == _s_red) {
-    if (x->_m_parent == x->_m_parent->_m_parent->_m_left) {
+template<bool Sized, bool Shared>
+static void local_rb_tree_rebalance(_rb_tree_node_base *x, _rb_tree_node_base *&root) {
+  x->_m_set_color(_s_red);
+  if (Sized) {
+    // 새 노드의 조상들은 모두 subtree 가 하나씩 커진다
+    x->_m_set_size(1);
+    for (_rb_tree_node_base *_p = x; _p != root;) {
+      _p = _p->_m_get_parent();
+      _p->_m_set_size(_p->_m_get_size() + 1);
+    }
+  }
+  local_rb_tree_insert_fixup<Sized, Shared>(x, root);
+}
+
+/**
+ * @brief restore the red-black properties above the red node x whose subtrees are valid
+ * @return true if the root had to be turned black (the black height of the tree grew by one)
+ */
+template<bool Sized, bool Shared>
+static bool local_rb_tree_insert_fixup(_rb_tree_node_base *x, _rb_tree_node_base *&root) {
+  while (x != root && x->_m_get_parent()->_m_get_color() == _s_red) {
+    if (x->_m_get_parent() == x->_m_get_parent()->_m_get_parent()->_m_left) {
       // 부모 노드가 조상 노드의 왼쪽에 있는 경우
-      _rb_tree_node_base *_y = x->_m_parent->_m_parent->_m_right;
+      _rb_tree_node_base *_y = x->_m_get_parent()->_m_get_parent()->_m_right;
       // 삼촌 노드 색 확인
-      if (_y && _y->_m_color == _s_red) {
+      if (_y && _y->_m_get_color() == _s_red) {
         // 삼촌 노드 색(빨강) -> Recoloring # case 1
-        x->_m_parent->_m_color = _s_black;
-        _y->_m_color = _s_black;
-        x->_m_parent->_m_parent->_m_color = _s_red;
-        x = x->_m_parent->_m_parent; // case 1 일때는 재귀적으로 할아버지 노드를 기준으로 확인해주어야 함
+        x->_m_get_parent()->_m_set_color(_s_black);
+        _y->_m_set_color(_s_black);
+        x->_m_get_parent()->_m_get_parent()->_m_set_color(_s_red);
+        x = x->_m_get_parent()->_m_get_parent(); // case 1 일때는 재귀적으로 할아버지 노드를 기준으로 확인해주어야 함
       } else {
         // 삼촌 노드 색(검정) -> Restructuring # case 2 or 3
-        if (x == x->_m_parent->_m_right) {
+        if (x == x->_m_get_parent()->_m_right) {
           // # case 2
-          x = x->_m_parent;
-          _rb_tree_rotate_left(x, root);
+          x = x->_m_get_parent();
+          local_rb_tree_rotate_left<Sized, Shared>(x, root);
         }
         // # case 3
-        x->_m_parent->_m_color = _s_black;
-        x->_m_parent->_m_parent->_m_color = _s_red;
-        _rb_tree_rotate_right(x->_m_parent->_m_parent, root);
+        x->_m_get_parent()->_m_set_color(_s_black);
+        x->_m_get_parent()->_m_get_parent()->_m_set_color(_s_red);
+        local_rb_tree_rotate_right<Sized, Shared>(x->_m_get_parent()->_m_get_parent(), root);
       }
     } else {
       // 부모 노드가 조상 노드의 오른쪽에 있는 경우
-      _rb_tree_node_base *_y = x->_m_parent->_m_parent->_m_left;
-      if (_y && _y->_m_color == _s_red) {
-        x->_m_parent->_m_color = _s_black;
-        _y->_m_color = _s_black;
-        x->_m_parent->_m_parent->_m_color = _s_red;
-        x = x->_m_parent->_m_parent;
+      _rb_tree_node_base *_y = x->_m_get_parent()->_m_get_parent()->_m_left;
+      if (_y && _y->_m_get_color() == _s_red) {
+        x->_m_get_parent()->_m_set_color(_s_black);
+        _y->_m_set_color(_s_black);
+        x->_m_get_parent()->_m_get_parent()->_m_set_color(_s_red);
+        x = x->_m_get_parent()->_m_get_parent();
       } else {
-        if (x == x->_m_parent->_m_left) {
-          x = x->_m_parent;
-          _rb_tree_rotate_right(x, root);
+        if (x == x->_m_get_parent()->_m_left) {
+          x = x->_m_get_parent();
+          local_rb_tree_rotate_right<Sized, Shared>(x, root);
         }
-        x->_m_parent->_m_color = _s_black;
-        x->_m_parent->_m_parent->_m_color = _s_red;
-        _rb_tree_rotate_left(x->_m_parent->_m_parent, root);
+        x->_m_get_parent()->_m_set_color(_s_black);
+        x->_m_get_parent()->_m_get_parent()->_m_set_color(_s_red);
+        local_rb_tree_rotate_left<Sized, Shared>(x->_m_get_parent()->_m_get_parent(), root);
       }
     }
   }
-  root->_m_color = _s_black;
+  bool _grown = root->_m_get_color() == _s_red;
+  root->_m_set_color(_s_black);
+  return _grown;
 }
 
-_rb_tree_node_base *_rb_tree_rebalance_for_erase(_rb_tree_node_base *z,
-                                                 _rb_tree_node_base *&root,
-                                                 _rb_tree_node_base *&leftmost,
-                                                 _rb_tree_node_base *&rightmost) {
+// x is a new leaf : it goes right before its parent if it is the left child, right after it otherwise
+// (the first node of a tree is the left child of the header, so it lands between the header and itself)
+static void local_rb_tree_thread_leaf(_rb_tree_node_base *x) throw() {
+#ifdef FT_RB_TREE_THREADED
+  _rb_tree_node_base *_p = x->_m_get_parent();
+  if (_p->_m_left == x) {
+    x->_m_next = _p;
+    x->_m_prev = _p->_m_prev;
+  } else {
+    x->_m_prev = _p;
+    x->_m_next = _p->_m_next;
+  }
+  x->_m_prev->_m_next = x;
+  x->_m_next->_m_prev = x;
+#else
+  (void) x;
+#endif
+}
+
+void _rb_tree_rebalance(_rb_tree_node_base *x, _rb_tree_node_base *&root, bool sized, bool shared) {
+  local_rb_tree_thread_leaf(x);
+  if (sized && shared)
+    local_rb_tree_rebalance<true, true>(x, root);
+  else if (sized)
+    local_rb_tree_rebalance<true, false>(x, root);
+  else if (shared)
+    local_rb_tree_rebalance<false, true>(x, root);
+  else
+    local_rb_tree_rebalance<false, false>(x, root);
+}
+
+template<bool Sized, bool Shared>
+static _rb_tree_node_base *local_rb_tree_rebalance_for_erase(_rb_tree_node_base *z,
+                                                             _rb_tree_node_base *&root,
+                                                             _rb_tree_node_base *&leftmost,
+                                                             _rb_tree_node_base *&rightmost) {
   _rb_tree_node_base *_y = z;
   _rb_tree_node_base *_x = 0;
   _rb_tree_node_base *_x_parent = 0;
@@ -162,114 +294,678 @@ _rb_tree_node_base *_rb_tree_rebalance_for_erase(_rb_tree_node_base *z,
       _y = _y->_m_left;
     _x = _y->_m_right;
   }
+  if (Sized) {
+    // 실제로 자리에서 빠지는 노드(_y) 의 조상들은 subtree 가 하나씩 작아진다
+    for (_rb_tree_node_base *_p = _y; _p != root;) {
+      _p = _p->_m_get_parent();
+      _p->_m_set_size(_p->_m_get_size() - 1);
+    }
+  }
   if (_y != z) {
-    z->_m_left->_m_parent = _y;
-    _y->_m_left = z->_m_left;
+    z->_m_left->_m_set_parent(_y);
+    local_link<Shared>(_y->_m_left, z->_m_left);
     if (_y != z->_m_right) {
-      _x_parent = _y->_m_parent;
-      if (_x) _x->_m_parent = _y->_m_parent;
-      _y->_m_parent->_m_left = _x;
-      _y->_m_right = z->_m_right;
-      z->_m_right->_m_parent = _y;
+      _x_parent = _y->_m_get_parent();
+      if (_x) _x->_m_set_parent(_y->_m_get_parent());
+      local_link<Shared>(_y->_m_get_parent()->_m_left, _x);
+      local_link<Shared>(_y->_m_right, z->_m_right);
+      z->_m_right->_m_set_parent(_y);
     } else
       _x_parent = _y;
     if (root == z)
-      root = _y;
-    else if (z->_m_parent->_m_left == z)
-      z->_m_parent->_m_left = _y;
+      local_link<Shared>(root, _y);
+    else if (z->_m_get_parent()->_m_left == z)
+      local_link<Shared>(z->_m_get_parent()->_m_left, _y);
     else
-      z->_m_parent->_m_right = _y;
-    _y->_m_parent = z->_m_parent;
-    ft::swap(_y->_m_color, z->_m_color);
+      local_link<Shared>(z->_m_get_parent()->_m_right, _y);
+    _y->_m_set_parent(z->_m_get_parent());
+    bool _color = _y->_m_get_color();
+    _y->_m_set_color(z->_m_get_color());
+    z->_m_set_color(_color);
+    if (Sized)
+      _y->_m_set_size(z->_m_get_size());
     _y = z;
   } else {
-    _x_parent = _y->_m_parent;
+    _x_parent = _y->_m_get_parent();
     if (_x)
-      _x->_m_parent = _y->_m_parent;
+      _x->_m_set_parent(_y->_m_get_parent());
     if (root == z)
-      root = _x;
-    else if (z->_m_parent->_m_left == z)
-      z->_m_parent->_m_left = _x;
+      local_link<Shared>(root, _x);
+    else if (z->_m_get_parent()->_m_left == z)
+      local_link<Shared>(z->_m_get_parent()->_m_left, _x);
     else
-      z->_m_parent->_m_right = _x;
+      local_link<Shared>(z->_m_get_parent()->_m_right, _x);
     if (leftmost == z) {
       if (z->_m_right == 0)
-        leftmost = z->_m_parent;
+        leftmost = z->_m_get_parent();
       else
         leftmost = _rb_tree_node_base::_s_minimum(_x);
     }
     if (rightmost == z) {
       if (z->_m_left == 0)
-        rightmost = z->_m_parent;
+        rightmost = z->_m_get_parent();
       else
         rightmost = _rb_tree_node_base::_s_maximum(_x);
     }
   }
-  if (_y->_m_color != _s_red) {
-    while (_x != root && (_x == 0 || _x->_m_color == _s_black))
+  if (_y->_m_get_color() != _s_red) {
+    while (_x != root && (_x == 0 || _x->_m_get_color() == _s_black))
       if (_x == _x_parent->_m_left) {
         _rb_tree_node_base *_w = _x_parent->_m_right;
-        if (_w->_m_color == _s_red) {
-          _w->_m_color = _s_black;
-          _x_parent->_m_color = _s_red;
-          _rb_tree_rotate_left(_x_parent, root);
+        if (_w->_m_get_color() == _s_red) {
+          _w->_m_set_color(_s_black);
+          _x_parent->_m_set_color(_s_red);
+          local_rb_tree_rotate_left<Sized, Shared>(_x_parent, root);
           _w = _x_parent->_m_right;
         }
         if ((_w->_m_left == 0 ||
-            _w->_m_left->_m_color == _s_black) &&
+            _w->_m_left->_m_get_color() == _s_black) &&
             (_w->_m_right == 0 ||
-                _w->_m_right->_m_color == _s_black)) {
-          _w->_m_color = _s_red;
+                _w->_m_right->_m_get_color() == _s_black)) {
+          _w->_m_set_color(_s_red);
           _x = _x_parent;
-          _x_parent = _x_parent->_m_parent;
+          _x_parent = _x_parent->_m_get_parent();
         } else {
           if (_w->_m_right == 0
-              || _w->_m_right->_m_color == _s_black) {
-            _w->_m_left->_m_color = _s_black;
-            _w->_m_color = _s_red;
-            _rb_tree_rotate_right(_w, root);
+              || _w->_m_right->_m_get_color() == _s_black) {
+            _w->_m_left->_m_set_color(_s_black);
+            _w->_m_set_color(_s_red);
+            local_rb_tree_rotate_right<Sized, Shared>(_w, root);
             _w = _x_parent->_m_right;
           }
-          _w->_m_color = _x_parent->_m_color;
-          _x_parent->_m_color = _s_black;
+          _w->_m_set_color(_x_parent->_m_get_color());
+          _x_parent->_m_set_color(_s_black);
           if (_w->_m_right)
-            _w->_m_right->_m_color = _s_black;
-          _rb_tree_rotate_left(_x_parent, root);
+            _w->_m_right->_m_set_color(_s_black);
+          local_rb_tree_rotate_left<Sized, Shared>(_x_parent, root);
           break;
         }
       } else {
         _rb_tree_node_base *_w = _x_parent->_m_left;
-        if (_w->_m_color == _s_red) {
-          _w->_m_color = _s_black;
-          _x_parent->_m_color = _s_red;
-          _rb_tree_rotate_right(_x_parent, root);
+        if (_w->_m_get_color() == _s_red) {
+          _w->_m_set_color(_s_black);
+          _x_parent->_m_set_color(_s_red);
+          local_rb_tree_rotate_right<Sized, Shared>(_x_parent, root);
           _w = _x_parent->_m_left;
         }
         if ((_w->_m_right == 0 ||
-            _w->_m_right->_m_color == _s_black) &&
+            _w->_m_right->_m_get_color() == _s_black) &&
             (_w->_m_left == 0 ||
-                _w->_m_left->_m_color == _s_black)) {
-          _w->_m_color = _s_red;
+                _w->_m_left->_m_get_color() == _s_black)) {
+          _w->_m_set_color(_s_red);
           _x = _x_parent;
-          _x_parent = _x_parent->_m_parent;
+          _x_parent = _x_parent->_m_get_parent();
         } else {
-          if (_w->_m_left == 0 || _w->_m_left->_m_color == _s_black) {
-            _w->_m_right->_m_color = _s_black;
-            _w->_m_color = _s_red;
-            _rb_tree_rotate_left(_w, root);
+          if (_w->_m_left == 0 || _w->_m_left->_m_get_color() == _s_black) {
+            _w->_m_right->_m_set_color(_s_black);
+            _w->_m_set_color(_s_red);
+            local_rb_tree_rotate_left<Sized, Shared>(_w, root);
             _w = _x_parent->_m_left;
           }
-          _w->_m_color = _x_parent->_m_color;
-          _x_parent->_m_color = _s_black;
+          _w->_m_set_color(_x_parent->_m_get_color());
+          _x_parent->_m_set_color(_s_black);
           if (_w->_m_left)
-            _w->_m_left->_m_color = _s_black;
-          _rb_tree_rotate_right(_x_parent, root);
+            _w->_m_left->_m_set_color(_s_black);
+          local_rb_tree_rotate_right<Sized, Shared>(_x_parent, root);
+          break;
+        }
+      }
+    if (_x) _x->_m_set_color(_s_black);
+  }
+  return _y;
+}
+
+_rb_tree_node_base *_rb_tree_rebalance_for_erase(_rb_tree_node_base *z,
+                                                 _rb_tree_node_base *&root,
+                                                 _rb_tree_node_base *&leftmost,
+                                                 _rb_tree_node_base *&rightmost,
+                                                 bool sized,
+                                                 bool shared) {
+#ifdef FT_RB_TREE_THREADED
+  z->_m_prev->_m_next = z->_m_next;
+  z->_m_next->_m_prev = z->_m_prev;
+#endif
+  if (sized && shared)
+    return local_rb_tree_rebalance_for_erase<true, true>(z, root, leftmost, rightmost);
+  if (sized)
+    return local_rb_tree_rebalance_for_erase<true, false>(z, root, leftmost, rightmost);
+  if (shared)
+    return local_rb_tree_rebalance_for_erase<false, true>(z, root, leftmost, rightmost);
+  return local_rb_tree_rebalance_for_erase<false, false>(z, root, leftmost, rightmost);
+}
+
+/**
+ * @brief number of black nodes on the path from node up to root (both included)
+ */
+size_t _rb_tree_black_count(const _rb_tree_node_base *node, const _rb_tree_node_base *root) throw() {
+  if (node == 0)
+    return 0;
+  size_t _sum = 0;
+  do {
+    if (node->_m_get_color() == _s_black)
+      ++_sum;
+    if (node == root)
+      break;
+    node = node->_m_get_parent();
+  } while (true);
+  return _sum;
+}
+
+size_t _rb_tree_black_height(const _rb_tree_node_base *x) throw() {
+  size_t _h = 0;
+  for (; x != 0; x = x->_m_left)
+    _h += x->_m_get_color() == _s_black;
+  return _h;
+}
+
+template<bool Sized>
+static _rb_tree_node_base *local_rb_tree_join(_rb_tree_node_base *l, size_t lh, _rb_tree_node_base *k,
+                                              _rb_tree_node_base *r, size_t rh,
+                                              _rb_tree_node_base *header, size_t &h) {
+  // a red root can always be made black, both trees stay valid
+  if (l && l->_m_get_color() == _s_red) {
+    l->_m_set_color(_s_black);
+    ++lh;
+  }
+  if (r && r->_m_get_color() == _s_red) {
+    r->_m_set_color(_s_black);
+    ++rh;
+  }
+  bool _left_taller = lh >= rh;
+  _rb_tree_node_base *_root = _left_taller ? l : r;
+  _rb_tree_node_base *_p = header;
+  _rb_tree_node_base *_x = _root;
+  h = _left_taller ? lh : rh;
+  size_t _xh = h;
+  const size_t _target = _left_taller ? rh : lh;
+
+  // walk down the inner spine of the taller tree to the first black node as high as the other tree
+  while (_x != 0 && (_xh > _target || _x->_m_get_color() == _s_red)) {
+    _xh -= _x->_m_get_color() == _s_black;
+    _p = _x;
+    _x = _left_taller ? _x->_m_right : _x->_m_left;
+  }
+  // k takes the place of _x, with _x and the shorter tree as its children
+  k->_m_left = _left_taller ? _x : l;
+  k->_m_right = _left_taller ? r : _x;
+  if (k->_m_left) k->_m_left->_m_set_parent(k);
+  if (k->_m_right) k->_m_right->_m_set_parent(k);
+  k->_m_set_parent(_p);
+  k->_m_set_color(_s_red);
+  if (_p == header)
+    _root = k;
+  else if (_left_taller)
+    _p->_m_right = k;
+  else
+    _p->_m_left = k;
+  _root->_m_set_parent(header);
+
+  if (Sized) {
+    k->_m_set_size(local_rb_tree_size(k->_m_left) + local_rb_tree_size(k->_m_right) + 1);
+    size_t _added = local_rb_tree_size(_left_taller ? r : l) + 1;
+    for (_rb_tree_node_base *_y = _p; _y != header; _y = _y->_m_get_parent())
+      _y->_m_set_size(_y->_m_get_size() + _added);
+  }
+  if (local_rb_tree_insert_fixup<Sized, false>(k, _root))
+    ++h;
+  return _root;
+}
+
+_rb_tree_node_base *_rb_tree_join(_rb_tree_node_base *l, size_t lh, _rb_tree_node_base *k,
+                                  _rb_tree_node_base *r, size_t rh,
+                                  _rb_tree_node_base *header, size_t &h, bool sized) throw() {
+  if (sized)
+    return local_rb_tree_join<true>(l, lh, k, r, rh, header, h);
+  return local_rb_tree_join<false>(l, lh, k, r, rh, header, h);
+}
+
+/**
+ * @brief number of nodes before x in order (x == header : number of all nodes), sized tree only
+ */
+size_t _rb_tree_rank(const _rb_tree_node_base *x) throw() {
+  if (x->_m_get_color() == _s_red && (x->_m_get_parent() == 0 || x->_m_get_parent()->_m_get_parent() == x)) // header
+    return local_rb_tree_size(x->_m_get_parent());
+  size_t _r = local_rb_tree_size(x->_m_left);
+  // root 의 부모는 header 이고 header 의 부모는 다시 root 이다
+  while (x->_m_get_parent()->_m_get_parent() != x) {
+    if (x == x->_m_get_parent()->_m_right)
+      _r += local_rb_tree_size(x->_m_get_parent()->_m_left) + 1;
+    x = x->_m_get_parent();
+  }
+  return _r;
+}
+
+/**
+ * @brief k-th (0-based) node in order under root, 0 if k is out of range (sized tree only)
+ */
+_rb_tree_node_base *_rb_tree_select(_rb_tree_node_base *root, size_t k) throw() {
+  while (root != 0) {
+    size_t _left = local_rb_tree_size(root->_m_left);
+    if (k < _left) {
+      root = root->_m_left;
+    } else if (k == _left) {
+      return root;
+    } else {
+      k -= _left + 1;
+      root = root->_m_right;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief node n steps away from x in order (x may be the header), sized tree only
+ *
+ * rank 를 구한 뒤 root 에서 다시 select 하므로 O(log n).
+ * 범위를 벗어나는 n 은 std 반복자와 같이 undefined behavior.
+ */
+_rb_tree_node_base *_rb_tree_advance(_rb_tree_node_base *x, ptrdiff_t n) throw() {
+  _rb_tree_node_base *_header = x;
+  while (!(_header->_m_get_color() == _s_red
+      && (_header->_m_get_parent() == 0 || _header->_m_get_parent()->_m_get_parent() == _header)))
+    _header = _header->_m_get_parent();
+  size_t _k = _rb_tree_rank(x) + n;
+  if (_k == local_rb_tree_size(_header->_m_get_parent()))
+    return _header;
+  return _rb_tree_select(_header->_m_get_parent(), _k);
+}
+
+/* ****************************************************** */
+/*                  Parallel tasks                        */
+/* ****************************************************** */
+
+struct local_parallel_job {
+  void (*_m_task)(void *, size_t);
+  void *_m_arg;
+  size_t _m_count;
+  size_t _m_next;
+  pthread_mutex_t _m_lock;
+};
+
+static void local_parallel_drain(local_parallel_job *job) {
+  for (;;) {
+    pthread_mutex_lock(&job->_m_lock);
+    size_t _i = job->_m_next++;
+    pthread_mutex_unlock(&job->_m_lock);
+    if (_i >= job->_m_count)
+      return;
+    job->_m_task(job->_m_arg, _i);
+  }
+}
+
+static void *local_parallel_worker(void *job) {
+  local_parallel_drain(static_cast<local_parallel_job *>(job));
+  return 0;
+}
+
+unsigned _rb_tree_hardware_threads() throw() {
+  long _n = sysconf(_SC_NPROCESSORS_ONLN);
+  return _n > 0 ? static_cast<unsigned>(_n) : 1;
+}
+
+/**
+ * @brief run task(arg, i) for every i in [0, count) on up to threads threads, the caller included
+ *
+ * task 는 공유 counter 에서 하나씩 가져가므로 크기가 고르지 않은 subtree 들도 골고루 나눠진다.
+ * thread 를 만들지 못하면 남은 task 는 호출한 thread 가 모두 처리한다.
+ */
+void _rb_tree_run_parallel(void (*task)(void *, size_t), void *arg, size_t count, unsigned threads) throw() {
+  local_parallel_job _job;
+  _job._m_task = task;
+  _job._m_arg = arg;
+  _job._m_count = count;
+  _job._m_next = 0;
+  pthread_mutex_init(&_job._m_lock, 0);
+
+  if (threads > count)
+    threads = static_cast<unsigned>(count);
+  pthread_t _workers[_s_parallel_max_threads];
+  unsigned _started = 0;
+  for (; _started + 1 < threads && _started + 1 < _s_parallel_max_threads; ++_started)
+    if (pthread_create(&_workers[_started], 0, local_parallel_worker, &_job) != 0)
+      break;
+  local_parallel_drain(&_job);
+  for (unsigned i = 0; i < _started; ++i)
+    pthread_join(_workers[i], 0);
+  pthread_mutex_destroy(&_job._m_lock);
+}
+
+/* ****************************************************** */
+/*                 Deferred destruction                   */
+/* ****************************************************** */
+
+// one reclaimer thread for every tree, started by the first deferred clear()
+struct local_reclaimer {
+  pthread_mutex_t _m_lock;
+  pthread_cond_t _m_work;
+  pthread_cond_t _m_idle;
+  _rb_tree_garbage *_m_queue;
+  size_t _m_pending;  // nodes queued or being freed
+  size_t _m_limit;
+  bool _m_busy;
+  bool _m_started;
+};
+
+static local_reclaimer g_reclaimer = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                                      0, 0, size_t(1) << 24, false, false};
+
+static void *local_reclaimer_main(void *) {
+  pthread_mutex_lock(&g_reclaimer._m_lock);
+  for (;;) {
+    while (g_reclaimer._m_queue == 0)
+      pthread_cond_wait(&g_reclaimer._m_work, &g_reclaimer._m_lock);
+    _rb_tree_garbage *_g = g_reclaimer._m_queue;
+    g_reclaimer._m_queue = 0;
+    g_reclaimer._m_busy = true;
+    pthread_mutex_unlock(&g_reclaimer._m_lock);
+
+    size_t _freed = 0;
+    while (_g != 0) {
+      _rb_tree_garbage *_next = _g->_m_next;
+      _freed += _g->_m_nodes;
+      _g->_m_destroy(_g);
+      _g = _next;
+    }
+
+    pthread_mutex_lock(&g_reclaimer._m_lock);
+    g_reclaimer._m_pending -= _freed;
+    g_reclaimer._m_busy = false;
+    pthread_cond_broadcast(&g_reclaimer._m_idle);
+  }
+  return 0;
+}
+
+bool _rb_tree_defer_destroy(_rb_tree_garbage *g) throw() {
+  bool _queued = false;
+  pthread_mutex_lock(&g_reclaimer._m_lock);
+  if (g_reclaimer._m_pending + g->_m_nodes <= g_reclaimer._m_limit) {
+    if (!g_reclaimer._m_started) {
+      pthread_t _t;
+      if (pthread_create(&_t, 0, local_reclaimer_main, 0) == 0) {
+        pthread_detach(_t);
+        g_reclaimer._m_started = true;
+      }
+    }
+    if (g_reclaimer._m_started) {
+      g->_m_next = g_reclaimer._m_queue;
+      g_reclaimer._m_queue = g;
+      g_reclaimer._m_pending += g->_m_nodes;
+      pthread_cond_signal(&g_reclaimer._m_work);
+      _queued = true;
+    }
+  }
+  pthread_mutex_unlock(&g_reclaimer._m_lock);
+  return _queued;
+}
+
+void flush_deferred_destruction() throw() {
+  pthread_mutex_lock(&g_reclaimer._m_lock);
+  while (g_reclaimer._m_queue != 0 || g_reclaimer._m_busy)
+    pthread_cond_wait(&g_reclaimer._m_idle, &g_reclaimer._m_lock);
+  pthread_mutex_unlock(&g_reclaimer._m_lock);
+}
+
+size_t set_deferred_destruction_limit(size_t nodes) throw() {
+  pthread_mutex_lock(&g_reclaimer._m_lock);
+  size_t _old = g_reclaimer._m_limit;
+  g_reclaimer._m_limit = nodes;
+  pthread_mutex_unlock(&g_reclaimer._m_lock);
+  return _old;
+}
+
+/* ****************************************************** */
+/*           Arena tree (32 bit slot links)               */
+/* ****************************************************** */
+
+// 포인터 버전과 같은 알고리즘, null 은 slot 0 이고 header 는 항상 slot 1 이다
+
+static _rb_arena_index local_rb_arena_root(const _rb_arena &a) {
+  return a._m_link(_s_arena_header)._m_get_parent();
+}
+
+static _rb_arena_index local_rb_arena_minimum(const _rb_arena &a, _rb_arena_index x) {
+  while (a._m_link(x)._m_left != 0) x = a._m_link(x)._m_left;
+  return x;
+}
+
+static _rb_arena_index local_rb_arena_maximum(const _rb_arena &a, _rb_arena_index x) {
+  while (a._m_link(x)._m_right != 0) x = a._m_link(x)._m_right;
+  return x;
+}
+
+_rb_arena_index _rb_arena_increment(const _rb_arena &a, _rb_arena_index x) throw() {
+  if (a._m_link(x)._m_right != 0)
+    return local_rb_arena_minimum(a, a._m_link(x)._m_right);
+  _rb_arena_index _y = a._m_link(x)._m_get_parent();
+  while (x == a._m_link(_y)._m_right) {
+    x = _y;
+    _y = a._m_link(_y)._m_get_parent();
+  }
+  if (a._m_link(x)._m_right != _y)
+    x = _y;
+  return x;
+}
+
+_rb_arena_index _rb_arena_decrement(const _rb_arena &a, _rb_arena_index x) throw() {
+  if (x == _s_arena_header) // header 는 번호로 바로 알 수 있다 - header 의 -- 는 rightmost
+    return a._m_link(x)._m_right;
+  if (a._m_link(x)._m_left != 0)
+    return local_rb_arena_maximum(a, a._m_link(x)._m_left);
+  _rb_arena_index _y = a._m_link(x)._m_get_parent();
+  while (x == a._m_link(_y)._m_left) {
+    x = _y;
+    _y = a._m_link(_y)._m_get_parent();
+  }
+  return _y;
+}
+
+static void local_rb_arena_rotate_left(const _rb_arena &a, _rb_arena_index x) {
+  _rb_arena_link &_x = a._m_link(x);
+  _rb_arena_index _y = _x._m_right;
+  _rb_arena_link &_yl = a._m_link(_y);
+  _rb_arena_index _p = _x._m_get_parent();
+  _x._m_right = _yl._m_left;
+  if (_yl._m_left != 0)
+    a._m_link(_yl._m_left)._m_set_parent(x);
+  _yl._m_set_parent(_p);
+
+  if (x == local_rb_arena_root(a))
+    a._m_link(_s_arena_header)._m_set_parent(_y);
+  else if (x == a._m_link(_p)._m_left)
+    a._m_link(_p)._m_left = _y;
+  else
+    a._m_link(_p)._m_right = _y;
+  _yl._m_left = x;
+  _x._m_set_parent(_y);
+}
+
+static void local_rb_arena_rotate_right(const _rb_arena &a, _rb_arena_index x) {
+  _rb_arena_link &_x = a._m_link(x);
+  _rb_arena_index _y = _x._m_left;
+  _rb_arena_link &_yl = a._m_link(_y);
+  _rb_arena_index _p = _x._m_get_parent();
+  _x._m_left = _yl._m_right;
+  if (_yl._m_right != 0)
+    a._m_link(_yl._m_right)._m_set_parent(x);
+  _yl._m_set_parent(_p);
+
+  if (x == local_rb_arena_root(a))
+    a._m_link(_s_arena_header)._m_set_parent(_y);
+  else if (x == a._m_link(_p)._m_right)
+    a._m_link(_p)._m_right = _y;
+  else
+    a._m_link(_p)._m_left = _y;
+  _yl._m_right = x;
+  _x._m_set_parent(_y);
+}
+
+static bool local_rb_arena_is_black(const _rb_arena &a, _rb_arena_index x) {
+  return x == 0 || a._m_link(x)._m_get_color() == _s_black;
+}
+
+void _rb_arena_rebalance(const _rb_arena &a, _rb_arena_index x) throw() {
+  a._m_link(x)._m_set_color(_s_red);
+  while (x != local_rb_arena_root(a) && !local_rb_arena_is_black(a, a._m_link(x)._m_get_parent())) {
+    _rb_arena_index _xp = a._m_link(x)._m_get_parent();
+    _rb_arena_index _xpp = a._m_link(_xp)._m_get_parent();
+    if (_xp == a._m_link(_xpp)._m_left) {
+      _rb_arena_index _y = a._m_link(_xpp)._m_right;
+      if (!local_rb_arena_is_black(a, _y)) {
+        a._m_link(_xp)._m_set_color(_s_black);
+        a._m_link(_y)._m_set_color(_s_black);
+        a._m_link(_xpp)._m_set_color(_s_red);
+        x = _xpp;
+      } else {
+        if (x == a._m_link(_xp)._m_right) {
+          x = _xp;
+          local_rb_arena_rotate_left(a, x);
+          _xp = a._m_link(x)._m_get_parent();
+        }
+        a._m_link(_xp)._m_set_color(_s_black);
+        a._m_link(_xpp)._m_set_color(_s_red);
+        local_rb_arena_rotate_right(a, _xpp);
+      }
+    } else {
+      _rb_arena_index _y = a._m_link(_xpp)._m_left;
+      if (!local_rb_arena_is_black(a, _y)) {
+        a._m_link(_xp)._m_set_color(_s_black);
+        a._m_link(_y)._m_set_color(_s_black);
+        a._m_link(_xpp)._m_set_color(_s_red);
+        x = _xpp;
+      } else {
+        if (x == a._m_link(_xp)._m_left) {
+          x = _xp;
+          local_rb_arena_rotate_right(a, x);
+          _xp = a._m_link(x)._m_get_parent();
+        }
+        a._m_link(_xp)._m_set_color(_s_black);
+        a._m_link(_xpp)._m_set_color(_s_red);
+        local_rb_arena_rotate_left(a, _xpp);
+      }
+    }
+  }
+  a._m_link(local_rb_arena_root(a))._m_set_color(_s_black);
+}
+
+/**
+ * @brief unlink z and rebalance, leftmost / rightmost of the header are kept up to date
+ * @return slot to free (always z)
+ */
+_rb_arena_index _rb_arena_rebalance_for_erase(const _rb_arena &a, _rb_arena_index z) throw() {
+  _rb_arena_link &_h = a._m_link(_s_arena_header);
+  _rb_arena_link &_z = a._m_link(z);
+  _rb_arena_index _zp = _z._m_get_parent();
+  _rb_arena_index _y = z;
+  _rb_arena_index _x = 0;
+  _rb_arena_index _x_parent = 0;
+  if (_z._m_left == 0)
+    _x = _z._m_right;
+  else if (_z._m_right == 0)
+    _x = _z._m_left;
+  else {
+    _y = local_rb_arena_minimum(a, _z._m_right);
+    _x = a._m_link(_y)._m_right;
+  }
+  if (_y != z) {
+    _rb_arena_link &_yl = a._m_link(_y);
+    a._m_link(_z._m_left)._m_set_parent(_y);
+    _yl._m_left = _z._m_left;
+    if (_y != _z._m_right) {
+      _x_parent = _yl._m_get_parent();
+      if (_x) a._m_link(_x)._m_set_parent(_x_parent);
+      a._m_link(_x_parent)._m_left = _x;
+      _yl._m_right = _z._m_right;
+      a._m_link(_z._m_right)._m_set_parent(_y);
+    } else
+      _x_parent = _y;
+    if (local_rb_arena_root(a) == z)
+      _h._m_set_parent(_y);
+    else if (a._m_link(_zp)._m_left == z)
+      a._m_link(_zp)._m_left = _y;
+    else
+      a._m_link(_zp)._m_right = _y;
+    _yl._m_set_parent(_zp);
+    bool _color = _yl._m_get_color();
+    _yl._m_set_color(_z._m_get_color());
+    _z._m_set_color(_color);
+    _y = z;
+  } else {
+    _x_parent = _zp;
+    if (_x)
+      a._m_link(_x)._m_set_parent(_zp);
+    if (local_rb_arena_root(a) == z)
+      _h._m_set_parent(_x);
+    else if (a._m_link(_zp)._m_left == z)
+      a._m_link(_zp)._m_left = _x;
+    else
+      a._m_link(_zp)._m_right = _x;
+    if (_h._m_left == z)
+      _h._m_left = _z._m_right == 0 ? _zp : local_rb_arena_minimum(a, _x);
+    if (_h._m_right == z)
+      _h._m_right = _z._m_left == 0 ? _zp : local_rb_arena_maximum(a, _x);
+  }
+  if (_z._m_get_color() != _s_red) {
+    while (_x != local_rb_arena_root(a) && local_rb_arena_is_black(a, _x)) {
+      _rb_arena_link &_p = a._m_link(_x_parent);
+      if (_x == _p._m_left) {
+        _rb_arena_index _w = _p._m_right;
+        if (!local_rb_arena_is_black(a, _w)) {
+          a._m_link(_w)._m_set_color(_s_black);
+          _p._m_set_color(_s_red);
+          local_rb_arena_rotate_left(a, _x_parent);
+          _w = _p._m_right;
+        }
+        _rb_arena_link &_wl = a._m_link(_w);
+        if (local_rb_arena_is_black(a, _wl._m_left) && local_rb_arena_is_black(a, _wl._m_right)) {
+          _wl._m_set_color(_s_red);
+          _x = _x_parent;
+          _x_parent = _p._m_get_parent();
+        } else {
+          if (local_rb_arena_is_black(a, _wl._m_right)) {
+            a._m_link(_wl._m_left)._m_set_color(_s_black);
+            _wl._m_set_color(_s_red);
+            local_rb_arena_rotate_right(a, _w);
+            _w = _p._m_right;
+          }
+          a._m_link(_w)._m_set_color(_p._m_get_color());
+          _p._m_set_color(_s_black);
+          if (a._m_link(_w)._m_right)
+            a._m_link(a._m_link(_w)._m_right)._m_set_color(_s_black);
+          local_rb_arena_rotate_left(a, _x_parent);
+          break;
+        }
+      } else {
+        _rb_arena_index _w = _p._m_left;
+        if (!local_rb_arena_is_black(a, _w)) {
+          a._m_link(_w)._m_set_color(_s_black);
+          _p._m_set_color(_s_red);
+          local_rb_arena_rotate_right(a, _x_parent);
+          _w = _p._m_left;
+        }
+        _rb_arena_link &_wl = a._m_link(_w);
+        if (local_rb_arena_is_black(a, _wl._m_right) && local_rb_arena_is_black(a, _wl._m_left)) {
+          _wl._m_set_color(_s_red);
+          _x = _x_parent;
+          _x_parent = _p._m_get_parent();
+        } else {
+          if (local_rb_arena_is_black(a, _wl._m_left)) {
+            a._m_link(_wl._m_right)._m_set_color(_s_black);
+            _wl._m_set_color(_s_red);
+            local_rb_arena_rotate_left(a, _w);
+            _w = _p._m_left;
+          }
+          a._m_link(_w)._m_set_color(_p._m_get_color());
+          _p._m_set_color(_s_black);
+          if (a._m_link(_w)._m_left)
+            a._m_link(a._m_link(_w)._m_left)._m_set_color(_s_black);
+          local_rb_arena_rotate_right(a, _x_parent);
           break;
         }
       }
-    if (_x) _x->_m_color = _s_black;
+    }
+    if (_x) a._m_link(_x)._m_set_color(_s_black);
   }
   return _y;
 }
 
-} // namespace ft
\ No newline at end of file
+} // namespace ft
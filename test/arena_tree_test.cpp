@@ -0,0 +1,128 @@
+/*
+ * File: arena_tree_test.cpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#include "gtest/gtest.h"
+#include "arena_tree.hpp"
+#include "map.hpp"
+#include "pair.hpp"
+
+#include <map>
+#include <string>
+#include <cstdlib>
+
+typedef ft::pair<int, int> arena_value_type;
+typedef ft::_rb_arena_tree<int, arena_value_type> arena_tree_type;
+
+TEST(RbArenaTreeTest, nodeSizeTest) {
+  // three 32 bit links and the value, no padding for ft::pair<int, int>
+  EXPECT_EQ(sizeof(ft::_rb_arena_node<arena_value_type>), 20u);
+  EXPECT_LT(sizeof(ft::_rb_arena_node<arena_value_type>), sizeof(ft::_rb_tree_node<arena_value_type>));
+}
+
+// a node with a single child must have the same black height on its empty side as every leaf
+TEST(RbArenaTreeTest, verifyOneChildTest) {
+  arena_tree_type tree;
+  int keys[] = {4, 2, 6, 1, 3, 5, 7};
+  for (int i = 0; i < 7; i++)
+    tree.insert_unique(arena_value_type(keys[i], 0));
+  tree.erase(5);
+  ASSERT_TRUE(tree._m_verify());
+
+  // 6 keeps only its right child : leaves 1, 3, 7 all have 3 blacks but the empty left of 6 has 2
+  int reds[] = {1, 3, 7};
+  for (int i = 0; i < 3; i++) {
+    arena_tree_type::iterator it = tree.find(reds[i]);
+    ASSERT_EQ(it._m_arena->_m_link(it._m_node)._m_get_color(), ft::_s_red);
+    it._m_arena->_m_link(it._m_node)._m_set_color(ft::_s_black);
+  }
+  EXPECT_FALSE(tree._m_verify());
+  for (int i = 0; i < 3; i++) {
+    arena_tree_type::iterator it = tree.find(reds[i]);
+    it._m_arena->_m_link(it._m_node)._m_set_color(ft::_s_red);
+  }
+  EXPECT_TRUE(tree._m_verify());
+}
+
+TEST(RbArenaTreeTest, randomOperationTest) {
+  arena_tree_type tree;
+  std::map<int, int> ref;
+
+  srand(11);
+  for (int i = 0; i < 20000; i++) {
+    int k = rand() % 2000;
+    if (rand() % 3) {
+      bool inserted = tree.insert_unique(arena_value_type(k, i)).second;
+      EXPECT_EQ(inserted, ref.insert(std::make_pair(k, i)).second);
+    } else {
+      EXPECT_EQ(tree.erase(k), ref.erase(k));
+    }
+  }
+  ASSERT_TRUE(tree._m_verify());
+  ASSERT_EQ(tree.size(), ref.size());
+
+  std::map<int, int>::iterator rit = ref.begin();
+  for (arena_tree_type::iterator it = tree.begin(); it != tree.end(); ++it, ++rit) {
+    EXPECT_EQ(it->first, rit->first);
+    EXPECT_EQ(it->second, rit->second);
+  }
+  std::map<int, int>::reverse_iterator rrit = ref.rbegin();
+  for (arena_tree_type::reverse_iterator it = tree.rbegin(); it != tree.rend(); ++it, ++rrit)
+    EXPECT_EQ(it->first, rrit->first);
+
+  // erased slots are reused before the arena grows
+  size_t capacity = tree.capacity();
+  tree.erase(tree.begin(), tree.find(ref.rbegin()->first));
+  ASSERT_TRUE(tree._m_verify());
+  EXPECT_EQ(tree.size(), 1u);
+  for (int i = 0; i < 1000; i++)
+    tree.insert_unique(arena_value_type(i, i));
+  EXPECT_TRUE(tree._m_verify());
+  EXPECT_EQ(tree.capacity(), capacity);
+}
+
+TEST(RbArenaTreeTest, copyTest) {
+  arena_tree_type tree;
+  for (int i = 0; i < 1000; i++)
+    tree.insert_unique(tree.end(), arena_value_type(i, -i));
+  tree.erase(500);
+
+  // the copy is a byte copy of the arena
+  arena_tree_type copy(tree);
+  EXPECT_TRUE(copy._m_verify());
+  EXPECT_TRUE(copy == tree);
+  copy.erase(0);
+  EXPECT_TRUE(tree < copy);
+  tree = copy;
+  EXPECT_TRUE(tree._m_verify());
+  EXPECT_TRUE(tree == copy);
+
+  tree.clear();
+  EXPECT_TRUE(tree._m_verify());
+  EXPECT_TRUE(tree.begin() == tree.end());
+}
+
+TEST(RbArenaTreeTest, mapTagTest) {
+  typedef ft::map<std::string, int, std::less<std::string>,
+                  std::allocator<ft::pair<const std::string, int> >, ft::rb_tree_arena_tag> map_type;
+  map_type m;
+  map_type::iterator first = m.insert(ft::make_pair(std::string("a"), 0)).first;
+  // iterators hold slot numbers, they survive the growth of the arena
+  for (int i = 1; i < 1000; i++)
+    m[std::string(1, static_cast<char>('a' + i % 26)) + static_cast<char>('a' + i / 26)] = i;
+  EXPECT_EQ(first->first, "a");
+  EXPECT_EQ(m.size(), 1000u);
+  EXPECT_EQ(m.erase("ab"), 1u);
+
+  map_type copy(m);
+  EXPECT_TRUE(copy == m);
+  std::string prev;
+  for (map_type::const_iterator it = copy.begin(); it != copy.end(); ++it) {
+    EXPECT_LT(prev, it->first);
+    prev = it->first;
+  }
+}
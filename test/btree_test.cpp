@@ -0,0 +1,216 @@
+/*
+ * File: btree_test.cpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#include "gtest/gtest.h"
+#include "btree.hpp"
+#include "map.hpp"
+#include "pair.hpp"
+
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+typedef ft::pair<int, int> btree_value_type;
+typedef ft::_btree<int, btree_value_type> btree_type;
+
+TEST(BTreeTest, randomOperationTest) {
+  btree_type tree;
+  std::map<int, int> ref;
+
+  srand(7);
+  for (int i = 0; i < 20000; i++) {
+    int k = rand() % 2000;
+    int op = rand() % 4;
+    if (op < 2) {
+      bool inserted = tree.insert_unique(btree_value_type(k, i)).second;
+      EXPECT_EQ(inserted, ref.insert(std::make_pair(k, i)).second);
+    } else if (op == 2) {
+      EXPECT_EQ(tree.erase(k), ref.erase(k));
+    } else {
+      btree_type::iterator it = tree.lower_bound(k);
+      std::map<int, int>::iterator rit = ref.lower_bound(k);
+      ASSERT_EQ(it == tree.end(), rit == ref.end());
+      if (rit != ref.end()) {
+        EXPECT_EQ(it->first, rit->first);
+      }
+    }
+  }
+  ASSERT_TRUE(tree._m_verify());
+  ASSERT_EQ(tree.size(), ref.size());
+
+  std::map<int, int>::iterator rit = ref.begin();
+  for (btree_type::iterator it = tree.begin(); it != tree.end(); ++it, ++rit) {
+    EXPECT_EQ(it->first, rit->first);
+    EXPECT_EQ(it->second, rit->second);
+  }
+  std::map<int, int>::reverse_iterator rrit = ref.rbegin();
+  for (btree_type::reverse_iterator it = tree.rbegin(); it != tree.rend(); ++it, ++rrit)
+    EXPECT_EQ(it->first, rrit->first);
+
+  // drain
+  while (!tree.empty()) {
+    tree.erase(tree.begin());
+    ASSERT_TRUE(tree.size() % 97 || tree._m_verify());
+  }
+  EXPECT_TRUE(tree._m_verify());
+  EXPECT_TRUE(tree.begin() == tree.end());
+}
+
+TEST(BTreeTest, sortedAppendTest) {
+  std::vector<btree_value_type> v;
+  for (int i = 0; i < 5000; i++)
+    v.push_back(btree_value_type(i * 2, i));
+
+  btree_type tree;
+  tree.insert_sorted_unique(v.begin(), v.end());
+  ASSERT_TRUE(tree._m_verify());
+  ASSERT_EQ(tree.size(), v.size());
+  EXPECT_EQ(tree.find(4000)->second, 2000);
+  EXPECT_TRUE(tree.find(4001) == tree.end());
+
+  btree_type copy(tree);
+  EXPECT_TRUE(copy._m_verify());
+  EXPECT_TRUE(copy == tree);
+
+  tree.erase(tree.find(1000), tree.find(3000));
+  ASSERT_TRUE(tree._m_verify());
+  EXPECT_EQ(tree.size(), v.size() - 1000);
+  EXPECT_EQ(tree.lower_bound(1000)->first, 3000);
+  EXPECT_TRUE(copy < tree);
+}
+
+// counts node allocations and frees (all rebinds share the counters)
+static size_t g_btree_allocated;
+static size_t g_btree_freed;
+
+template<class T>
+struct counting_allocator : public std::allocator<T> {
+  template<class U>
+  struct rebind { typedef counting_allocator<U> other; };
+
+  counting_allocator() {}
+  counting_allocator(const counting_allocator &x) : std::allocator<T>(x) {}
+  template<class U>
+  counting_allocator(const counting_allocator<U> &x) : std::allocator<T>(x) {}
+
+  T *allocate(size_t n) {
+    ++g_btree_allocated;
+    return std::allocator<T>::allocate(n);
+  }
+  void deallocate(T *p, size_t n) {
+    ++g_btree_freed;
+    std::allocator<T>::deallocate(p, n);
+  }
+};
+
+TEST(BTreeTest, splitAllocationTest) {
+  // insertions only : every reserved node must end up in the tree, none allocated just to be freed
+  g_btree_allocated = 0;
+  g_btree_freed = 0;
+  {
+    ft::_btree<int, btree_value_type, ft::Select1st<btree_value_type>, std::less<int>,
+               counting_allocator<btree_value_type> > tree;
+    srand(3);
+    for (int i = 0; i < 20000; i++)
+      tree.insert_unique(btree_value_type(rand(), i));
+    ASSERT_TRUE(tree._m_verify());
+    EXPECT_EQ(g_btree_freed, 0u);
+  }
+  EXPECT_EQ(g_btree_freed, g_btree_allocated);
+}
+
+// copies of a btree_throwing_key throw when the countdown reaches zero (0 : never)
+static int g_btree_copies_left;
+
+struct btree_throwing_key {
+  int value;
+
+  explicit btree_throwing_key(int v) : value(v) {}
+  btree_throwing_key(const btree_throwing_key &x) : value(x.value) {
+    if (g_btree_copies_left != 0 && --g_btree_copies_left == 0)
+      throw std::runtime_error("btree_throwing_key");
+  }
+  bool operator<(const btree_throwing_key &x) const { return value < x.value; }
+};
+
+TEST(BTreeTest, throwingCopyTest) {
+  typedef ft::pair<const btree_throwing_key, int> value_type;
+  typedef ft::_btree<btree_throwing_key, value_type, ft::Select1st<value_type>, std::less<btree_throwing_key>,
+                     counting_allocator<value_type> > tree_type;
+  g_btree_allocated = 0;
+  g_btree_freed = 0;
+  {
+    tree_type tree;
+    std::set<int> ref;
+    srand(11);
+    for (int i = 0; i < 6000; i++) {
+      // front inserts, random inserts and erases ; the n-th copy made by the operation fails
+      int k = i % 3 == 0 ? -i : rand() % 3000;
+      value_type v(btree_throwing_key(k), i);
+      g_btree_copies_left = rand() % 3 + 1;
+      if (i % 4 == 3) {
+        // erase never copies a key, so it never throws
+        size_t erased = 0;
+        EXPECT_NO_THROW(erased = tree.erase(btree_throwing_key(k)));
+        EXPECT_EQ(erased, ref.erase(k));
+      } else {
+        try {
+          if (tree.insert_unique(v).second)
+            ref.insert(k);
+        } catch (const std::runtime_error &) {
+          // a failed insert leaves the tree as it was
+        }
+      }
+      g_btree_copies_left = 0;
+      ASSERT_EQ(tree.size(), ref.size());
+      ASSERT_TRUE(i % 97 || tree._m_verify());
+    }
+    ASSERT_TRUE(tree._m_verify());
+    std::set<int>::iterator rit = ref.begin();
+    for (tree_type::iterator it = tree.begin(); it != tree.end(); ++it, ++rit)
+      EXPECT_EQ(it->first.value, *rit);
+    for (rit = ref.begin(); rit != ref.end(); ++rit)
+      EXPECT_TRUE(tree.find(btree_throwing_key(*rit)) != tree.end());
+
+    g_btree_copies_left = 1;
+    EXPECT_NO_THROW(tree.erase(tree.lower_bound(btree_throwing_key(100)), tree.lower_bound(btree_throwing_key(2000))));
+    g_btree_copies_left = 0;
+    EXPECT_TRUE(tree._m_verify());
+    EXPECT_TRUE(tree.lower_bound(btree_throwing_key(100)) == tree.lower_bound(btree_throwing_key(2000)));
+  }
+  // every node, value and key block went back
+  EXPECT_EQ(g_btree_freed, g_btree_allocated);
+}
+
+TEST(BTreeTest, mapTagTest) {
+  ft::map<std::string, int, std::less<std::string>,
+          std::allocator<ft::pair<const std::string, int> >, ft::btree_tag> m;
+  for (int i = 0; i < 1000; i++)
+    m[std::string("key") + static_cast<char>('a' + i % 26) + static_cast<char>('a' + i / 26)] = i;
+  EXPECT_EQ(m.size(), 1000u);
+  EXPECT_EQ(m["keyaa"], 0);
+  EXPECT_EQ(m.count("nokey"), 0u);
+  EXPECT_EQ(m.erase("keyab"), 1u);
+  EXPECT_EQ(m.size(), 999u);
+
+  int prev = -1;
+  std::string prev_key;
+  for (ft::map<std::string, int, std::less<std::string>,
+               std::allocator<ft::pair<const std::string, int> >, ft::btree_tag>::iterator it = m.begin();
+       it != m.end(); ++it) {
+    EXPECT_LT(prev_key, it->first);
+    prev_key = it->first;
+    prev = it->second;
+  }
+  EXPECT_NE(prev, -1);
+  m.clear();
+  EXPECT_TRUE(m.empty());
+}
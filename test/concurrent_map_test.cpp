@@ -0,0 +1,143 @@
+/*
+ * File: concurrent_map_test.cpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#include "gtest/gtest.h"
+#include "concurrent_map.hpp"
+
+#include <pthread.h>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+typedef ft::concurrent_map<int, int> cmap;
+
+TEST(ConcurrentMapTest, singleThreadTest) {
+  for (size_t shards = 1; shards <= 64; shards *= 8) {
+    cmap m(shards);
+    std::map<int, int> expected;
+    EXPECT_EQ(m.shard_count(), shards);
+
+    srand(22);
+    for (int i = 0; i < 5000; i++) {
+      int k = rand() % 700;
+      switch (rand() % 3) {
+        case 0:
+          EXPECT_EQ(m.insert(ft::make_pair(k, i)), expected.insert(std::make_pair(k, i)).second);
+          break;
+        case 1:
+          EXPECT_EQ(m.insert_or_assign(k, i), expected.count(k) == 0);
+          expected[k] = i;
+          break;
+        default:
+          EXPECT_EQ(m.erase(k), expected.erase(k));
+      }
+    }
+    ASSERT_EQ(m.size(), expected.size());
+    for (int k = 0; k < 700; k++) {
+      int _value = -1;
+      std::map<int, int>::const_iterator it = expected.find(k);
+      ASSERT_EQ(m.find(k, _value), it != expected.end());
+      ASSERT_EQ(m.count(k), expected.count(k));
+      if (it != expected.end()) {
+        ASSERT_EQ(_value, it->second);
+      }
+    }
+    m.clear();
+    EXPECT_TRUE(m.empty());
+  }
+  // shard counts are rounded up to a power of two
+  EXPECT_EQ(cmap(5).shard_count(), 8u);
+}
+
+struct increment {
+  void operator()(int &x) const { ++x; }
+};
+
+struct sum_values {
+  long sum;
+  sum_values() : sum(0) {}
+  void operator()(const ft::pair<const int, int> &x) { sum += x.second; }
+};
+
+TEST(ConcurrentMapTest, visitTest) {
+  ft::concurrent_map<std::string, int> words(4);
+  words.insert(ft::make_pair(std::string("a"), 1));
+  EXPECT_TRUE(words.update("a", increment()));
+  EXPECT_FALSE(words.update("b", increment()));
+  int _value = 0;
+  EXPECT_TRUE(words.find("a", _value));
+  EXPECT_EQ(_value, 2);
+
+  cmap m;
+  for (int i = 1; i <= 100; i++)
+    m.insert(ft::make_pair(i, i));
+  sum_values _one;
+  EXPECT_TRUE(m.visit(7, _one));
+  EXPECT_FALSE(m.visit(0, sum_values()));
+  EXPECT_EQ(m.for_each(sum_values()).sum, 5050);
+}
+
+struct worker_arg {
+  cmap *m;
+  int id;
+  long found;
+};
+
+// writers own a disjoint range of keys, readers look at all of them
+void *write_keys(void *p) {
+  worker_arg *_arg = static_cast<worker_arg *>(p);
+  for (int round = 0; round < 3; round++)
+    for (int i = 0; i < 2000; i++) {
+      int k = _arg->id * 2000 + i;
+      if (round == 0)
+        _arg->m->insert(ft::make_pair(k, 0));
+      else
+        _arg->m->update(k, increment());
+    }
+  for (int i = 0; i < 2000; i += 2)
+    _arg->m->erase(_arg->id * 2000 + i);
+  return NULL;
+}
+
+void *read_keys(void *p) {
+  worker_arg *_arg = static_cast<worker_arg *>(p);
+  for (int i = 0; i < 20000; i++) {
+    int _value = -1;
+    if (_arg->m->find(i % 8000, _value)) {
+      if (_value < 0 || _value > 2)
+        return p;  // torn value
+      ++_arg->found;
+    }
+  }
+  return NULL;
+}
+
+TEST(ConcurrentMapTest, concurrentTest) {
+  cmap m(16);
+  worker_arg args[8];
+  pthread_t threads[8];
+  for (int i = 0; i < 8; i++) {
+    args[i].m = &m;
+    args[i].id = i;
+    args[i].found = 0;
+    ASSERT_EQ(pthread_create(&threads[i], NULL, i < 4 ? write_keys : read_keys, &args[i]), 0);
+  }
+  for (int i = 0; i < 8; i++) {
+    void *_result;
+    pthread_join(threads[i], &_result);
+    EXPECT_TRUE(_result == NULL);
+  }
+  ASSERT_EQ(m.size(), 4000u);
+  for (int k = 0; k < 8000; k++) {
+    int _value = -1;
+    ASSERT_EQ(m.find(k, _value), k % 2 == 1);
+    if (k % 2 == 1) {
+      ASSERT_EQ(_value, 2);
+    }
+  }
+}
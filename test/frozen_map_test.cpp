@@ -0,0 +1,191 @@
+/*
+ * File: frozen_map_test.cpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#include "gtest/gtest.h"
+#include "frozen_map.hpp"
+#include "map.hpp"
+#include "pair.hpp"
+
+#include <functional>
+#include <limits>
+#include <new>
+#include <string>
+#include <stdexcept>
+
+TEST(FrozenMapTest, lookupTest) {
+  // every size up to a few full levels, so that all shapes of the last level are covered
+  for (int n = 0; n < 70; n++) {
+    ft::map<int, int> m;
+    for (int i = 0; i < n; i++)
+      m[i * 2] = i;
+    ft::frozen_map<int, int> f = m.freeze();
+    ASSERT_EQ(f.size(), m.size());
+
+    for (int k = -2; k <= n * 2 + 1; k++) {
+      ft::frozen_map<int, int>::iterator lb = f.lower_bound(k);
+      ft::frozen_map<int, int>::iterator ub = f.upper_bound(k);
+      if (m.lower_bound(k) == m.end()) {
+        EXPECT_TRUE(lb == f.end());
+      } else {
+        EXPECT_EQ(lb->first, m.lower_bound(k)->first);
+      }
+      if (m.upper_bound(k) == m.end()) {
+        EXPECT_TRUE(ub == f.end());
+      } else {
+        EXPECT_EQ(ub.key(), m.upper_bound(k)->first);
+      }
+      EXPECT_EQ(f.count(k), m.count(k));
+      if (m.count(k)) {
+        EXPECT_EQ(f.find(k).value(), m[k]);
+      }
+    }
+  }
+}
+
+TEST(FrozenMapTest, layoutTest) {
+  EXPECT_TRUE((ft::is_same<ft::frozen_map<int, int>::_layout, ft::_frozen_block_layout<int, std::less<int> > >::value));
+  EXPECT_TRUE((ft::is_same<ft::frozen_map<long, int, ft::less<long> >::_layout,
+                           ft::_frozen_block_layout<long, ft::less<long> > >::value));
+  EXPECT_TRUE((ft::is_same<ft::frozen_map<int, int, std::greater<int> >::_layout,
+                           ft::_frozen_eytzinger_layout<int, std::greater<int> > >::value));
+  EXPECT_TRUE((ft::is_same<ft::frozen_map<double, int>::_layout,
+                           ft::_frozen_eytzinger_layout<double, std::less<double> > >::value));
+}
+
+// several layers of block maxima, keys at both ends of the type
+template<class Key, class Compare>
+void frozen_block_test(int n) {
+  ft::map<Key, int, Compare> m;
+  const Key max = std::numeric_limits<Key>::max();
+  const Key min = std::numeric_limits<Key>::min();
+  m[max] = -1;
+  m[min] = -2;
+  for (int i = 0; i < n; i++)
+    m[static_cast<Key>(i) * 5 - 1000] = i;
+  ft::frozen_map<Key, int, Compare> f = m.freeze();
+
+  const Key probes[] = {min, static_cast<Key>(min + 1), -1001, -1000, -999, 0, 3, static_cast<Key>(n * 5 - 1005),
+                        static_cast<Key>(n * 5), static_cast<Key>(max - 1), max};
+  for (size_t i = 0; i < sizeof(probes) / sizeof(*probes); i++) {
+    Key k = probes[i];
+    EXPECT_EQ(f.lower_bound(k).key(), m.lower_bound(k)->first);
+    if (m.upper_bound(k) == m.end()) {
+      EXPECT_TRUE(f.upper_bound(k) == f.end());
+    } else {
+      EXPECT_EQ(f.upper_bound(k).key(), m.upper_bound(k)->first);
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(f.at(static_cast<Key>(i) * 5 - 1000), i);
+    EXPECT_EQ(f.count(static_cast<Key>(i) * 5 - 999), 0u);
+  }
+  EXPECT_EQ(f.at(max), -1);
+  EXPECT_EQ((--f.end()).key(), (--m.end())->first);
+}
+
+TEST(FrozenMapTest, blockLayoutTest) {
+  frozen_block_test<int, std::less<int> >(5000);
+  frozen_block_test<long, std::less<long> >(5000);
+  frozen_block_test<long long, ft::less<long long> >(300);
+  frozen_block_test<short, std::less<short> >(1000);
+  frozen_block_test<int, std::greater<int> >(1000);
+}
+
+// constructs / destroys counted, the allocation number g_frozen_alloc_fail throws
+static int g_frozen_live;
+static int g_frozen_alloc_fail;
+
+template<class T>
+struct frozen_test_allocator : public std::allocator<T> {
+  template<class U>
+  struct rebind { typedef frozen_test_allocator<U> other; };
+
+  frozen_test_allocator() {}
+  frozen_test_allocator(const frozen_test_allocator &x) : std::allocator<T>(x) {}
+  template<class U>
+  frozen_test_allocator(const frozen_test_allocator<U> &x) : std::allocator<T>(x) {}
+
+  T *allocate(size_t n) {
+    if (--g_frozen_alloc_fail == 0)
+      throw std::bad_alloc();
+    return std::allocator<T>::allocate(n);
+  }
+  void construct(T *p, const T &val) {
+    new(p) T(val);
+    ++g_frozen_live;
+  }
+  void destroy(T *p) {
+    p->~T();
+    --g_frozen_live;
+  }
+};
+
+TEST(FrozenMapTest, buildThrowTest) {
+  typedef ft::frozen_map<int, int, std::less<int>, frozen_test_allocator<ft::pair<const int, int> > > frozen_type;
+  ft::map<int, int> m;
+  for (int i = 0; i < 1000; i++)
+    m[i] = i;
+
+  // keys, values, then the block index : fail each of them in turn
+  for (int fail = 1; fail <= 3; fail++) {
+    g_frozen_live = 0;
+    g_frozen_alloc_fail = fail;
+    EXPECT_THROW(frozen_type(m.begin(), m.end()), std::bad_alloc);
+    EXPECT_EQ(g_frozen_live, 0) << fail;
+  }
+  g_frozen_alloc_fail = 0;
+  {
+    frozen_type f(m.begin(), m.end());
+    EXPECT_EQ(g_frozen_live, 2000);
+    EXPECT_EQ(f.find(500).value(), 500);
+  }
+  EXPECT_EQ(g_frozen_live, 0);
+}
+
+TEST(FrozenMapTest, iteratorTest) {
+  ft::map<int, int> m;
+  for (int i = 0; i < 100; i++)
+    m[i * 3] = -i;
+  ft::frozen_map<int, int> f = m.freeze();
+
+  ft::map<int, int>::iterator m_it = m.begin();
+  for (ft::frozen_map<int, int>::iterator it = f.begin(); it != f.end(); ++it, ++m_it) {
+    EXPECT_EQ((*it).first, m_it->first);
+    EXPECT_EQ(it->second, m_it->second);
+  }
+  EXPECT_TRUE(m_it == m.end());
+
+  ft::frozen_map<int, int>::iterator it = f.end();
+  do {
+    --it;
+    --m_it;
+    EXPECT_EQ(it.key(), m_it->first);
+  } while (it != f.begin());
+  EXPECT_EQ((--f.end()).key(), 297);
+}
+
+TEST(FrozenMapTest, copyTest) {
+  ft::map<std::string, std::string> m;
+  m["apple"] = "red";
+  m["banana"] = "yellow";
+  m["cherry"] = "dark red";
+  ft::frozen_map<std::string, std::string> f = m.freeze();
+  ft::frozen_map<std::string, std::string> copy(f);
+  ft::frozen_map<std::string, std::string> assigned;
+  assigned = copy;
+  m.clear();
+
+  EXPECT_TRUE(f == assigned);
+  EXPECT_EQ(assigned.at("banana"), "yellow");
+  EXPECT_THROW(assigned.at("durian"), std::out_of_range);
+
+  f.clear();
+  EXPECT_TRUE(f.empty());
+  EXPECT_TRUE(f.begin() == f.end());
+  EXPECT_TRUE(f != copy);
+}
@@ -0,0 +1,148 @@
+/*
+ * File: lockfree_skiplist_test.cpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#include "gtest/gtest.h"
+#include "lockfree_skiplist.hpp"
+
+#include <pthread.h>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+typedef ft::lockfree_skiplist<int, int> skiplist;
+
+TEST(LockfreeSkiplistTest, singleThreadTest) {
+  skiplist m;
+  std::map<int, int> expected;
+  EXPECT_TRUE(m.empty());
+
+  srand(23);
+  for (int i = 0; i < 20000; i++) {
+    int k = rand() % 1000;
+    if (rand() % 2) {
+      ft::pair<skiplist::iterator, bool> _result = m.insert(ft::make_pair(k, i));
+      ASSERT_EQ(_result.second, expected.insert(std::make_pair(k, i)).second);
+      ASSERT_EQ(_result.first->second, expected[k]);
+    } else {
+      ASSERT_EQ(m.erase(k), expected.erase(k));
+    }
+  }
+  ASSERT_EQ(m.size(), expected.size());
+  std::map<int, int>::const_iterator e = expected.begin();
+  for (skiplist::iterator it = m.begin(); it != m.end(); ++it, ++e) {
+    ASSERT_TRUE(e != expected.end());
+    ASSERT_EQ(it->first, e->first);
+    ASSERT_EQ(it->second, e->second);
+  }
+  EXPECT_TRUE(e == expected.end());
+
+  for (int k = -1; k <= 1000; k++) {
+    std::map<int, int>::const_iterator lower = expected.lower_bound(k);
+    std::map<int, int>::const_iterator upper = expected.upper_bound(k);
+    ASSERT_EQ(m.lower_bound(k) == m.end(), lower == expected.end());
+    if (lower != expected.end()) {
+      ASSERT_EQ(m.lower_bound(k)->first, lower->first);
+    }
+    if (upper != expected.end()) {
+      ASSERT_EQ(m.upper_bound(k)->first, upper->first);
+    }
+    ASSERT_EQ(m.count(k), expected.count(k));
+    ASSERT_EQ(m.find(k) == m.end(), expected.find(k) == expected.end());
+  }
+
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.size(), 0u);
+}
+
+TEST(LockfreeSkiplistTest, iteratorKeepsErasedElementTest) {
+  ft::lockfree_skiplist<int, std::string> m;
+  for (int i = 0; i < 10; i++)
+    m.insert(ft::make_pair(i, std::string(100, 'a' + i)));
+
+  // an iterator keeps the node alive (and can still move on) after it is erased
+  ft::lockfree_skiplist<int, std::string>::iterator it = m.find(3);
+  EXPECT_EQ(m.erase(3), 1u);
+  EXPECT_EQ(m.erase(3), 0u);
+  for (int i = 0; i < 1000; i++) {
+    m.insert(ft::make_pair(100 + i, std::string()));
+    m.erase(100 + i);
+  }
+  EXPECT_EQ(it->second, std::string(100, 'd'));
+  ++it;
+  EXPECT_EQ(it->first, 4);
+  EXPECT_TRUE(m.find(3) == m.end());
+}
+
+struct skiplist_worker_arg {
+  skiplist *m;
+  int id;
+};
+
+// every thread inserts and erases its own keys (id modulo 4) while the others read through them
+void *churn(void *p) {
+  skiplist_worker_arg *_arg = static_cast<skiplist_worker_arg *>(p);
+  unsigned _x = 12345u + _arg->id;
+  for (int i = 0; i < 20000; i++) {
+    _x ^= _x << 13;
+    _x ^= _x >> 17;
+    _x ^= _x << 5;
+    int k = static_cast<int>(_x % 2000) / 4 * 4 + _arg->id;
+    switch (_x % 3) {
+      case 0:
+        _arg->m->insert(ft::make_pair(k, k));
+        break;
+      case 1:
+        _arg->m->erase(k);
+        break;
+      default: {
+        skiplist::iterator it = _arg->m->lower_bound(k);
+        if (it != _arg->m->end() && it->second != it->first)
+          return p;  // torn element
+        for (int j = 0; j < 8 && it != _arg->m->end(); j++) {
+          int _prev = it->first;
+          if (++it != _arg->m->end() && it->first <= _prev)
+            return p;  // out of order
+        }
+      }
+    }
+  }
+  // leave only the odd keys of this thread
+  for (int k = _arg->id; k < 2000; k += 4)
+    if (k % 8 < 4)
+      _arg->m->insert(ft::make_pair(k, k));
+    else
+      _arg->m->erase(k);
+  return NULL;
+}
+
+TEST(LockfreeSkiplistTest, concurrentTest) {
+  skiplist m;
+  skiplist_worker_arg args[4];
+  pthread_t threads[4];
+  for (int i = 0; i < 4; i++) {
+    args[i].m = &m;
+    args[i].id = i;
+    ASSERT_EQ(pthread_create(&threads[i], NULL, churn, &args[i]), 0);
+  }
+  for (int i = 0; i < 4; i++) {
+    void *_result;
+    pthread_join(threads[i], &_result);
+    EXPECT_TRUE(_result == NULL);
+  }
+
+  int _expected = 0;
+  for (skiplist::iterator it = m.begin(); it != m.end(); ++it) {
+    while (_expected % 8 >= 4)
+      _expected++;
+    ASSERT_EQ(it->first, _expected);
+    _expected++;
+  }
+  EXPECT_EQ(_expected, 2000 - 4);
+  EXPECT_EQ(m.size(), 1000u);
+}
@@ -11,6 +11,10 @@
 #include "map.hpp"
 
 #include <map>
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include <iterator>
 #include <iostream>
 
 #define SHOW(...) \
@@ -67,4 +71,381 @@ TEST (MAP_ITERATOR_TEST, iteratorTest) {
   }
   it = first.end();
   SHOW((--it)->first);
-}
\ No newline at end of file
+}
+TEST(MAP_BULK_TEST, sortedUniqueTest) {
+  std::vector<ft::pair<int, int> > src;
+  for (int i = 0; i < 1000; i++)
+    src.push_back(ft::make_pair(i * 3, i));
+
+  ft::map<int, int> detected(src.begin(), src.end());
+  ft::map<int, int> told(ft::sorted_unique, src.begin(), src.end());
+  ft::map<int, int> inserted;
+  inserted.insert(ft::sorted_unique, src.begin(), src.end());
+
+  EXPECT_EQ(detected.size(), src.size());
+  EXPECT_TRUE(detected == told);
+  EXPECT_TRUE(told == inserted);
+  std::vector<ft::pair<int, int> >::iterator s_it = src.begin();
+  for (ft::map<int, int>::iterator it = told.begin(); it != told.end(); ++it, ++s_it) {
+    EXPECT_EQ(it->first, s_it->first);
+    EXPECT_EQ(it->second, s_it->second);
+  }
+  EXPECT_EQ(told.find(2997)->second, 999);
+  EXPECT_TRUE(told.find(2998) == told.end());
+}
+
+TEST(MAP_FIND_MANY_TEST, findManyTest) {
+  ft::map<int, int> m;
+  for (int i = 0; i < 1000; i++)
+    m[i * 2] = i;
+
+  std::vector<int> keys;
+  for (int i = 0; i < 100; i++)
+    keys.push_back((i * 37) % 2100 - 50); // present, missing, below and above all keys
+  std::vector<ft::map<int, int>::iterator> found(keys.size());
+  EXPECT_TRUE(m.find_many(keys.begin(), keys.end(), found.begin()) == found.end());
+  for (size_t i = 0; i < keys.size(); i++)
+    EXPECT_TRUE(found[i] == m.find(keys[i]));
+
+  const ft::map<int, int> &cm = m;
+  std::vector<ft::map<int, int>::const_iterator> cfound;
+  cm.find_many(keys.begin(), keys.begin() + 3, std::back_inserter(cfound));
+  ASSERT_EQ(cfound.size(), 3u);
+  EXPECT_TRUE(cfound[2] == cm.find(keys[2]));
+
+  ft::map<int, int> empty;
+  empty.find_many(keys.begin(), keys.end(), found.begin());
+  EXPECT_TRUE(found[0] == empty.end());
+}
+
+TEST(MAP_SPLIT_JOIN_TEST, splitJoinTest) {
+  ft::map<int, int> m;
+  for (int i = 0; i < 1000; i++)
+    m[i] = i;
+
+  ft::map<int, int> upper;
+  m.split(600, upper);
+  EXPECT_EQ(m.size(), 600u);
+  EXPECT_EQ(upper.size(), 400u);
+  EXPECT_EQ(upper.begin()->first, 600);
+  EXPECT_TRUE(m.find(600) == m.end());
+
+  upper.split(800, upper); // splitting into itself does nothing
+  EXPECT_EQ(upper.size(), 400u);
+
+  m.join(upper);
+  EXPECT_TRUE(upper.empty());
+  EXPECT_EQ(m.size(), 1000u);
+  int expected = 0;
+  for (ft::map<int, int>::iterator it = m.begin(); it != m.end(); ++it, ++expected)
+    EXPECT_EQ(it->second, expected);
+}
+
+TEST(MAP_SPLIT_JOIN_TEST, overlapJoinTest) {
+  ft::map<int, int> a;
+  a[1] = 10;
+  a[5] = 50;
+  ft::map<int, int> b;
+  b[3] = 30;
+  b[5] = 55;
+  b[9] = 90;
+  const int *moved = &b[3];
+
+  // overlapping keys : the nodes are relinked, the colliding element stays in b
+  a.join(b);
+  EXPECT_EQ(a.size(), 4u);
+  EXPECT_EQ(a[5], 50);
+  EXPECT_EQ(&a[3], moved);
+  EXPECT_EQ(a[9], 90);
+  ASSERT_EQ(b.size(), 1u);
+  EXPECT_EQ(b.begin()->first, 5);
+  EXPECT_EQ(b.begin()->second, 55);
+}
+
+#ifndef FT_RB_TREE_COMPACT  // no subtree size in the compact node layout
+TEST(MAP_ORDER_STATISTIC_TEST, percentileTest) {
+  typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+                  ft::rb_tree_order_statistic_tag> os_map;
+  os_map m;
+  for (int i = 0; i < 100; i++)
+    m[i * 10] = i;
+
+  EXPECT_EQ(m.rank(0), 0u);
+  EXPECT_EQ(m.rank(55), 6u);
+  EXPECT_EQ(m.select(90)->first, 900);
+  EXPECT_TRUE(m.select(100) == m.end());
+  EXPECT_EQ(m.count_range(100, 200), 10u);
+  EXPECT_EQ((m.begin() + 50)->second, 50);
+  EXPECT_EQ(m.end() - m.begin(), 100);
+
+  m.erase(500);
+  EXPECT_EQ(m.count_range(0, 1000), 99u);
+  EXPECT_EQ(m.select(50)->first, 510);
+}
+#endif
+
+TEST(MAP_SET_ALGEBRA_TEST, mergeTest) {
+  ft::map<int, int> yesterday;
+  ft::map<int, int> today;
+  for (int i = 0; i < 100; i++) {
+    yesterday[i] = 1;
+    today[i + 50] = 2;
+  }
+
+  ft::map<int, int> both;
+  both.assign_intersection(yesterday, today);
+  EXPECT_EQ(both.size(), 50u);
+  EXPECT_EQ(both.begin()->first, 50);
+  EXPECT_EQ(both.begin()->second, 1);
+
+  ft::map<int, int> gone;
+  gone.assign_difference(yesterday, today);
+  EXPECT_EQ(gone.size(), 50u);
+  EXPECT_EQ((--gone.end())->first, 49);
+
+  ft::map<int, int> all;
+  all.assign_union(yesterday, today, ft::keep_second());
+  EXPECT_EQ(all.size(), 150u);
+  EXPECT_EQ(all[75], 2);
+
+  yesterday.merge(today, ft::keep_second());
+  EXPECT_TRUE(today.empty());
+  EXPECT_TRUE(yesterday == all);
+
+  yesterday.subtract(gone);
+  EXPECT_EQ(yesterday.size(), 100u);
+  yesterday.intersect(both);
+  EXPECT_EQ(yesterday.size(), 50u);
+  EXPECT_EQ(yesterday[60], 2);
+}
+
+// throws on its g_resolve_left-th call
+static int g_resolve_left;
+
+struct throwing_resolve {
+  bool operator()(const ft::pair<const int, int> &, const ft::pair<const int, int> &) const {
+    if (--g_resolve_left == 0)
+      throw std::runtime_error("resolve");
+    return false;
+  }
+};
+
+// throws on its g_compare_left-th call
+static int g_compare_left;
+
+struct throwing_less {
+  bool operator()(int a, int b) const {
+    if (--g_compare_left == 0)
+      throw std::runtime_error("compare");
+    return a < b;
+  }
+};
+
+TEST(MAP_SET_ALGEBRA_TEST, mergeThrowTest) {
+  // every element ends up in exactly one of the two maps, both still valid
+  for (int fail = 1; fail <= 20; fail += 3) {  // 20 keys are in both maps
+    ft::map<int, int> mine;
+    ft::map<int, int> theirs;
+    std::multiset<std::pair<int, int> > all;
+    for (int i = 0; i < 60; i++) {
+      mine[i * 2] = i;
+      theirs[i * 3] = -i;
+      all.insert(std::make_pair(i * 2, i));
+      all.insert(std::make_pair(i * 3, -i));
+    }
+    g_resolve_left = fail;
+    EXPECT_THROW(mine.merge(theirs, throwing_resolve()), std::runtime_error);
+
+    std::multiset<std::pair<int, int> > after;
+    for (ft::map<int, int>::iterator it = mine.begin(); it != mine.end(); ++it)
+      after.insert(std::make_pair(it->first, it->second));
+    for (ft::map<int, int>::iterator it = theirs.begin(); it != theirs.end(); ++it)
+      after.insert(std::make_pair(it->first, it->second));
+    EXPECT_TRUE(after == all) << fail;
+    EXPECT_EQ(mine.size() + theirs.size(), all.size());
+    EXPECT_EQ(static_cast<size_t>(std::distance(mine.begin(), mine.end())), mine.size());
+    EXPECT_EQ(static_cast<size_t>(std::distance(theirs.rbegin(), theirs.rend())), theirs.size());
+    mine[1000] = 0;
+    theirs.erase(theirs.begin(), theirs.end());
+  }
+
+  // intersect : the elements not reached yet are kept
+  for (int fail = 1; fail <= 60; fail += 20) {
+    g_compare_left = 0;
+    ft::map<int, int, throwing_less> m;
+    ft::map<int, int, throwing_less> other;
+    for (int i = 0; i < 50; i++) {
+      m[i] = i;
+      other[i * 2] = i;
+    }
+    g_compare_left = fail;
+    EXPECT_THROW(m.intersect(other), std::runtime_error);
+    g_compare_left = 0;
+    EXPECT_GE(m.size(), 25u);
+    EXPECT_EQ(static_cast<size_t>(std::distance(m.begin(), m.end())), m.size());
+    EXPECT_EQ((--m.end())->first, 49);
+  }
+}
+
+TEST(MAP_NODE_HANDLE_TEST, extractTest) {
+  ft::map<int, std::string> hot;
+  ft::map<int, std::string> cold;
+  for (int i = 0; i < 10; i++)
+    hot[i] = std::string(i + 1, 'x');
+
+  const std::string *data = &hot[3];
+  ft::map<int, std::string>::insert_return_type ret = cold.insert(hot.extract(3));
+  EXPECT_TRUE(ret.inserted);
+  EXPECT_EQ(&ret.position->second, data); // same node
+  EXPECT_EQ(hot.size(), 9u);
+
+  cold[5] = "cold";
+  cold.splice(hot);
+  EXPECT_EQ(cold.size(), 10u);
+  ASSERT_EQ(hot.size(), 1u);
+  EXPECT_EQ(hot.begin()->first, 5);
+  EXPECT_EQ(cold[5], "cold");
+  EXPECT_FALSE(cold.splice(hot, hot.begin()));
+
+  ft::map<int, std::string>::node_type nh = cold.extract(9);
+  EXPECT_EQ(nh.value().second, std::string(10, 'x'));
+  EXPECT_TRUE(cold.extract(9).empty());
+}
+
+TEST(MAP_PARALLEL_COPY_TEST, copyTest) {
+  ft::map<int, int> m;
+  for (int i = 0; i < 100000; i++)
+    m[i * 7] = i;
+  ft::map<int, int> snapshot(m, ft::parallel_copy(4));
+  EXPECT_TRUE(snapshot == m);
+  snapshot.erase(7);
+  EXPECT_EQ(m[7], 1);
+}
+
+TEST(MAP_DEFERRED_DESTRUCTION_TEST, clearTest) {
+  ft::map<int, std::string> m;
+  m.set_deferred_destruction(true);
+  EXPECT_TRUE(m.deferred_destruction());
+  for (int i = 0; i < 20000; i++)
+    m[i] = "value";
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  m[1] = "again";
+  EXPECT_EQ(m.size(), 1u);
+  ft::flush_deferred_destruction();
+}
+
+TEST(MAP_TRANSPARENT_TEST, stringLookupTest) {
+  ft::map<std::string, int, ft::less<> > m;
+  m["apple"] = 1;
+  m["banana"] = 2;
+  m["cherry"] = 3;
+
+  const char *buffer = "banana split";
+  EXPECT_EQ(m.find("apple")->second, 1);
+  EXPECT_TRUE(m.find("durian") == m.end());
+  EXPECT_EQ(m.count("cherry"), 1u);
+  EXPECT_EQ(m.lower_bound("b")->first, "banana");
+  EXPECT_EQ(m.upper_bound(buffer)->first, "cherry");
+  EXPECT_TRUE(m.equal_range("blueberry").first == m.equal_range("blueberry").second);
+}
+
+int g_payloads = 0;
+
+struct payload {
+  std::vector<int> data;
+  payload() : data(64) { ++g_payloads; }
+  payload(int n) : data(n) { ++g_payloads; }
+  payload(const payload &x) : data(x.data) { ++g_payloads; }
+};
+
+template<class Map>
+void try_emplace_test() {
+  Map m;
+  const payload arg(20);
+  EXPECT_TRUE(m.try_emplace(1, payload(10)).second);
+  EXPECT_TRUE(m.try_emplace(2).second);
+  EXPECT_EQ(m[2].data.size(), 64u);
+
+  g_payloads = 0;
+  EXPECT_FALSE(m.try_emplace(1, arg).second); // a hit builds nothing
+  EXPECT_FALSE(m.try_emplace(2).second);
+  EXPECT_EQ(m[1].data.size(), 10u);
+  EXPECT_EQ(g_payloads, 0);
+
+  typename Map::iterator it = m.find(1);
+  EXPECT_FALSE(m.insert_or_assign(1, arg).second);
+  EXPECT_TRUE(m.find(1) == it); // updated in place
+  EXPECT_EQ(it->second.data.size(), 20u);
+  EXPECT_EQ(g_payloads, 0);
+  EXPECT_TRUE(m.insert_or_assign(3, arg).second);
+  EXPECT_EQ(m.size(), 3u);
+}
+
+TEST(MAP_TRY_EMPLACE_TEST, tryEmplaceTest) {
+  try_emplace_test<ft::map<int, payload> >();
+  try_emplace_test<ft::map<int, payload, std::less<int>, std::allocator<ft::pair<const int, payload> >,
+                           ft::btree_tag> >();
+  try_emplace_test<ft::map<int, payload, std::less<int>, std::allocator<ft::pair<const int, payload> >,
+                           ft::rb_tree_arena_tag> >();
+}
+
+// counts the elements it constructs
+static int g_constructs = 0;
+
+template<class T>
+struct logging_allocator : public std::allocator<T> {
+  template<class U>
+  struct rebind { typedef logging_allocator<U> other; };
+
+  logging_allocator() {}
+  logging_allocator(const logging_allocator &x) : std::allocator<T>(x) {}
+  template<class U>
+  logging_allocator(const logging_allocator<U> &x) : std::allocator<T>(x) {}
+
+  void construct(T *p, const T &val) {
+    ++g_constructs;
+    ::new(static_cast<void *>(p)) T(val);
+  }
+#if __cplusplus >= 201103L
+  template<class A, class B>
+  void construct(T *p, const A &a, const B &b) {
+    ++g_constructs;
+    ::new(static_cast<void *>(p)) T(a, b);
+  }
+#endif
+};
+
+TEST(MAP_TRY_EMPLACE_TEST, allocatorConstructTest) {
+  ft::map<int, payload, std::less<int>, logging_allocator<ft::pair<const int, payload> > > logged;
+  g_constructs = 0;
+  logged.try_emplace(1, payload(10));
+  logged.try_emplace(2);
+  EXPECT_EQ(g_constructs, 2);
+
+  // the mapped value of try_emplace(k) is built once, in the node
+  ft::map<int, payload> m;
+  g_payloads = 0;
+  m.try_emplace(1);
+  EXPECT_EQ(g_payloads, 1);
+  EXPECT_EQ(m[1].data.size(), 64u);
+}
+
+TEST(MAP_CURSOR_TEST, sequentialFindTest) {
+  ft::map<long, int> m;
+  for (int i = 0; i < 1000; i++)
+    m[1000000L + i * 10] = i;
+
+  ft::map<long, int>::cursor c = m.get_cursor();
+  long sum = 0;
+  for (long t = 1000000L; t < 1010000L; t += 10)
+    sum += c.find(t)->second;
+  EXPECT_EQ(sum, 999L * 1000 / 2);
+  EXPECT_EQ(c.position()->first, 1009990L);
+  EXPECT_EQ(c.lower_bound(1000005L)->first, 1000010L);
+
+  const ft::map<long, int> &cm = m;
+  ft::map<long, int>::const_cursor cc = cm.get_cursor();
+  EXPECT_TRUE(cc.find(5) == cm.end());
+  EXPECT_TRUE(cc.upper_bound(1009990L) == cm.end());
+}
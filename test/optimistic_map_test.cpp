@@ -0,0 +1,117 @@
+/*
+ * File: optimistic_map_test.cpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#include "gtest/gtest.h"
+#include "optimistic_map.hpp"
+
+#include <pthread.h>
+#include <cstdlib>
+#include <map>
+
+typedef ft::optimistic_map<int, long> omap;
+
+TEST(OptimisticMapTest, singleThreadTest) {
+  omap m;
+  std::map<int, long> expected;
+  EXPECT_TRUE(m.empty());
+
+  srand(24);
+  for (int i = 0; i < 5000; i++) {
+    int k = rand() % 700;
+    switch (rand() % 3) {
+      case 0:
+        EXPECT_EQ(m.insert(ft::make_pair(k, static_cast<long>(i))),
+                  expected.insert(std::make_pair(k, static_cast<long>(i))).second);
+        break;
+      case 1:
+        EXPECT_EQ(m.insert_or_assign(k, i), expected.count(k) == 0);
+        expected[k] = i;
+        break;
+      default:
+        EXPECT_EQ(m.erase(k), expected.erase(k));
+    }
+  }
+  ASSERT_EQ(m.size(), expected.size());
+  for (int k = -1; k <= 700; k++) {
+    long _value = -1;
+    std::map<int, long>::const_iterator it = expected.find(k);
+    ASSERT_EQ(m.find(k, _value), it != expected.end());
+    if (it != expected.end()) {
+      ASSERT_EQ(_value, it->second);
+    }
+    ASSERT_EQ(m.count(k), expected.count(k));
+
+    ft::pair<int, long> _bound;
+    std::map<int, long>::const_iterator lower = expected.lower_bound(k);
+    ASSERT_EQ(m.lower_bound(k, _bound), lower != expected.end());
+    if (lower != expected.end()) {
+      ASSERT_EQ(_bound.first, lower->first);
+      ASSERT_EQ(_bound.second, lower->second);
+    }
+    std::map<int, long>::const_iterator upper = expected.upper_bound(k);
+    ASSERT_EQ(m.upper_bound(k, _bound), upper != expected.end());
+    if (upper != expected.end()) {
+      ASSERT_EQ(_bound.first, upper->first);
+    }
+  }
+  m.clear();
+  EXPECT_TRUE(m.empty());
+}
+
+struct optimistic_reader_arg {
+  const omap *m;
+  bool *stop;
+  long reads;
+};
+
+// values are always key + round * 10000 : any torn or stale read that got through would break it
+void *read_while_writing(void *p) {
+  optimistic_reader_arg *_arg = static_cast<optimistic_reader_arg *>(p);
+  for (int i = 0; !__atomic_load_n(_arg->stop, __ATOMIC_RELAXED) || i < 20000; i++) {
+    int k = i % 1000;
+    long _value = 0;
+    if (_arg->m->find(k, _value) && _value % 10000 != k)
+      return p;
+    ft::pair<int, long> _bound;
+    if (_arg->m->lower_bound(k, _bound) && (_bound.first < k || _bound.second % 10000 != _bound.first))
+      return p;
+    ++_arg->reads;
+  }
+  return NULL;
+}
+
+TEST(OptimisticMapTest, singleWriterManyReadersTest) {
+  omap m;
+  for (int k = 0; k < 1000; k++)
+    m.insert(ft::make_pair(k, static_cast<long>(k)));
+
+  bool _stop = false;
+  optimistic_reader_arg args[4];
+  pthread_t threads[4];
+  for (int i = 0; i < 4; i++) {
+    args[i].m = &m;
+    args[i].stop = &_stop;
+    args[i].reads = 0;
+    ASSERT_EQ(pthread_create(&threads[i], NULL, read_while_writing, &args[i]), 0);
+  }
+  // rotations, erases and node reuse all happen under the readers
+  for (long round = 1; round < 50; round++) {
+    for (int k = 0; k < 1000; k += 3)
+      m.erase(k);
+    for (int k = 0; k < 1000; k++)
+      m.insert_or_assign(k, k + round * 10000);
+  }
+  __atomic_store_n(&_stop, true, __ATOMIC_RELAXED);
+  for (int i = 0; i < 4; i++) {
+    void *_result;
+    pthread_join(threads[i], &_result);
+    EXPECT_TRUE(_result == NULL);
+    EXPECT_GE(args[i].reads, 20000);
+  }
+  EXPECT_EQ(m.size(), 1000u);
+}
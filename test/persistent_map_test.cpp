@@ -0,0 +1,227 @@
+/*
+ * File: persistent_map_test.cpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#include "gtest/gtest.h"
+#include "persistent_map.hpp"
+#include "pair.hpp"
+
+#include <pthread.h>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef ft::persistent_map<int, int> pmap;
+
+template<class Map>
+void persistent_expect_same(const Map &m, const std::map<int, int> &expected) {
+  ASSERT_TRUE(m._m_verify());
+  ASSERT_EQ(m.size(), expected.size());
+  typename Map::const_iterator it = m.begin();
+  for (std::map<int, int>::const_iterator e = expected.begin(); e != expected.end(); ++e, ++it) {
+    ASSERT_EQ(it->first, e->first);
+    ASSERT_EQ(it->second, e->second);
+  }
+  EXPECT_TRUE(it == m.end());
+}
+
+TEST(PersistentMapTest, snapshotTest) {
+  pmap m;
+  std::map<int, int> expected;
+  std::vector<pmap> snapshots;
+  std::vector<std::map<int, int> > snapshot_contents;
+
+  srand(21);
+  for (int i = 0; i < 6000; i++) {
+    int k = rand() % 500;
+    switch (rand() % 3) {
+      case 0:
+        EXPECT_EQ(m.insert(ft::make_pair(k, i)), expected.insert(std::make_pair(k, i)).second);
+        break;
+      case 1:
+        EXPECT_EQ(m.set(k, i), expected.count(k) == 0);
+        expected[k] = i;
+        break;
+      default:
+        EXPECT_EQ(m.erase(k), expected.erase(k));
+    }
+    ASSERT_TRUE(m._m_verify()) << i;
+    if (i % 500 == 0) {
+      snapshots.push_back(m.snapshot());
+      snapshot_contents.push_back(expected);
+    }
+  }
+  persistent_expect_same(m, expected);
+  // old versions did not move
+  for (size_t i = 0; i < snapshots.size(); i++)
+    persistent_expect_same(snapshots[i], snapshot_contents[i]);
+
+  while (!m.empty())
+    m.erase(m.begin()->first);
+  EXPECT_TRUE(m._m_verify());
+  persistent_expect_same(snapshots.back(), snapshot_contents.back());
+}
+
+TEST(PersistentMapTest, lookupTest) {
+  pmap m;
+  for (int i = 0; i < 100; i++)
+    m.insert(ft::make_pair(i * 2, i));
+
+  EXPECT_EQ(m.find(40)->second, 20);
+  EXPECT_TRUE(m.find(41) == m.end());
+  EXPECT_EQ(m.lower_bound(41)->first, 42);
+  EXPECT_EQ(m.upper_bound(42)->first, 44);
+  EXPECT_TRUE(m.lower_bound(199) == m.end());
+  EXPECT_EQ(m.count(198), 1u);
+  EXPECT_EQ(*m.get(10), 5);
+  EXPECT_TRUE(m.get(11) == 0);
+  EXPECT_EQ(m.at(0), 0);
+  EXPECT_THROW(m.at(-1), std::out_of_range);
+
+  pmap::const_iterator last = m.end();
+  --last;
+  EXPECT_EQ(last->first, 198);
+  int expected = 198;
+  for (pmap::const_iterator it = last; it != m.begin(); --it, expected -= 2)
+    ASSERT_EQ(it->first, expected);
+
+  pmap copy(m);
+  EXPECT_TRUE(copy.shares_root(m));
+  EXPECT_TRUE(copy == m);
+  copy.set(0, -1);
+  EXPECT_FALSE(copy.shares_root(m));
+  EXPECT_TRUE(copy != m);
+  EXPECT_EQ(m.at(0), 0);
+}
+
+// counts the live nodes of every persistent_map using it
+size_t g_live_nodes = 0;
+
+template<class T>
+struct persistent_counting_allocator : public std::allocator<T> {
+  template<class U>
+  struct rebind { typedef persistent_counting_allocator<U> other; };
+
+  persistent_counting_allocator() {}
+  template<class U>
+  persistent_counting_allocator(const persistent_counting_allocator<U> &) {}
+
+  T *allocate(size_t n) {
+    g_live_nodes += n;
+    return std::allocator<T>::allocate(n);
+  }
+  void deallocate(T *p, size_t n) {
+    g_live_nodes -= n;
+    std::allocator<T>::deallocate(p, n);
+  }
+};
+
+TEST(PersistentMapTest, structuralSharingTest) {
+  typedef ft::persistent_map<int, std::string, std::less<int>,
+                             persistent_counting_allocator<ft::pair<const int, std::string> > > counted_map;
+  g_live_nodes = 0;
+  {
+    counted_map m;
+    for (int i = 0; i < 10000; i++)
+      m.set(i, "value");
+    EXPECT_EQ(g_live_nodes, 10000u);
+
+    // snapshots are free, changes cost one path each
+    std::vector<counted_map> versions(100, m);
+    EXPECT_EQ(g_live_nodes, 10000u);
+    for (int i = 0; i < 100; i++) {
+      versions[i].set(i * 97, "changed");
+      versions[i].erase(i * 89 + 1);
+    }
+    EXPECT_LT(g_live_nodes, 10000u + 100 * 2 * 2 * 30);
+    EXPECT_EQ(versions[3].at(291), "changed");
+    EXPECT_EQ(m.at(291), "value");
+
+    // the paths only a dropped version had are freed with it
+    versions.clear();
+    EXPECT_EQ(g_live_nodes, 10000u);
+  }
+  EXPECT_EQ(g_live_nodes, 0u);
+}
+
+struct persistent_reader_arg {
+  const pmap *published;
+  long sum;
+};
+
+void *read_snapshots(void *p) {
+  persistent_reader_arg *_arg = static_cast<persistent_reader_arg *>(p);
+  for (int i = 0; i < 2000; i++) {
+    pmap _mine(*_arg->published); // many threads copy the same snapshot at once
+    _arg->sum += *_mine.get(i % 1000);
+  }
+  return NULL;
+}
+
+TEST(PersistentMapTest, concurrentReadersTest) {
+  pmap writer;
+  for (int i = 0; i < 1000; i++)
+    writer.set(i, 1);
+  const pmap published = writer.snapshot();
+
+  persistent_reader_arg args[4];
+  pthread_t threads[4];
+  for (int i = 0; i < 4; i++) {
+    args[i].published = &published;
+    args[i].sum = 0;
+    ASSERT_EQ(pthread_create(&threads[i], NULL, read_snapshots, &args[i]), 0);
+  }
+  // the writer keeps changing its own version meanwhile
+  for (int i = 0; i < 1000; i++)
+    writer.set(i, 2);
+  for (int i = 0; i < 4; i++) {
+    pthread_join(threads[i], NULL);
+    EXPECT_EQ(args[i].sum, 2000);
+  }
+  EXPECT_EQ(*writer.get(0), 2);
+  EXPECT_EQ(*published.get(0), 1);
+  EXPECT_TRUE(published._m_verify());
+}
+
+int g_copies_allowed = -1;
+
+struct fragile {
+  int value;
+  fragile(int v) : value(v) {}
+  fragile(const fragile &x) : value(x.value) {
+    if (g_copies_allowed == 0)
+      throw std::runtime_error("copy");
+    if (g_copies_allowed > 0)
+      --g_copies_allowed;
+  }
+};
+
+TEST(PersistentMapTest, strongGuaranteeTest) {
+  typedef ft::persistent_map<int, fragile> fragile_map;
+  fragile_map m;
+  for (int i = 0; i < 200; i++)
+    m.set(i, fragile(i));
+  const fragile_map before = m.snapshot();
+
+  // an update failing half way leaves the version as it was (and leaks nothing, see the leak sanitizer)
+  for (int allowed = 0; allowed < 20; allowed++) {
+    g_copies_allowed = allowed;
+    try {
+      m.erase(allowed * 7);
+      m.set(1000 + allowed, fragile(0));
+    } catch (const std::runtime_error &) {
+    }
+    g_copies_allowed = -1;
+    ASSERT_TRUE(m._m_verify());
+  }
+  EXPECT_TRUE(before._m_verify());
+  EXPECT_EQ(before.size(), 200u);
+  EXPECT_EQ(before.at(7).value, 7);
+}
@@ -0,0 +1,118 @@
+/*
+ * File: set_test.cpp
+ * Project: ft_container
+ * Created Date: 2026/10/18
+ * Author: nkim
+ * Copyright (c) 2022 nkim
+ */
+
+#include "gtest/gtest.h"
+#include "set.hpp"
+#include "map.hpp"
+
+#include <set>
+#include <algorithm>
+#include <cstdlib>
+
+TEST(SET_TEST, compareStdSetTest) {
+  ft::set<int> ft_set;
+  std::set<int> std_set;
+
+  srand(42);
+  for (int i = 0; i < 2000; ++i) {
+    int k = rand() % 500;
+    if (rand() % 3 == 0) {
+      EXPECT_EQ(ft_set.erase(k), std_set.erase(k));
+    } else {
+      ft::pair<ft::set<int>::iterator, bool> r = ft_set.insert(k);
+      EXPECT_EQ(r.second, std_set.insert(k).second);
+      EXPECT_EQ(*r.first, k);
+    }
+  }
+  ASSERT_EQ(ft_set.size(), std_set.size());
+  EXPECT_TRUE(std::equal(ft_set.begin(), ft_set.end(), std_set.begin()));
+  EXPECT_TRUE(std::equal(ft_set.rbegin(), ft_set.rend(), std_set.rbegin()));
+  for (int k = -1; k <= 500; ++k) {
+    EXPECT_EQ(ft_set.count(k), std_set.count(k));
+    ASSERT_EQ(ft_set.lower_bound(k) == ft_set.end(), std_set.lower_bound(k) == std_set.end());
+    if (ft_set.lower_bound(k) != ft_set.end()) {
+      EXPECT_EQ(*ft_set.lower_bound(k), *std_set.lower_bound(k));
+    }
+  }
+}
+
+TEST(SET_TEST, rangeAndCompareTest) {
+  int keys[] = {5, 3, 8, 3, 1, 5};
+  ft::set<int> a(keys, keys + 6);
+  ft::set<int> b(a);
+
+  EXPECT_EQ(a.size(), 4u);
+  EXPECT_TRUE(a == b);
+  b.erase(b.find(8));
+  EXPECT_TRUE(b < a);
+  EXPECT_TRUE(a != b);
+
+  ft::set<int>::iterator hint = a.insert(a.end(), 9);
+  EXPECT_EQ(*hint, 9);
+  EXPECT_EQ(*a.rbegin(), 9);
+
+  a.subtract(b);
+  EXPECT_EQ(a.size(), 2u);
+  EXPECT_EQ(*a.begin(), 8);
+
+  ft::swap(a, b);
+  EXPECT_EQ(a.size(), 3u);
+  EXPECT_EQ(b.size(), 2u);
+}
+
+TEST(MULTISET_TEST, compareStdMultisetTest) {
+  ft::multiset<int> ft_set;
+  std::multiset<int> std_set;
+
+  srand(7);
+  for (int i = 0; i < 2000; ++i) {
+    int k = rand() % 100;
+    if (rand() % 4 == 0) {
+      EXPECT_EQ(ft_set.erase(k), std_set.erase(k));
+    } else if (rand() % 2 == 0) {
+      EXPECT_EQ(*ft_set.insert(k), k);
+      std_set.insert(k);
+    } else {
+      EXPECT_EQ(*ft_set.insert(ft_set.lower_bound(k), k), k);
+      std_set.insert(std_set.lower_bound(k), k);
+    }
+  }
+  ASSERT_EQ(ft_set.size(), std_set.size());
+  EXPECT_TRUE(std::equal(ft_set.begin(), ft_set.end(), std_set.begin()));
+  for (int k = 0; k < 100; ++k) {
+    EXPECT_EQ(ft_set.count(k), std_set.count(k));
+  }
+}
+
+TEST(MULTISET_TEST, hintOrderTest) {
+  // equivalent keys keep insertion order, a hint puts the key just before it
+  ft::multiset<int> s;
+  int keys[] = {2, 2, 1, 3, 2};
+  s.insert(keys, keys + 5);
+  EXPECT_EQ(s.count(2), 3u);
+
+  ft::multiset<int>::iterator first2 = s.lower_bound(2);
+  ft::multiset<int>::iterator it = s.insert(first2, 2);
+  EXPECT_TRUE(it == s.lower_bound(2));
+  EXPECT_EQ(s.count(2), 4u);
+
+  s.insert(s.end(), 0);
+  EXPECT_EQ(*s.begin(), 0);
+  s.insert(s.begin(), 7);
+  EXPECT_EQ(*s.rbegin(), 7);
+
+  ft::pair<ft::multiset<int>::iterator, ft::multiset<int>::iterator> r = s.equal_range(2);
+  s.erase(r.first, r.second);
+  EXPECT_EQ(s.count(2), 0u);
+  EXPECT_EQ(s.size(), 4u);
+}
+
+TEST(SET_TEST, nodeSizeTest) {
+  // the node holds the key alone, not a pair<const key, dummy>
+  EXPECT_LT(sizeof(ft::_rb_tree_node<long>), sizeof(ft::_rb_tree_node<ft::pair<const long, char> >));
+}
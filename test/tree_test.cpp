@@ -12,6 +12,11 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <stdexcept>
+#include <cstdlib>
 
 #define SHOW(...) \
     std::cout << std::setw(29) << #__VA_ARGS__ << " == " << __VA_ARGS__ << '\n'
@@ -68,4 +73,684 @@ TEST_F(RbTreeTest, capacityFunctionTest) {
   // tree.size
   // tree.max_size
   // tree.empty
-}
\ No newline at end of file
+}
+TEST(RbTreeLayoutTest, nodeSizeTest) {
+#ifdef FT_RB_TREE_THREADED
+  const size_t threads = 2 * sizeof(void *);
+#else
+  const size_t threads = 0;
+#endif
+#ifdef FT_RB_TREE_COMPACT
+  // color is packed into the parent pointer
+  EXPECT_EQ(sizeof(ft::_rb_tree_node_base), 3 * sizeof(void *) + threads);
+#else
+  EXPECT_EQ(sizeof(ft::_rb_tree_node_base), 4 * sizeof(void *) + threads);
+#endif
+  ft::_rb_tree_node_base node;
+  node._m_set_color(ft::_s_black);
+  node._m_set_parent(&node);
+  EXPECT_EQ(node._m_get_parent(), &node);
+  EXPECT_EQ(node._m_get_color(), ft::_s_black);
+  node._m_set_color(ft::_s_red);
+  EXPECT_EQ(node._m_get_parent(), &node);
+  EXPECT_EQ(node._m_get_color(), ft::_s_red);
+}
+
+// a node with a single child must have the same black height on its empty side as every leaf
+TEST(RbTreeLayoutTest, verifyOneChildTest) {
+  typedef ft::pair<int, int> value_type;
+  typedef ft::_rb_tree<int, value_type> tree_type;
+  tree_type tree;
+  int keys[] = {4, 2, 6, 1, 3, 5, 7};
+  for (int i = 0; i < 7; i++)
+    tree.insert_unique(value_type(keys[i], 0));
+  tree.erase(5);
+  ASSERT_TRUE(tree._m_verify());
+
+  // 6 keeps only its right child : leaves 1, 3, 7 all have 3 blacks but the empty left of 6 has 2
+  int reds[] = {1, 3, 7};
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(tree.find(reds[i])._m_node->_m_get_color(), ft::_s_red);
+    tree.find(reds[i])._m_node->_m_set_color(ft::_s_black);
+  }
+  EXPECT_FALSE(tree._m_verify());
+  for (int i = 0; i < 3; i++)
+    tree.find(reds[i])._m_node->_m_set_color(ft::_s_red);
+  EXPECT_TRUE(tree._m_verify());
+}
+
+// ++ / -- after every kind of structural change (threaded links with FT_RB_TREE_THREADED)
+TEST(RbTreeLayoutTest, iterationTest) {
+  typedef ft::pair<int, int> value_type;
+  typedef ft::_rb_tree<int, value_type> tree_type;
+  tree_type tree;
+  std::set<int> ref;
+
+  srand(5);
+  for (int i = 0; i < 5000; i++) {
+    int k = rand() % 500;
+    if (rand() % 3) {
+      tree.insert_unique(value_type(k, i));
+      ref.insert(k);
+    } else {
+      tree.erase(k);
+      ref.erase(k);
+    }
+  }
+  ASSERT_TRUE(tree._m_verify());
+
+  tree_type copy(tree);
+  tree_type other;
+  other.insert_unique(value_type(1000, 0));
+  copy.swap(other);
+  EXPECT_TRUE(copy._m_verify());
+  EXPECT_TRUE(other._m_verify());
+  EXPECT_EQ((--copy.end())->first, 1000);
+
+  std::set<int>::iterator r = ref.begin();
+  for (tree_type::iterator it = other.begin(); it != other.end(); ++it, ++r)
+    EXPECT_EQ(it->first, *r);
+  std::set<int>::reverse_iterator rr = ref.rbegin();
+  for (tree_type::reverse_iterator it = other.rbegin(); it != other.rend(); ++it, ++rr)
+    EXPECT_EQ(it->first, *rr);
+
+  std::vector<value_type> sorted;
+  for (int i = 0; i < 100; i++)
+    sorted.push_back(value_type(i, i));
+  other.clear();
+  EXPECT_TRUE(other.begin() == other.end());
+  other.insert_unique(sorted.begin(), sorted.end());
+  other.insert_unique(value_type(-1, 0));
+  other.erase(50);
+  EXPECT_TRUE(other._m_verify());
+  EXPECT_EQ(other.begin()->first, -1);
+  EXPECT_EQ((++other.find(49))->first, 51);
+  EXPECT_EQ((--other.find(51))->first, 49);
+}
+
+TEST(RbTreePoolTest, poolAllocatorTest) {
+  typedef ft::pair<int, int> value_type;
+  typedef ft::_rb_tree<int, value_type, ft::Select1st<value_type>, ft::less<int>,
+                       ft::pool_allocator<value_type> > tree_type;
+  tree_type tree;
+
+  for (int i = 0; i < 1000; i++)
+    tree.insert_unique(value_type(i, i));
+  for (int i = 0; i < 1000; i += 2)
+    tree.erase(i);
+  // erased blocks are reused through the free-list
+  for (int i = 0; i < 1000; i += 2)
+    tree.insert_unique(value_type(i, -i));
+  EXPECT_EQ(tree.size(), 1000u);
+
+  // copy shares the pool, so clear() must not recycle the other tree's nodes
+  tree_type copy(tree);
+  copy.clear();
+  EXPECT_TRUE(copy.empty());
+  int expected = 0;
+  for (tree_type::iterator it = tree.begin(); it != tree.end(); ++it, ++expected) {
+    EXPECT_EQ(it->first, expected);
+    EXPECT_EQ(it->second, expected % 2 ? expected : -expected);
+  }
+
+  // bulk release and refill from the recycled slabs
+  tree.clear();
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.begin(), tree.end());
+  for (int i = 0; i < 1000; i++)
+    tree.insert_unique(value_type(i, i));
+  EXPECT_EQ(tree.size(), 1000u);
+
+  tree_type other;
+  other.insert_unique(value_type(-1, -1));
+  tree.swap(other);
+  EXPECT_EQ(tree.size(), 1u);
+  EXPECT_EQ(other.size(), 1000u);
+  other.clear();
+}
+
+TEST(RbTreePoolTest, poolAllocatorEqualityTest) {
+  typedef ft::pool_allocator<int> alloc_type;
+  // equal allocators must be able to free each other's blocks, even before either allocated
+  alloc_type a, b;
+  EXPECT_TRUE(a == a);
+  EXPECT_FALSE(a == b);
+  alloc_type c(a);
+  EXPECT_TRUE(c == a);
+  int *p = c.allocate(1);
+  EXPECT_EQ(a.in_use(), 1u);
+  a.deallocate(p, 1);
+  EXPECT_EQ(c.in_use(), 0u);
+  b = a;
+  EXPECT_TRUE(b == c);
+}
+
+TEST(RbTreeBulkTest, sortedRangeTest) {
+  typedef ft::pair<int, int> value_type;
+  typedef ft::_rb_tree<int, value_type> tree_type;
+
+  for (int n = 0; n < 300; n++) {
+    std::vector<value_type> values;
+    for (int i = 0; i < n; i++)
+      values.push_back(value_type(i * 2, i));
+
+    tree_type tree;
+    tree.insert_unique(values.begin(), values.end());
+    EXPECT_TRUE(tree._m_verify());
+    EXPECT_EQ(tree.size(), static_cast<size_t>(n));
+
+    tree_type told;
+    told.insert_sorted_unique(values.begin(), values.end());
+    EXPECT_TRUE(told._m_verify());
+    EXPECT_TRUE(told == tree);
+
+    // the built tree must keep working as a normal red-black tree
+    for (int i = 0; i < n; i += 3)
+      tree.erase(i * 2);
+    for (int i = 0; i < n; i += 2)
+      tree.insert_unique(value_type(i * 2 + 1, i));
+    EXPECT_TRUE(tree._m_verify());
+  }
+}
+
+TEST(RbTreeBulkTest, unsortedRangeTest) {
+  typedef ft::pair<int, int> value_type;
+  typedef ft::_rb_tree<int, value_type> tree_type;
+
+  std::vector<value_type> values;
+  for (int i = 0; i < 100; i++)
+    values.push_back(value_type((i * 37) % 100, i));
+  values.push_back(value_type(5, 0));
+
+  tree_type tree;
+  tree.insert_unique(values.begin(), values.end());
+  EXPECT_TRUE(tree._m_verify());
+  EXPECT_EQ(tree.size(), 100u);
+
+  // non empty tree with sorted input
+  tree_type::value_type more[] = {value_type(100, 0), value_type(101, 0), value_type(150, 0)};
+  tree.insert_unique(more, more + 3);
+  EXPECT_TRUE(tree._m_verify());
+  EXPECT_EQ(tree.size(), 103u);
+}
+
+#ifndef FT_RB_TREE_COMPACT  // no subtree size in the compact node layout
+TEST(RbTreeOrderStatisticTest, rankSelectTest) {
+  typedef ft::pair<int, int> value_type;
+  typedef ft::_rb_tree<int, value_type, ft::Select1st<value_type>, ft::less<int>,
+                       std::allocator<value_type>, true> tree_type;
+  tree_type tree;
+  std::set<int> keys;
+  EXPECT_LE(tree.max_size(), static_cast<size_t>(static_cast<unsigned int>(-1)));
+
+  srand(42);
+  for (int i = 0; i < 3000; i++) {
+    int k = rand() % 1000;
+    if (rand() % 3) {
+      tree.insert_unique(value_type(k, i));
+      keys.insert(k);
+    } else {
+      tree.erase(k);
+      keys.erase(k);
+    }
+  }
+  ASSERT_TRUE(tree._m_verify());
+  ASSERT_EQ(tree.size(), keys.size());
+
+  size_t index = 0;
+  for (std::set<int>::iterator it = keys.begin(); it != keys.end(); ++it, ++index) {
+    EXPECT_EQ(tree.select(index)->first, *it);
+    EXPECT_EQ(tree.rank(*it), index);
+  }
+  EXPECT_TRUE(tree.select(keys.size()) == tree.end());
+  EXPECT_EQ(tree.count_range(100, 500),
+            static_cast<size_t>(std::distance(keys.lower_bound(100), keys.lower_bound(500))));
+  EXPECT_EQ(tree.count_range(500, 100), 0u);
+
+  // iterator jumps
+  tree_type::iterator first = tree.begin();
+  EXPECT_TRUE(first + tree.size() == tree.end());
+  EXPECT_TRUE(tree.end() - tree.size() == first);
+  EXPECT_EQ(tree.end() - first, static_cast<ptrdiff_t>(tree.size()));
+  tree_type::const_iterator mid = tree.select(keys.size() / 2);
+  mid -= 10;
+  EXPECT_EQ(mid->first, tree.select(keys.size() / 2 - 10)->first);
+  mid += 20;
+  EXPECT_EQ(mid->first, tree.select(keys.size() / 2 + 10)->first);
+
+  // copy and bulk build keep the sizes
+  tree_type copy(tree);
+  EXPECT_TRUE(copy._m_verify());
+  tree_type built;
+  built.insert_unique(tree.begin(), tree.end());
+  EXPECT_TRUE(built._m_verify());
+  EXPECT_EQ(built.rank(*keys.rbegin()), keys.size() - 1);
+}
+#endif
+
+template<class Tree>
+void split_join_test() {
+  typedef typename Tree::value_type value_type;
+  srand(7);
+  for (int round = 0; round < 50; round++) {
+    Tree tree;
+    std::set<int> keys;
+    int n = rand() % 300;
+    for (int i = 0; i < n; i++) {
+      int k = rand() % 1000;
+      tree.insert_unique(value_type(k, k));
+      keys.insert(k);
+    }
+    int cut = rand() % 1100 - 50;
+    Tree right;
+    right.insert_unique(value_type(-1, -1)); // dropped by split
+    tree.split(cut, right);
+    ASSERT_TRUE(tree._m_verify());
+    ASSERT_TRUE(right._m_verify());
+    EXPECT_EQ(tree.size(), static_cast<size_t>(std::distance(keys.begin(), keys.lower_bound(cut))));
+    EXPECT_EQ(right.size(), static_cast<size_t>(std::distance(keys.lower_bound(cut), keys.end())));
+    if (!right.empty()) {
+      EXPECT_GE(right.begin()->first, cut);
+    }
+    if (!tree.empty()) {
+      EXPECT_LT((--tree.end())->first, cut);
+    }
+
+    tree.join(right);
+    ASSERT_TRUE(tree._m_verify());
+    ASSERT_TRUE(right._m_verify());
+    EXPECT_TRUE(right.empty());
+    ASSERT_EQ(tree.size(), keys.size());
+    std::set<int>::iterator k = keys.begin();
+    for (typename Tree::iterator it = tree.begin(); it != tree.end(); ++it, ++k)
+      EXPECT_EQ(it->first, *k);
+  }
+
+  // overlapping key ranges fall back to splice : the colliding elements stay in b
+  Tree a;
+  Tree b;
+  for (int i = 0; i < 100; i++) {
+    a.insert_unique(value_type(i * 2, 0));
+    b.insert_unique(value_type(i * 3, 0));
+  }
+  a.join(b);
+  EXPECT_TRUE(a._m_verify());
+  EXPECT_EQ(a.size(), 166u);
+  EXPECT_TRUE(b._m_verify());
+  EXPECT_EQ(b.size(), 34u);
+  for (typename Tree::iterator it = b.begin(); it != b.end(); ++it)
+    EXPECT_EQ(it->first % 6, 0);
+}
+
+TEST(RbTreeSplitJoinTest, splitJoinTest) {
+  typedef ft::pair<int, int> value_type;
+  split_join_test<ft::_rb_tree<int, value_type> >();
+  split_join_test<ft::_rb_tree<int, value_type, ft::Select1st<value_type>, ft::less<int>,
+                               ft::pool_allocator<value_type> > >();
+#ifndef FT_RB_TREE_COMPACT
+  split_join_test<ft::_rb_tree<int, value_type, ft::Select1st<value_type>, ft::less<int>,
+                               std::allocator<value_type>, true> >();
+#endif
+}
+
+template<class Tree>
+void expect_same(const Tree &tree, const std::map<int, int> &model) {
+  ASSERT_TRUE(tree._m_verify());
+  ASSERT_EQ(tree.size(), model.size());
+  std::map<int, int>::const_iterator m = model.begin();
+  for (typename Tree::const_iterator it = tree.begin(); it != tree.end(); ++it, ++m) {
+    EXPECT_EQ(it->first, m->first);
+    EXPECT_EQ(it->second, m->second);
+  }
+}
+
+template<class Tree>
+void set_algebra_test(const Tree &proto) {
+  typedef typename Tree::value_type value_type;
+  srand(11);
+  for (int round = 0; round < 30; round++) {
+    // same allocator as proto : merge takes the nodes
+    Tree a(proto);
+    Tree b(proto);
+    a.clear();
+    b.clear();
+    std::map<int, int> ma;
+    std::map<int, int> mb;
+    int na = rand() % 200;
+    int nb = rand() % 200;
+    for (int i = 0; i < na; i++) {
+      int k = rand() % 300;
+      a.insert_unique(value_type(k, 1));
+      ma.insert(std::make_pair(k, 1));
+    }
+    for (int i = 0; i < nb; i++) {
+      int k = rand() % 300;
+      b.insert_unique(value_type(k, 2));
+      mb.insert(std::make_pair(k, 2));
+    }
+    std::map<int, int> m_union(mb);
+    std::map<int, int> m_inter;
+    std::map<int, int> m_diff;
+    for (std::map<int, int>::iterator it = ma.begin(); it != ma.end(); ++it) {
+      m_union[it->first] = it->second;
+      if (mb.count(it->first))
+        m_inter.insert(*it);
+      else
+        m_diff.insert(*it);
+    }
+
+    Tree c;
+    c.assign_union(a, b, ft::keep_first());
+    expect_same(c, m_union);
+    c.assign_intersection(a, b);
+    expect_same(c, m_inter);
+    c.assign_difference(a, b);
+    expect_same(c, m_diff);
+    c.assign_difference(c, a); // aliasing the result
+    EXPECT_TRUE(c.empty());
+    expect_same(a, ma);
+    expect_same(b, mb);
+
+    Tree i(a);
+    i.intersect(b);
+    expect_same(i, m_inter);
+    Tree d(a);
+    d.subtract(b);
+    expect_same(d, m_diff);
+
+    Tree u(b);
+    u.merge(a, ft::keep_second());
+    expect_same(u, m_union);
+    EXPECT_TRUE(a._m_verify());
+    EXPECT_TRUE(a.empty());
+
+    Tree other; // other allocator (pool) : values are copied
+    other.insert_unique(value_type(-1, 3));
+    other.merge(u, ft::keep_first());
+    m_union[-1] = 3;
+    expect_same(other, m_union);
+    EXPECT_TRUE(u.empty());
+  }
+}
+
+TEST(RbTreeSetAlgebraTest, setAlgebraTest) {
+  typedef ft::pair<int, int> value_type;
+  set_algebra_test(ft::_rb_tree<int, value_type>());
+  set_algebra_test(ft::_rb_tree<int, value_type, ft::Select1st<value_type>, ft::less<int>,
+                                ft::pool_allocator<value_type> >());
+#ifndef FT_RB_TREE_COMPACT
+  set_algebra_test(ft::_rb_tree<int, value_type, ft::Select1st<value_type>, ft::less<int>,
+                                std::allocator<value_type>, true>());
+#endif
+}
+
+TEST(RbTreeNodeHandleTest, extractInsertTest) {
+  typedef ft::pair<int, int> value_type;
+  typedef ft::_rb_tree<int, value_type, ft::Select1st<value_type>, ft::less<int>,
+                       ft::pool_allocator<value_type> > base_type;
+  struct tree_type : public base_type {
+    size_t blocks() const { return this->_m_get_node_allocator().in_use(); }
+  };
+  tree_type hot;
+  for (int i = 0; i < 200; i++)
+    hot.insert_unique(value_type(i, i));
+  tree_type cold(hot);
+  cold.clear();
+  size_t blocks = hot.blocks();
+
+  // move the even keys one node at a time
+  for (int i = 0; i < 200; i += 2) {
+    tree_type::node_type nh = hot.extract(i);
+    ASSERT_FALSE(nh.empty());
+    EXPECT_EQ(nh.value().second, i);
+    tree_type::insert_return_type ret = cold.insert_unique(nh);
+    EXPECT_TRUE(ret.inserted);
+    EXPECT_TRUE(nh.empty());
+    EXPECT_EQ(ret.position->first, i);
+  }
+  EXPECT_TRUE(hot._m_verify());
+  EXPECT_TRUE(cold._m_verify());
+  EXPECT_EQ(hot.size(), 100u);
+  EXPECT_EQ(cold.size(), 100u);
+  EXPECT_EQ(hot.blocks(), blocks); // nothing allocated or freed
+  EXPECT_TRUE(hot.extract(0).empty());
+
+  // key already there : the node comes back, changed key goes in
+  tree_type::node_type nh = hot.extract(hot.begin());
+  nh.key() = 2;
+  tree_type::insert_return_type ret = cold.insert_unique(nh);
+  EXPECT_FALSE(ret.inserted);
+  EXPECT_EQ(ret.position->first, 2);
+  ASSERT_FALSE(ret.node.empty());
+  ret.node.key() = 1000;
+  EXPECT_TRUE(cold.insert_unique(ret.node).inserted);
+  EXPECT_TRUE(cold._m_verify());
+
+  // a dropped handle frees its node
+  hot.extract(--hot.end());
+  EXPECT_EQ(hot.blocks(), blocks - 1);
+
+  // splice keeps the elements whose key is already in the target
+  hot.insert_unique(value_type(4, -1));
+  size_t hot_size = hot.size();
+  cold.splice(hot);
+  EXPECT_TRUE(hot._m_verify());
+  EXPECT_TRUE(cold._m_verify());
+  ASSERT_EQ(hot.size(), 1u);
+  EXPECT_EQ(hot.begin()->second, -1);
+  EXPECT_EQ(cold.size(), 101 + hot_size - 1);
+
+  // other allocator : the value is copied
+  tree_type other;
+  EXPECT_TRUE(other.splice(hot, hot.begin()));
+  EXPECT_TRUE(hot.empty());
+  EXPECT_EQ(other.begin()->second, -1);
+  EXPECT_TRUE(other.insert_unique(cold.extract(1000)).inserted);
+  EXPECT_TRUE(other._m_verify());
+}
+
+TEST(RbTreeParallelCopyTest, sameShapeTest) {
+  typedef ft::pair<int, int> value_type;
+  typedef ft::_rb_tree<int, value_type> tree_type;
+  tree_type tree;
+  srand(3);
+  for (int i = 0; i < 200000; i++) {
+    int k = rand();
+    tree.insert_unique(value_type(k, i));
+  }
+  unsigned threads[] = {0, 1, 3, 16};
+  for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+    tree_type copy(tree, ft::parallel_copy(threads[t]));
+    ASSERT_TRUE(copy._m_verify());
+    ASSERT_EQ(copy.size(), tree.size());
+    // same keys in order, colors and parent keys : same shape
+    tree_type::iterator c = copy.begin();
+    for (tree_type::iterator it = tree.begin(); it != tree.end(); ++it, ++c) {
+      ASSERT_EQ(c->first, it->first);
+      ASSERT_EQ(c->second, it->second);
+      ASSERT_EQ(c._m_node->_m_get_color(), it._m_node->_m_get_color());
+      if (it._m_node->_m_get_parent() == tree.end()._m_node) {
+        ASSERT_TRUE(c._m_node->_m_get_parent() == copy.end()._m_node);
+      } else {
+        ASSERT_EQ(tree_type::iterator(c._m_node->_m_get_parent())->first,
+                  tree_type::iterator(it._m_node->_m_get_parent())->first);
+      }
+    }
+  }
+  tree_type small;
+  small.insert_unique(value_type(1, 1));
+  tree_type small_copy(small, ft::parallel_copy(4));
+  EXPECT_TRUE(small_copy == small);
+}
+
+// bumped by the reclaimer thread too : atomic, and read only once flush_deferred_destruction has returned
+static int g_destroyed = 0;
+
+struct counted {
+  int value;
+  counted(int v) : value(v) {}
+  counted(const counted &x) : value(x.value) {}
+  ~counted() { __atomic_fetch_add(&g_destroyed, 1, __ATOMIC_RELAXED); }
+};
+
+TEST(RbTreeDeferredDestructionTest, clearTest) {
+  typedef ft::pair<int, counted> value_type;
+  typedef ft::_rb_tree<int, value_type> tree_type;
+  const int n = 10000;
+  {
+    tree_type tree;
+    tree.set_deferred_destruction(true);
+    for (int i = 0; i < n; i++)
+      tree.insert_unique(value_type(i, counted(i)));
+    ft::flush_deferred_destruction();
+    __atomic_store_n(&g_destroyed, 0, __ATOMIC_RELAXED);
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree._m_verify());
+    tree.insert_unique(value_type(1, counted(1))); // still usable right away
+    ft::flush_deferred_destruction();
+    EXPECT_EQ(__atomic_load_n(&g_destroyed, __ATOMIC_RELAXED), n + 2); // + the two temporaries of the insert above
+
+    // over the limit : freed on this thread
+    for (int i = 0; i < n; i++)
+      tree.insert_unique(value_type(i, counted(i)));
+    size_t limit = ft::set_deferred_destruction_limit(n / 2);
+    __atomic_store_n(&g_destroyed, 0, __ATOMIC_RELAXED);
+    tree.clear();
+    // no flush : the reclaimer has been idle since the last one, so all n come from this thread
+    EXPECT_EQ(__atomic_load_n(&g_destroyed, __ATOMIC_RELAXED), n);
+    ft::set_deferred_destruction_limit(limit);
+
+    for (int i = 0; i < n; i++)
+      tree.insert_unique(value_type(i, counted(i)));
+    __atomic_store_n(&g_destroyed, 0, __ATOMIC_RELAXED);
+  }
+  ft::flush_deferred_destruction();
+  EXPECT_EQ(__atomic_load_n(&g_destroyed, __ATOMIC_RELAXED), n); // destructor
+}
+
+static int g_copies_left = -1;
+
+struct throws_on_copy {
+  int value;
+  throws_on_copy(int v) : value(v) {}
+  throws_on_copy(const throws_on_copy &x) : value(x.value) {
+    if (g_copies_left == 0)
+      throw std::runtime_error("copy");
+    if (g_copies_left > 0)
+      --g_copies_left;
+  }
+};
+
+TEST(RbTreeCopyTest, iterativeCopyTest) {
+  typedef ft::pair<int, throws_on_copy> value_type;
+  typedef ft::_rb_tree<int, value_type> tree_type;
+  tree_type tree;
+  srand(5);
+  for (int i = 0; i < 3000; i++) {
+    int k = rand() % 5000;
+    tree.insert_unique(value_type(k, throws_on_copy(k)));
+  }
+  tree_type copy(tree);
+  ASSERT_TRUE(copy._m_verify());
+  // same shape : same colors and parent keys
+  tree_type::iterator c = copy.begin();
+  for (tree_type::iterator it = tree.begin(); it != tree.end(); ++it, ++c) {
+    ASSERT_EQ(c->first, it->first);
+    ASSERT_EQ(c._m_node->_m_get_color(), it._m_node->_m_get_color());
+    if (it._m_node->_m_get_parent() != tree.end()._m_node) {
+      ASSERT_EQ(tree_type::iterator(c._m_node->_m_get_parent())->first,
+                tree_type::iterator(it._m_node->_m_get_parent())->first);
+    }
+  }
+
+  // a copy failing half way frees what it built (checked by the leak sanitizer)
+  for (int k = 0; k < static_cast<int>(tree.size()); k += 97) {
+    g_copies_left = k;
+    EXPECT_THROW(tree_type failed(tree), std::runtime_error);
+  }
+  g_copies_left = -1;
+  copy.clear();
+  EXPECT_TRUE(copy._m_verify());
+}
+
+int g_conversions = 0;
+
+struct account_key {
+  int id;
+  std::string owner;
+  account_key(int i) : id(i), owner("owner") { ++g_conversions; }
+};
+
+struct by_id {
+  typedef void is_transparent;
+
+  bool operator()(const account_key &x, const account_key &y) const { return x.id < y.id; }
+  bool operator()(const account_key &x, int y) const { return x.id < y; }
+  bool operator()(int x, const account_key &y) const { return x < y.id; }
+};
+
+TEST(RbTreeTransparentTest, heterogeneousLookupTest) {
+  typedef ft::pair<account_key, int> value_type;
+  typedef ft::_rb_tree<account_key, value_type, ft::Select1st<value_type>, by_id> tree_type;
+  tree_type tree;
+  for (int i = 0; i < 100; i++)
+    tree.insert_unique(value_type(account_key(i * 2), i));
+
+  g_conversions = 0;
+  EXPECT_EQ(tree.find(40)->second, 20);
+  EXPECT_TRUE(tree.find(41) == tree.end());
+  EXPECT_EQ(tree.count(40), 1u);
+  EXPECT_EQ(tree.count(41), 0u);
+  EXPECT_EQ(tree.lower_bound(41)->first.id, 42);
+  EXPECT_EQ(tree.upper_bound(42)->first.id, 44);
+  EXPECT_TRUE(tree.equal_range(7).first == tree.equal_range(7).second);
+  EXPECT_TRUE(tree.upper_bound(1000) == tree.end());
+  const tree_type &ctree = tree;
+  EXPECT_EQ(ctree.find(198)->second, 99);
+  EXPECT_EQ(g_conversions, 0); // no account_key was built from an int
+
+  // without is_transparent the int is converted to key_type first
+  typedef ft::_rb_tree<int, ft::pair<int, int>, ft::Select1st<ft::pair<int, int> >, ft::less<> > plain_tree;
+  EXPECT_TRUE((ft::is_transparent<ft::less<> >::value));
+  EXPECT_FALSE((ft::is_transparent<ft::less<int> >::value));
+  plain_tree plain;
+  plain.insert_unique(ft::pair<int, int>(1, 1));
+  EXPECT_EQ(plain.find(1L)->second, 1);
+}
+
+TEST(RbTreeCursorTest, fingerSearchTest) {
+  typedef ft::pair<int, int> value_type;
+  typedef ft::_rb_tree<int, value_type> tree_type;
+  typedef ft::_rb_tree_cursor<tree_type, tree_type::iterator> cursor_type;
+  tree_type tree;
+  for (int i = 0; i < 2000; i++)
+    tree.insert_unique(value_type(i * 3, i));
+
+  // sequential, near-sequential, backwards and random streams, including keys outside the tree
+  srand(11);
+  cursor_type c(tree);
+  for (int i = 0; i < 20000; i++) {
+    int k;
+    if (i < 5000)
+      k = i * 2 - 10;
+    else if (i < 10000)
+      k = (i - 5000) * 3 + rand() % 41 - 20;
+    else if (i < 15000)
+      k = (15000 - i) * 2;
+    else
+      k = rand() % 7000 - 500;
+    ASSERT_TRUE(c.lower_bound(k) == tree.lower_bound(k)) << k;
+    ASSERT_TRUE(c.upper_bound(k) == tree.upper_bound(k)) << k;
+    ASSERT_TRUE(c.find(k) == tree.find(k)) << k;
+  }
+
+  // inserts do not invalidate the cursor, an erased position is replaced with seek()
+  c.find(300);
+  tree.insert_unique(value_type(301, 0));
+  EXPECT_EQ(c.upper_bound(300)->first, 301);
+  c.seek(tree.begin());
+  tree.erase(301);
+  EXPECT_EQ(c.find(5997)->second, 1999);
+  EXPECT_TRUE(c.find(6000) == tree.end());
+}